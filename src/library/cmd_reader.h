@@ -2,6 +2,7 @@
 
 #include "impl/base.h"
 #include "impl/cmd_reader_windows.h"
+#include "task_group.h"
 
 namespace xlang::cmd
 {
@@ -109,21 +110,11 @@ namespace xlang::cmd
         auto files(std::string_view const& name, F directory_filter) const
         {
             std::set<std::string> files;
+            std::vector<std::experimental::filesystem::path> directories;
 
             auto add_directory = [&](auto&& path)
             {
-                for (auto&& file : std::experimental::filesystem::directory_iterator(path))
-                {
-                    if (std::experimental::filesystem::is_regular_file(file))
-                    {
-                        auto filename = canonical(file.path()).string();
-
-                        if (directory_filter(filename))
-                        {
-                            files.insert(filename);
-                        }
-                    }
-                }
+                directories.emplace_back(path);
             };
 
             for (auto&& path : values(name))
@@ -200,6 +191,7 @@ namespace xlang::cmd
                 throw_invalid("Path '", path, "' is not a file or directory");
             }
 
+            add_directory_files(files, directories, directory_filter);
             return files;
         }
 
@@ -210,6 +202,63 @@ namespace xlang::cmd
 
     private:
 
+        template <typename F>
+        static void add_directory_files(std::set<std::string>& files, std::vector<std::experimental::filesystem::path> const& directories, F const& directory_filter)
+        {
+            // Directories are scanned concurrently and the candidate files are then filtered on a bounded
+            // number of tasks, since the filter typically opens and maps every file.
+
+            std::vector<std::vector<std::string>> scanned(directories.size());
+            task_group group;
+
+            for (size_t i = 0; i != directories.size(); ++i)
+            {
+                group.add([&, i]
+                {
+                    for (auto&& file : std::experimental::filesystem::directory_iterator(directories[i]))
+                    {
+                        if (std::experimental::filesystem::is_regular_file(file))
+                        {
+                            scanned[i].push_back(canonical(file.path()).string());
+                        }
+                    }
+                });
+            }
+
+            group.get();
+            std::vector<std::string> candidates;
+
+            for (auto&& directory : scanned)
+            {
+                candidates.insert(candidates.end(), std::make_move_iterator(directory.begin()), std::make_move_iterator(directory.end()));
+            }
+
+            std::vector<char> accepted(candidates.size());
+            std::atomic<size_t> next{};
+            size_t const tasks = std::min<size_t>(candidates.size(), std::max(1u, std::thread::hardware_concurrency()));
+
+            for (size_t i = 0; i != tasks; ++i)
+            {
+                group.add([&]
+                {
+                    for (size_t index = next++; index < candidates.size(); index = next++)
+                    {
+                        accepted[index] = directory_filter(candidates[index]);
+                    }
+                });
+            }
+
+            group.get();
+
+            for (size_t i = 0; i != candidates.size(); ++i)
+            {
+                if (accepted[i])
+                {
+                    files.insert(std::move(candidates[i]));
+                }
+            }
+        }
+
         template<typename O>
         auto find(O const& options, std::string_view const& arg)
         {
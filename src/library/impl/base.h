@@ -20,18 +20,26 @@
 #include <stdexcept>
 #include <assert.h>
 #include <array>
+#include <atomic>
 #include <bitset>
+#include <charconv>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
 #include <fstream>
 #include <future>
 #include <list>
 #include <map>
+#include <mutex>
 #include <optional>
 #include <regex>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <variant>
 #include <vector>
 #include <set>
+#include <shared_mutex>
 #include <experimental/filesystem>
 
 #if defined(_DEBUG)
@@ -1,6 +1,52 @@
 
 namespace xlang::meta::reader
 {
+    struct database_probe
+    {
+        // Probes candidate files for metadata and keeps the mapping of every file that passes, so that
+        // the cache can construct its databases without opening, mapping and validating them again.
+        // The probe may be called concurrently.
+
+        database_probe(database_probe const&) = delete;
+        database_probe& operator=(database_probe const&) = delete;
+        database_probe() = default;
+
+        bool operator()(std::string_view const& path)
+        {
+            file_view file{ path };
+            auto const metadata = database::find_metadata<false>(file);
+
+            if (!metadata)
+            {
+                return false;
+            }
+
+            std::lock_guard<std::mutex> guard{ m_lock };
+            m_files.try_emplace(std::string{ path }, std::move(file), metadata);
+            return true;
+        }
+
+        std::optional<std::pair<file_view, uint32_t>> take(std::string_view const& path)
+        {
+            std::optional<std::pair<file_view, uint32_t>> result;
+            std::lock_guard<std::mutex> guard{ m_lock };
+            auto found = m_files.find(path);
+
+            if (found != m_files.end())
+            {
+                result.emplace(std::move(found->second));
+                m_files.erase(found);
+            }
+
+            return result;
+        }
+
+    private:
+
+        std::mutex m_lock;
+        std::map<std::string, std::pair<file_view, uint32_t>, std::less<>> m_files;
+    };
+
     struct cache
     {
         cache() = default;
@@ -8,11 +54,14 @@ namespace xlang::meta::reader
         cache& operator=(cache const&) = delete;
 
         template<typename C, typename T = typename C::value_type>
-        explicit cache(C const& files)
+        explicit cache(C const& files, database_probe* probe = nullptr)
         {
             for (auto&& file : files)
             {
-                auto& db = m_databases.emplace_back(file, this);
+                auto probed = probe ? probe->take(file) : std::nullopt;
+                auto& db = probed ?
+                    m_databases.emplace_back(file, std::move(probed->first), probed->second, this) :
+                    m_databases.emplace_back(file, this);
 
                 for (auto&& type : db.TypeDef)
                 {
@@ -179,6 +228,30 @@ namespace xlang::meta::reader
             remove("Windows.Foundation.Numerics", "Vector4");
         }
 
+        template <typename F>
+        void retain_projected_types(F const& predicate)
+        {
+            // Removes the types for which the predicate returns false from the projected categories.
+            // The types may still be found by name, as attributes and signatures may refer to them.
+
+            auto retain = [&](auto&& collection)
+            {
+                collection.erase(std::remove_if(collection.begin(), collection.end(), [&](auto&& type)
+                {
+                    return !predicate(type);
+                }), collection.end());
+            };
+
+            for (auto&&[namespace_name, members] : m_namespaces)
+            {
+                retain(members.interfaces);
+                retain(members.classes);
+                retain(members.enums);
+                retain(members.structs);
+                retain(members.delegates);
+            }
+        }
+
         struct namespace_members
         {
             std::map<std::string_view, TypeDef> types;
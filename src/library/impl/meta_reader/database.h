@@ -33,118 +33,19 @@ namespace xlang::meta::reader
         static bool is_database(std::string_view const& path)
         {
             file_view file{ path };
-
-            if (file.size() < sizeof(impl::image_dos_header))
-            {
-                return false;
-            }
-
-            auto dos = file.as<impl::image_dos_header>();
-
-            if (dos.e_magic != 0x5A4D) // IMAGE_DOS_SIGNATURE
-            {
-                return false;
-            }
-
-            if (file.size() < (dos.e_lfanew + sizeof(impl::image_nt_headers32)))
-            {
-                return false;
-            }
-
-            auto pe = file.as<impl::image_nt_headers32>(dos.e_lfanew);
-
-            if (pe.FileHeader.NumberOfSections == 0 || pe.FileHeader.NumberOfSections > 100)
-            {
-                return false;
-            }
-
-            auto com = pe.OptionalHeader.DataDirectory[14]; // IMAGE_DIRECTORY_ENTRY_COM_DESCRIPTOR
-            auto sections = &file.as<impl::image_section_header>(dos.e_lfanew + sizeof(impl::image_nt_headers32));
-            auto sections_end = sections + pe.FileHeader.NumberOfSections;
-
-            auto section = section_from_rva(sections, sections_end, com.VirtualAddress);
-
-            if (section == sections_end)
-            {
-                return false;
-            }
-
-            auto offset = offset_from_rva(*section, com.VirtualAddress);
-
-            auto cli = file.as<impl::image_cor20_header>(offset);
-
-            if (cli.cb != sizeof(impl::image_cor20_header))
-            {
-                return false;
-            }
-
-            section = section_from_rva(sections, sections_end, cli.MetaData.VirtualAddress);
-
-            if (section == sections_end)
-            {
-                return false;
-            }
-
-            offset = offset_from_rva(*section, cli.MetaData.VirtualAddress);
-
-            if (file.as<uint32_t>(offset) != 0x424a5342)
-            {
-                return false;
-            }
-
-            return true;
+            return find_metadata<false>(file) != 0;
         }
 
-        explicit database(std::string_view const& path, cache const* cache = nullptr) : file_view{ path }, m_path{ path }, m_cache{ cache }
+        explicit database(std::string_view const& path, cache const* cache = nullptr) : database{ path, file_view{ path }, 0, cache }
         {
-            auto dos = as<impl::image_dos_header>();
-
-            if (dos.e_magic != 0x5A4D) // IMAGE_DOS_SIGNATURE
-            {
-                throw_invalid("Invalid DOS signature");
-            }
-
-            auto pe = as<impl::image_nt_headers32>(dos.e_lfanew);
-
-            if (pe.FileHeader.NumberOfSections == 0 || pe.FileHeader.NumberOfSections > 100)
-            {
-                throw_invalid("Invalid PE section count");
-            }
-
-            auto com = pe.OptionalHeader.DataDirectory[14]; // IMAGE_DIRECTORY_ENTRY_COM_DESCRIPTOR
-            auto sections = &as<impl::image_section_header>(dos.e_lfanew + sizeof(impl::image_nt_headers32));
-            auto sections_end = sections + pe.FileHeader.NumberOfSections;
-
-            auto section = section_from_rva(sections, sections_end, com.VirtualAddress);
-
-            if (section == sections_end)
-            {
-                throw_invalid("PE section containing CLI header not found");
-            }
-
-            auto offset = offset_from_rva(*section, com.VirtualAddress);
-
-            auto cli = as<impl::image_cor20_header>(offset);
-
-            if (cli.cb != sizeof(impl::image_cor20_header))
-            {
-                throw_invalid("Invalid CLI header");
-            }
-
-            section = section_from_rva(sections, sections_end, cli.MetaData.VirtualAddress);
-
-            if (section == sections_end)
-            {
-                throw_invalid("PE section containing CLI metadata not found");
-            }
-
-            offset = offset_from_rva(*section, cli.MetaData.VirtualAddress);
+        }
 
-            if (as<uint32_t>(offset) != 0x424a5342)
-            {
-                throw_invalid("CLI metadata magic signature not found");
-            }
+        database(std::string_view const& path, file_view&& file, uint32_t metadata, cache const* cache = nullptr) : file_view{ std::move(file) }, m_path{ path }, m_cache{ cache }
+        {
+            // A non-zero metadata offset comes from a previous find_metadata call on the same file, in which
+            // case the PE headers have already been validated.
 
+            auto const offset = metadata ? metadata : find_metadata<true>(*this);
             auto version_length = as<uint32_t>(offset + 12);
             auto stream_count = as<uint16_t>(offset + version_length + 18);
             auto view = seek(offset + version_length + 20);
@@ -442,6 +343,80 @@ namespace xlang::meta::reader
             return { view.sub(blob_size_bytes, blob_size) };
         }
 
+        template <bool Throw>
+        static uint32_t find_metadata(byte_view const& file)
+        {
+            auto invalid = [](char const* message) -> uint32_t
+            {
+                if constexpr (Throw)
+                {
+                    throw_invalid(message);
+                }
+
+                return 0;
+            };
+
+            if (file.size() < sizeof(impl::image_dos_header))
+            {
+                return invalid("Invalid DOS signature");
+            }
+
+            auto dos = file.as<impl::image_dos_header>();
+
+            if (dos.e_magic != 0x5A4D) // IMAGE_DOS_SIGNATURE
+            {
+                return invalid("Invalid DOS signature");
+            }
+
+            if (file.size() < (dos.e_lfanew + sizeof(impl::image_nt_headers32)))
+            {
+                return invalid("Invalid PE header");
+            }
+
+            auto pe = file.as<impl::image_nt_headers32>(dos.e_lfanew);
+
+            if (pe.FileHeader.NumberOfSections == 0 || pe.FileHeader.NumberOfSections > 100)
+            {
+                return invalid("Invalid PE section count");
+            }
+
+            auto com = pe.OptionalHeader.DataDirectory[14]; // IMAGE_DIRECTORY_ENTRY_COM_DESCRIPTOR
+            auto sections = &file.as<impl::image_section_header>(dos.e_lfanew + sizeof(impl::image_nt_headers32));
+            auto sections_end = sections + pe.FileHeader.NumberOfSections;
+
+            auto section = section_from_rva(sections, sections_end, com.VirtualAddress);
+
+            if (section == sections_end)
+            {
+                return invalid("PE section containing CLI header not found");
+            }
+
+            auto offset = offset_from_rva(*section, com.VirtualAddress);
+
+            auto cli = file.as<impl::image_cor20_header>(offset);
+
+            if (cli.cb != sizeof(impl::image_cor20_header))
+            {
+                return invalid("Invalid CLI header");
+            }
+
+            section = section_from_rva(sections, sections_end, cli.MetaData.VirtualAddress);
+
+            if (section == sections_end)
+            {
+                return invalid("PE section containing CLI metadata not found");
+            }
+
+            offset = offset_from_rva(*section, cli.MetaData.VirtualAddress);
+
+            if (file.as<uint32_t>(offset) != 0x424a5342)
+            {
+                return invalid("CLI metadata magic signature not found");
+            }
+
+            return offset;
+        }
+
     private:
 
         struct stream_range
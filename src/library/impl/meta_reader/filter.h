@@ -8,20 +8,26 @@ namespace xlang::meta::reader
         template <typename T>
         filter(T const& includes, T const& excludes)
         {
-            for (auto&& include : includes)
+            // The rules are compiled into a trie keyed on the characters of the full type name so that a
+            // lookup costs the length of the name rather than the number of rules. Since the longest
+            // matching prefix wins, the last rule found along the path decides.
+
+            if (std::empty(includes) && std::empty(excludes))
             {
-                m_rules.push_back({ include, true });
+                return;
             }
 
-            for (auto&& exclude : excludes)
+            m_nodes.emplace_back();
+
+            for (auto&& include : includes)
             {
-                m_rules.push_back({ exclude, false });
+                insert(include, true);
             }
 
-            std::sort(m_rules.begin(), m_rules.end(), [](auto const& lhs, auto const& rhs)
+            for (auto&& exclude : excludes)
             {
-                return lhs.first.size() > rhs.first.size();
-            });
+                insert(exclude, false);
+            }
         }
 
         bool includes(TypeDef const& type) const
@@ -31,7 +37,7 @@ namespace xlang::meta::reader
 
         bool includes(std::vector<TypeDef> const& types) const
         {
-            if (m_rules.empty())
+            if (m_nodes.empty())
             {
                 return true;
             }
@@ -49,11 +55,24 @@ namespace xlang::meta::reader
 
         bool includes(cache::namespace_members const& members) const
         {
-            if (m_rules.empty())
+            if (m_nodes.empty())
             {
                 return true;
             }
 
+            if (members.types.empty())
+            {
+                return false;
+            }
+
+            // Most rules name whole namespaces, in which case every type in the namespace shares the
+            // same result and the types need not be visited individually.
+
+            if (auto result = includes_namespace(members.types.begin()->second.TypeNamespace()))
+            {
+                return *result;
+            }
+
             for (auto&& type : members.types)
             {
                 if (includes(type.second.TypeNamespace(), type.second.TypeName()))
@@ -65,6 +84,24 @@ namespace xlang::meta::reader
             return false;
         }
 
+        bool includes(std::string_view const& type_namespace, std::string_view const& type_name) const noexcept
+        {
+            if (m_nodes.empty())
+            {
+                return true;
+            }
+
+            uint32_t index{};
+            std::optional<bool> result = m_nodes.front().rule;
+
+            if (walk(index, result, type_namespace) && walk(index, result, "."sv))
+            {
+                walk(index, result, type_name);
+            }
+
+            return result.value_or(false);
+        }
+
         template <auto F>
         auto bind_each(std::vector<TypeDef> const& types) const
         {
@@ -82,49 +119,92 @@ namespace xlang::meta::reader
 
         bool empty() const noexcept
         {
-            return m_rules.empty();
+            return m_nodes.empty();
         }
 
     private:
 
-        bool includes(std::string_view const& type_namespace, std::string_view const& type_name) const noexcept
+        struct node
         {
-            if (m_rules.empty())
-            {
-                return true;
-            }
+            std::vector<std::pair<char, uint32_t>> children;
+            std::optional<bool> rule;
+        };
+
+        void insert(std::string_view const& prefix, bool const include)
+        {
+            uint32_t index{};
 
-            for (auto&& rule : m_rules)
+            for (auto c : prefix)
             {
-                if (match(type_namespace, type_name, rule.first))
+                auto& children = m_nodes[index].children;
+
+                auto child = std::lower_bound(children.begin(), children.end(), c, [](auto&& child, char c)
+                {
+                    return child.first < c;
+                });
+
+                if (child != children.end() && child->first == c)
                 {
-                    return rule.second;
+                    index = child->second;
+                    continue;
                 }
+
+                auto const next = static_cast<uint32_t>(m_nodes.size());
+                children.insert(child, { c, next });
+                m_nodes.emplace_back();
+                index = next;
             }
 
-            return false;
-        }
+            // If the same prefix is both included and excluded, the exclusion wins.
 
-        static bool match(std::string_view const& type_namespace, std::string_view const& type_name, std::string_view const& match) noexcept
-        {
-            if (match.size() <= type_namespace.size())
+            auto& rule = m_nodes[index].rule;
+
+            if (!rule || !include)
             {
-                return starts_with(type_namespace, match);
+                rule = include;
             }
+        }
 
-            if (!starts_with(match, type_namespace))
+        bool walk(uint32_t& index, std::optional<bool>& result, std::string_view const& value) const noexcept
+        {
+            for (auto c : value)
             {
-                return false;
+                auto const& children = m_nodes[index].children;
+
+                auto child = std::find_if(children.begin(), children.end(), [c](auto&& child)
+                {
+                    return child.first == c;
+                });
+
+                if (child == children.end())
+                {
+                    return false;
+                }
+
+                index = child->second;
+
+                if (m_nodes[index].rule)
+                {
+                    result = m_nodes[index].rule;
+                }
             }
 
-            if (match[type_namespace.size()] != '.')
+            return true;
+        }
+
+        std::optional<bool> includes_namespace(std::string_view const& type_namespace) const noexcept
+        {
+            uint32_t index{};
+            std::optional<bool> result = m_nodes.front().rule;
+
+            if (walk(index, result, type_namespace) && walk(index, result, "."sv) && !m_nodes[index].children.empty())
             {
-                return false;
+                return {};
             }
 
-            return starts_with(type_name, match.substr(type_namespace.size() + 1));
+            return result.value_or(false);
         }
 
-        std::vector<std::pair<std::string, bool>> m_rules;
+        std::vector<node> m_nodes;
     };
 }
@@ -4,6 +4,489 @@
 
 namespace xlang::text
 {
+    inline uint64_t hash_content(uint64_t hash, std::vector<char> const& content) noexcept
+    {
+        // FNV-1a
+        for (auto&& c : content)
+        {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 0x100000001b3ull;
+        }
+
+        return hash;
+    }
+
+    inline uint64_t hash_content(std::vector<char> const& first, std::vector<char> const& second) noexcept
+    {
+        return hash_content(hash_content(0xcbf29ce484222325ull, first), second);
+    }
+
+    inline void write_file(std::string const& filename, std::vector<char> const& first, std::vector<char> const& second)
+    {
+        // The content is written to a uniquely named temporary file that is then renamed over the target,
+        // so that concurrent builds never observe a partially written file.
+
+        static std::atomic<uint32_t> counter{};
+#if XLANG_PLATFORM_WINDOWS
+        auto const process = static_cast<uint32_t>(GetCurrentProcessId());
+#else
+        auto const process = static_cast<uint32_t>(getpid());
+#endif
+        auto temp = filename + ".tmp" + std::to_string(process) + "." + std::to_string(++counter);
+
+        {
+            std::ofstream file{ temp, std::ios::out | std::ios::binary };
+            file.write(first.data(), first.size());
+            file.write(second.data(), second.size());
+            file.close();
+
+            if (!file)
+            {
+                std::remove(temp.c_str());
+                throw_invalid("Could not write file '", filename, "'");
+            }
+        }
+
+#if XLANG_PLATFORM_WINDOWS
+        bool const renamed = MoveFileExA(temp.c_str(), filename.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+        bool const renamed = ::rename(temp.c_str(), filename.c_str()) == 0;
+#endif
+
+        if (!renamed)
+        {
+            std::remove(temp.c_str());
+            throw_invalid("Could not write file '", filename, "'");
+        }
+    }
+
+    struct output_manifest
+    {
+        output_manifest(output_manifest const&) = delete;
+        output_manifest& operator=(output_manifest const&) = delete;
+
+        explicit output_manifest(std::string filename) : m_filename(std::move(filename))
+        {
+            // Each line holds "<hash> <size> <time> <filename>". Malformed lines are ignored, which
+            // simply means the corresponding output is compared against the file on disk again.
+
+            std::ifstream file{ m_filename };
+            std::string line;
+
+            while (std::getline(file, line))
+            {
+                char* cursor = line.data();
+                entry value;
+                value.hash = std::strtoull(cursor, &cursor, 16);
+                value.size = std::strtoull(cursor, &cursor, 10);
+                value.time = std::strtoll(cursor, &cursor, 10);
+
+                if (*cursor != ' ' || !*(cursor + 1))
+                {
+                    continue;
+                }
+
+                m_entries[cursor + 1] = value;
+            }
+        }
+
+        bool is_current(std::string const& filename, uint64_t const hash, uint64_t const size) const
+        {
+            entry recorded;
+
+            {
+                std::lock_guard<std::mutex> guard{ m_lock };
+                auto found = m_entries.find(filename);
+
+                if (found == m_entries.end())
+                {
+                    return false;
+                }
+
+                recorded = found->second;
+            }
+
+            if (recorded.hash != hash || recorded.size != size)
+            {
+                return false;
+            }
+
+            // The file on disk must still be the one that was recorded, which only needs a stat.
+
+            entry current;
+
+            if (!get_file_info(filename, current))
+            {
+                return false;
+            }
+
+            return current.size == size && current.time == recorded.time;
+        }
+
+        void update(std::string const& filename, uint64_t const hash, uint64_t const size)
+        {
+            entry value;
+
+            if (!get_file_info(filename, value) || value.size != size)
+            {
+                return;
+            }
+
+            value.hash = hash;
+            std::lock_guard<std::mutex> guard{ m_lock };
+            m_entries[filename] = value;
+            m_dirty = true;
+        }
+
+        void save() const
+        {
+            std::vector<char> content;
+
+            {
+                std::lock_guard<std::mutex> guard{ m_lock };
+
+                if (!m_dirty)
+                {
+                    return;
+                }
+
+                char buffer[64];
+
+                for (auto&&[filename, value] : m_entries)
+                {
+                    int const size = snprintf(buffer, sizeof(buffer), "%016llx %llu %lld ",
+                        static_cast<unsigned long long>(value.hash),
+                        static_cast<unsigned long long>(value.size),
+                        static_cast<long long>(value.time));
+
+                    content.insert(content.end(), buffer, buffer + size);
+                    content.insert(content.end(), filename.begin(), filename.end());
+                    content.push_back('\n');
+                }
+            }
+
+            write_file(m_filename, content, {});
+        }
+
+    private:
+
+        struct entry
+        {
+            uint64_t hash{};
+            uint64_t size{};
+            int64_t time{};
+        };
+
+        static bool get_file_info(std::string const& filename, entry& value)
+        {
+            std::error_code error;
+            auto const size = std::experimental::filesystem::file_size(filename, error);
+
+            if (error)
+            {
+                return false;
+            }
+
+            auto const time = std::experimental::filesystem::last_write_time(filename, error);
+
+            if (error)
+            {
+                return false;
+            }
+
+            value.size = size;
+            value.time = static_cast<int64_t>(time.time_since_epoch().count());
+            return true;
+        }
+
+        std::string const m_filename;
+        mutable std::mutex m_lock;
+        std::map<std::string, entry> m_entries;
+        bool m_dirty{};
+    };
+
+    inline bool file_equal(std::string const& filename, std::vector<char> const& first, std::vector<char> const& second)
+    {
+        if (!std::experimental::filesystem::exists(filename))
+        {
+            return false;
+        }
+
+        meta::reader::file_view file{ filename };
+
+        if (file.size() != first.size() + second.size())
+        {
+            return false;
+        }
+
+        if (!std::equal(first.begin(), first.end(), file.begin(), file.begin() + first.size()))
+        {
+            return false;
+        }
+
+        return std::equal(second.begin(), second.end(), file.begin() + first.size(), file.end());
+    }
+
+    inline bool write_file_if_changed(std::string const& filename, std::vector<char> const& first, std::vector<char> const& second, output_manifest* manifest = nullptr)
+    {
+        if (!manifest)
+        {
+            if (file_equal(filename, first, second))
+            {
+                return false;
+            }
+
+            write_file(filename, first, second);
+            return true;
+        }
+
+        auto const hash = hash_content(first, second);
+        auto const size = first.size() + second.size();
+
+        if (manifest->is_current(filename, hash, size))
+        {
+            return false;
+        }
+
+        bool const changed = !file_equal(filename, first, second);
+
+        if (changed)
+        {
+            write_file(filename, first, second);
+        }
+
+        manifest->update(filename, hash, size);
+        return changed;
+    }
+
+    struct output_stage
+    {
+        // Generator tasks hand finished buffers to the output stage, which writes them on a dedicated
+        // thread so that disk I/O overlaps with code generation. The amount of buffered output is bounded
+        // and producers block until the writer thread catches up. A synchronous stage performs the I/O on
+        // the calling thread instead, which is useful for comparing the statistics of both modes.
+
+        struct statistics
+        {
+            uint64_t files{};
+            uint64_t written{};
+            uint64_t directories{};
+            uint64_t batches{};
+            uint64_t bytes{};
+            int64_t io_time{};
+            int64_t wait_time{};
+        };
+
+        output_stage(output_stage const&) = delete;
+        output_stage& operator=(output_stage const&) = delete;
+
+        explicit output_stage(bool const asynchronous = true, output_manifest* manifest = nullptr, size_t const max_pending = 64 * 1024 * 1024) :
+            m_manifest(manifest),
+            m_max_pending(max_pending)
+        {
+            if (asynchronous)
+            {
+                m_thread = std::thread([this] { run(); });
+            }
+        }
+
+        ~output_stage() noexcept
+        {
+            if (m_thread.joinable())
+            {
+                {
+                    std::lock_guard<std::mutex> guard{ m_lock };
+                    m_closed = true;
+                }
+
+                m_ready.notify_one();
+                m_thread.join();
+            }
+        }
+
+        void write(std::string const& filename, std::vector<char>&& first, std::vector<char>&& second)
+        {
+            std::vector<item> batch;
+            batch.push_back({ filename, std::move(first), std::move(second) });
+
+            if (!m_thread.joinable())
+            {
+                process(batch);
+                return;
+            }
+
+            auto const size = batch.front().size();
+            auto const start = std::chrono::high_resolution_clock::now();
+            std::unique_lock<std::mutex> lock{ m_lock };
+
+            m_space.wait(lock, [&]
+            {
+                return m_pending == 0 || m_pending + size <= m_max_pending;
+            });
+
+            m_statistics.wait_time += elapsed(start);
+            m_pending += size;
+            m_queue.push_back(std::move(batch.front()));
+            lock.unlock();
+            m_ready.notify_one();
+        }
+
+        void flush()
+        {
+            std::unique_lock<std::mutex> lock{ m_lock };
+
+            m_idle.wait(lock, [&]
+            {
+                return m_queue.empty() && !m_busy;
+            });
+
+            if (m_error)
+            {
+                std::rethrow_exception(std::exchange(m_error, {}));
+            }
+        }
+
+        statistics get_statistics() const
+        {
+            std::lock_guard<std::mutex> guard{ m_lock };
+            return m_statistics;
+        }
+
+    private:
+
+        struct item
+        {
+            std::string filename;
+            std::vector<char> first;
+            std::vector<char> second;
+
+            size_t size() const noexcept
+            {
+                return first.size() + second.size();
+            }
+        };
+
+        static int64_t elapsed(std::chrono::high_resolution_clock::time_point const& start) noexcept
+        {
+            return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - start).count();
+        }
+
+        void run() noexcept
+        {
+            std::vector<item> batch;
+
+            while (true)
+            {
+                {
+                    std::unique_lock<std::mutex> lock{ m_lock };
+
+                    m_ready.wait(lock, [&]
+                    {
+                        return !m_queue.empty() || m_closed;
+                    });
+
+                    if (m_queue.empty())
+                    {
+                        return;
+                    }
+
+                    batch.swap(m_queue);
+                    m_busy = true;
+                }
+
+                size_t size{};
+
+                for (auto&& item : batch)
+                {
+                    size += item.size();
+                }
+
+                try
+                {
+                    process(batch);
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> guard{ m_lock };
+
+                    if (!m_error)
+                    {
+                        m_error = std::current_exception();
+                    }
+                }
+
+                batch.clear();
+
+                {
+                    std::lock_guard<std::mutex> guard{ m_lock };
+                    m_pending -= size;
+                    m_busy = false;
+                }
+
+                m_space.notify_all();
+                m_idle.notify_all();
+            }
+        }
+
+        void process(std::vector<item> const& batch)
+        {
+            auto const start = std::chrono::high_resolution_clock::now();
+            statistics result;
+            result.batches = 1;
+
+            for (auto&& item : batch)
+            {
+                // Each folder is only created once, which avoids repeatedly probing the file system.
+
+                auto folder = std::experimental::filesystem::path{ item.filename }.parent_path().string();
+                std::lock_guard<std::mutex> guard{ m_folder_lock };
+
+                if (!folder.empty() && !m_folders.count(folder))
+                {
+                    std::experimental::filesystem::create_directories(folder);
+                    m_folders.insert(folder);
+                    ++result.directories;
+                }
+            }
+
+            for (auto&& item : batch)
+            {
+                ++result.files;
+                result.bytes += item.size();
+
+                if (write_file_if_changed(item.filename, item.first, item.second, m_manifest))
+                {
+                    ++result.written;
+                }
+            }
+
+            result.io_time = elapsed(start);
+            std::lock_guard<std::mutex> guard{ m_lock };
+            m_statistics.files += result.files;
+            m_statistics.written += result.written;
+            m_statistics.directories += result.directories;
+            m_statistics.batches += result.batches;
+            m_statistics.bytes += result.bytes;
+            m_statistics.io_time += result.io_time;
+        }
+
+        output_manifest* const m_manifest;
+        size_t const m_max_pending;
+        mutable std::mutex m_lock;
+        std::condition_variable m_ready;
+        std::condition_variable m_space;
+        std::condition_variable m_idle;
+        std::vector<item> m_queue;
+        size_t m_pending{};
+        bool m_busy{};
+        bool m_closed{};
+        std::exception_ptr m_error;
+        statistics m_statistics;
+        std::mutex m_folder_lock;
+        std::set<std::string> m_folders;
+        std::thread m_thread;
+    };
+
     template <typename T>
     struct writer_base
     {
@@ -26,6 +509,29 @@ namespace xlang::text
             write_segment(value, args...);
         }
 
+        struct indent_guard
+        {
+            indent_guard(indent_guard const&) = delete;
+            indent_guard& operator=(indent_guard const&) = delete;
+
+            explicit indent_guard(writer_base& writer, uint32_t const levels = 1) noexcept :
+                m_writer(writer),
+                m_levels(levels)
+            {
+                m_writer.m_indent += m_levels;
+            }
+
+            ~indent_guard() noexcept
+            {
+                m_writer.m_indent -= m_levels;
+            }
+
+        private:
+
+            writer_base& m_writer;
+            uint32_t const m_levels;
+        };
+
         template <typename... Args>
         std::string write_temp(std::string_view const& value, Args const&... args)
         {
@@ -33,6 +539,7 @@ namespace xlang::text
             bool restore_debug_trace = debug_trace;
             debug_trace = false;
 #endif
+            auto const restore_indent = std::exchange(m_indent, 0);
             auto const size = m_first.size();
 
             XLANG_ASSERT(count_placeholders(value) == sizeof...(Args));
@@ -40,6 +547,7 @@ namespace xlang::text
 
             std::string result{ m_first.data() + size, m_first.size() - size };
             m_first.resize(size);
+            m_indent = restore_indent;
 
 #if defined(XLANG_DEBUG)
             debug_trace = restore_debug_trace;
@@ -49,7 +557,14 @@ namespace xlang::text
 
         void write_impl(std::string_view const& value)
         {
-            m_first.insert(m_first.end(), value.begin(), value.end());
+            if (m_indent)
+            {
+                write_indented(value);
+            }
+            else
+            {
+                m_first.insert(m_first.end(), value.begin(), value.end());
+            }
 
 #if defined(XLANG_DEBUG)
             if (debug_trace)
@@ -61,6 +576,11 @@ namespace xlang::text
 
         void write_impl(char const value)
         {
+            if (m_indent && back() == '\n')
+            {
+                append_indent();
+            }
+
             m_first.push_back(value);
 
 #if defined(XLANG_DEBUG)
@@ -86,6 +606,16 @@ namespace xlang::text
             write(value);
         }
 
+        void write_indent(uint32_t levels)
+        {
+            for (; levels > indent_spaces.size() / 4; levels -= indent_spaces.size() / 4)
+            {
+                write(indent_spaces);
+            }
+
+            write(indent_spaces.substr(0, levels * 4));
+        }
+
         template <typename F, typename = std::enable_if_t<std::is_invocable_v<F, T&>>>
         void write(F const& f)
         {
@@ -94,17 +624,84 @@ namespace xlang::text
 
         void write(int32_t const value)
         {
-            write(std::to_string(value));
+            write_decimal(value);
         }
 
         void write(int64_t const value)
         {
-            write(std::to_string(value));
+            write_decimal(value);
         }
 
         void write(uint64_t const value)
         {
-            write(std::to_string(value));
+            write_decimal(value);
+        }
+
+        template <typename Int>
+        void write_decimal(Int const value)
+        {
+            static_assert(std::is_integral_v<Int>);
+            char buffer[24];
+            auto const last = std::to_chars(std::begin(buffer), std::end(buffer), value).ptr;
+            write(std::string_view{ buffer, static_cast<size_t>(last - buffer) });
+        }
+
+        template <typename Int>
+        void write_hex(Int const value, uint32_t const width = 0, bool const uppercase = false)
+        {
+            static_assert(std::is_unsigned_v<Int>);
+            char buffer[16];
+            XLANG_ASSERT(width <= std::size(buffer));
+            auto const digits = uppercase ? "0123456789ABCDEF" : "0123456789abcdef";
+            auto const last = std::end(buffer);
+            auto first = last;
+            auto remaining = static_cast<uint64_t>(value);
+
+            do
+            {
+                *--first = digits[remaining & 0xf];
+                remaining >>= 4;
+            } while (remaining);
+
+            while (static_cast<uint32_t>(last - first) < width)
+            {
+                *--first = '0';
+            }
+
+            write(std::string_view{ first, static_cast<size_t>(last - first) });
+        }
+
+        template <typename Int>
+        void write_hex_literal(Int const value)
+        {
+            // Matches the printf "%#x" format, which omits the prefix for zero.
+
+            if (value)
+            {
+                write("0x");
+            }
+
+            write_hex(value);
+        }
+
+        void write_guid(uint32_t const data1, uint16_t const data2, uint16_t const data3, std::array<uint8_t, 8> const& data4, bool const uppercase = false)
+        {
+            write_hex(data1, 8, uppercase);
+            write('-');
+            write_hex(data2, 4, uppercase);
+            write('-');
+            write_hex(data3, 4, uppercase);
+            write('-');
+
+            for (size_t i{}; i != data4.size(); ++i)
+            {
+                if (i == 2)
+                {
+                    write('-');
+                }
+
+                write_hex(data4[i], 2, uppercase);
+            }
         }
 
         template <typename... Args>
@@ -143,16 +740,26 @@ namespace xlang::text
 
         void flush_to_file(std::string const& filename)
         {
-            if (!file_equal(filename))
-            {
-                std::ofstream file{ filename, std::ios::out | std::ios::binary };
-                file.write(m_first.data(), m_first.size());
-                file.write(m_second.data(), m_second.size());
-            }
+            write_file_if_changed(filename, m_first, m_second);
+            m_first.clear();
+            m_second.clear();
+        }
+
+        void flush_to_file(std::string const& filename, output_manifest& manifest)
+        {
+            write_file_if_changed(filename, m_first, m_second, &manifest);
             m_first.clear();
             m_second.clear();
         }
 
+        void flush_to_file(std::string const& filename, output_stage& stage)
+        {
+            stage.write(filename, std::move(m_first), std::move(m_second));
+            m_first.clear();
+            m_second.clear();
+            m_first.reserve(16 * 1024);
+        }
+
         void flush_to_file(std::experimental::filesystem::path const& filename)
         {
             flush_to_file(filename.string());
@@ -176,31 +783,61 @@ namespace xlang::text
 
         bool file_equal(std::string const& filename) const
         {
-            if (!std::experimental::filesystem::exists(filename))
+            return text::file_equal(filename, m_first, m_second);
+        }
+
+#if defined(XLANG_DEBUG)
+        bool debug_trace{};
+#endif
+
+    private:
+
+        static constexpr std::string_view indent_spaces{ "                                                                " };
+
+        void append_indent()
+        {
+            for (uint32_t levels = m_indent; levels; )
             {
-                return false;
+                auto const count = std::min<uint32_t>(levels, indent_spaces.size() / 4);
+                m_first.insert(m_first.end(), indent_spaces.begin(), indent_spaces.begin() + count * 4);
+                levels -= count;
             }
+        }
 
-            meta::reader::file_view file{ filename };
+        void write_indented(std::string_view const& value)
+        {
+            // Indentation is deferred until the next write following a newline, so a fragment ending
+            // with a newline does not indent a line that may never be written.
 
-            if (file.size() != m_first.size() + m_second.size())
+            if (back() == '\n')
             {
-                return false;
+                append_indent();
             }
 
-            if (!std::equal(m_first.begin(), m_first.end(), file.begin(), file.begin() + m_first.size()))
+            auto first = value.data();
+            auto const last = first + value.size();
+
+            while (first != last)
             {
-                return false;
-            }
+                auto newline = static_cast<char const*>(memchr(first, '\n', last - first));
 
-            return std::equal(m_second.begin(), m_second.end(), file.begin() + m_first.size(), file.end());
-        }
+                if (!newline)
+                {
+                    break;
+                }
 
-#if defined(XLANG_DEBUG)
-        bool debug_trace{};
-#endif
+                ++newline;
+                m_first.insert(m_first.end(), first, newline);
+                first = newline;
 
-    private:
+                if (first != last)
+                {
+                    append_indent();
+                }
+            }
+
+            m_first.insert(m_first.end(), first, last);
+        }
 
         static constexpr uint32_t count_placeholders(std::string_view const& format) noexcept
         {
@@ -283,6 +920,7 @@ namespace xlang::text
 
         std::vector<char> m_second;
         std::vector<char> m_first;
+        uint32_t m_indent{};
     };
 
     template <auto F, typename... Args>
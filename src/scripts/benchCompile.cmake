@@ -0,0 +1,215 @@
+# Script variables:
+#   cppxlang     - path to the cppxlang executable
+#   compiler     - path to the C++ compiler used to build consumers
+#   flags        - compiler flags for consumer translation units
+#   input        - one or more cppxlang -input values (metadata files or folders)
+#   args         - additional cppxlang options (e.g. "-guids"), so that runs with and without them can be compared
+#   sizes        - namespace counts for the sized projections (e.g. "1;10;100")
+#   folder       - working folder for generated projections and consumers
+#   out_json     - path to the JSON report
+
+if(${CMAKE_VERSION} VERSION_LESS "3.23")
+    message(FATAL_ERROR "benchCompile.cmake requires CMake 3.23 or later for sub-second timestamps")
+endif()
+
+if(NOT input)
+    message(FATAL_ERROR "No input metadata; set XLANG_BENCH_INPUT or XLANG_TEST_METADATA")
+endif()
+
+get_filename_component(compiler_name ${compiler} NAME_WE)
+if(compiler_name MATCHES "^(cl|clang-cl)$")
+    set(msvc_style TRUE)
+endif()
+if(compiler_name MATCHES "clang" AND NOT compiler_name STREQUAL "clang-cl")
+    set(time_trace TRUE)
+endif()
+
+separate_arguments(flags)
+
+function(NOW_US out_var)
+    string(TIMESTAMP result "%s%f" UTC)
+    set(${out_var} ${result} PARENT_SCOPE)
+endfunction()
+
+function(RUN_CPPXLANG out_folder)
+    file(REMOVE_RECURSE ${out_folder})
+    file(MAKE_DIRECTORY ${out_folder})
+    execute_process(
+        COMMAND ${cppxlang} -input ${input} -out ${out_folder} ${args} ${ARGN}
+        RESULT_VARIABLE result
+        ERROR_VARIABLE error)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "cppxlang failed: ${error}")
+    endif()
+endfunction()
+
+# Returns the namespace headers of a projection, sorted by namespace name.
+function(GET_NAMESPACE_HEADERS out_folder out_var)
+    file(GLOB headers RELATIVE "${out_folder}/winrt" "${out_folder}/winrt/*.h")
+    list(REMOVE_ITEM headers "base.h" "coroutine.h")
+    list(SORT headers)
+    set(${out_var} ${headers} PARENT_SCOPE)
+endfunction()
+
+# Compiles a consumer of the given headers and appends its measurements as a JSON object to out_var.
+function(MEASURE_CONSUMER out_var name out_folder)
+    set(source "${folder}/consumers/${name}.cpp")
+    set(object "${folder}/consumers/${name}.o")
+    set(preprocessed "${folder}/consumers/${name}.i")
+    set(trace "${folder}/consumers/${name}.json")
+
+    set(content "")
+    foreach(header ${ARGN})
+        string(APPEND content "#include <winrt/${header}>\n")
+    endforeach()
+    string(APPEND content "\nint main()\n{\n\n}\n")
+    file(WRITE ${source} "${content}")
+
+    if(msvc_style)
+        set(preprocess_args /nologo /EP /I${out_folder} ${flags} ${source})
+        set(compile_args /nologo /c /I${out_folder} ${flags} /Fo${object} ${source})
+    else()
+        set(preprocess_args -E -P -I${out_folder} ${flags} ${source} -o ${preprocessed})
+        set(compile_args -c -I${out_folder} ${flags} ${source} -o ${object})
+        if(time_trace)
+            list(APPEND compile_args -ftime-trace)
+        endif()
+    endif()
+
+    if(msvc_style)
+        execute_process(COMMAND ${compiler} ${preprocess_args} OUTPUT_FILE ${preprocessed} ERROR_QUIET RESULT_VARIABLE result)
+    else()
+        execute_process(COMMAND ${compiler} ${preprocess_args} ERROR_QUIET RESULT_VARIABLE result)
+    endif()
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "Failed to preprocess ${name}")
+    endif()
+    file(SIZE ${preprocessed} preprocessed_size)
+
+    NOW_US(start)
+    execute_process(COMMAND ${compiler} ${compile_args} OUTPUT_QUIET ERROR_VARIABLE error RESULT_VARIABLE result)
+    NOW_US(finish)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "Failed to compile ${name}: ${error}")
+    endif()
+    math(EXPR total_us "${finish} - ${start}")
+
+    list(LENGTH ARGN header_count)
+    set(json "{ \"name\": \"${name}\", \"headers\": ${header_count}, \"preprocessed_bytes\": ${preprocessed_size}, \"total_us\": ${total_us}")
+
+    # clang writes the trace next to the object file; the frontend total is the parse time and
+    # each top-level "Source" event is the time spent parsing one include.
+    if(time_trace AND EXISTS ${trace})
+        file(READ ${trace} trace_content)
+        if(trace_content MATCHES "\"dur\":([0-9]+),\"name\":\"Total Frontend\"")
+            string(APPEND json ", \"parse_us\": ${CMAKE_MATCH_1}")
+        endif()
+        string(REGEX MATCHALL "\"dur\":[0-9]+,\"name\":\"Source\",\"args\":{\"detail\":\"[^\"]*winrt/[^\"]+\"" sources "${trace_content}")
+        set(source_json "")
+        foreach(source_event ${sources})
+            string(REGEX MATCH "\"dur\":([0-9]+),.*\"detail\":\"[^\"]*(winrt/[^\"]+)\"" ignore "${source_event}")
+            if(source_json)
+                string(APPEND source_json ", ")
+            endif()
+            string(APPEND source_json "\"${CMAKE_MATCH_2}\": ${CMAKE_MATCH_1}")
+        endforeach()
+        string(APPEND json ", \"source_us\": { ${source_json} }")
+    endif()
+
+    string(APPEND json " }")
+    set(${out_var} ${${out_var}} "${json}" PARENT_SCOPE)
+endfunction()
+
+file(REMOVE_RECURSE "${folder}/consumers")
+file(MAKE_DIRECTORY "${folder}/consumers")
+
+# Full projection: one consumer for base.h, one per namespace header and one including everything.
+
+set(full_folder "${folder}/full")
+NOW_US(start)
+RUN_CPPXLANG(${full_folder})
+NOW_US(finish)
+math(EXPR generate_us "${finish} - ${start}")
+GET_NAMESPACE_HEADERS(${full_folder} namespace_headers)
+list(LENGTH namespace_headers namespace_count)
+if(namespace_count EQUAL 0)
+    message(FATAL_ERROR "No namespace headers were generated from ${input}")
+endif()
+
+set(namespaces "")
+foreach(header ${namespace_headers})
+    string(REGEX REPLACE "\\.h$" "" namespace ${header})
+    list(APPEND namespaces ${namespace})
+endforeach()
+
+set(consumers "")
+MEASURE_CONSUMER(consumers "base" ${full_folder} base.h)
+MEASURE_CONSUMER(consumers "coroutine" ${full_folder} base.h coroutine.h)
+
+foreach(namespace ${namespaces})
+    MEASURE_CONSUMER(consumers "header.${namespace}" ${full_folder} ${namespace}.h)
+endforeach()
+
+MEASURE_CONSUMER(consumers "all" ${full_folder} ${namespace_headers})
+
+# Sized projections: the first N namespaces of the input, generated on their own so that
+# the growth of the generated code can be tracked against the size of the metadata.
+
+set(size_json "")
+foreach(size ${sizes})
+    if(size LESS 1)
+        message(WARNING "Skipping projection size ${size}")
+        continue()
+    endif()
+    if(size GREATER namespace_count)
+        set(size ${namespace_count})
+    endif()
+
+    # -include only narrows the component filter and matches prefixes of type names, so the sized
+    # projections are seeded with -lean instead, which looks each namespace up by its exact name and
+    # adds the types the namespace depends on.
+
+    math(EXPR last "${size} - 1")
+    set(seeds "")
+    set(size_headers "")
+    foreach(index RANGE ${last})
+        list(GET namespaces ${index} namespace)
+        list(APPEND seeds ${namespace})
+        list(APPEND size_headers "${namespace}.h")
+    endforeach()
+
+    set(size_folder "${folder}/size.${size}")
+    NOW_US(start)
+    RUN_CPPXLANG(${size_folder} -lean ${seeds})
+    NOW_US(finish)
+    math(EXPR size_generate_us "${finish} - ${start}")
+
+    set(generated_bytes 0)
+    file(GLOB_RECURSE generated "${size_folder}/*.h")
+    foreach(file ${generated})
+        file(SIZE ${file} file_size)
+        math(EXPR generated_bytes "${generated_bytes} + ${file_size}")
+    endforeach()
+
+    set(size_consumer "")
+    MEASURE_CONSUMER(size_consumer "size.${size}" ${size_folder} ${size_headers})
+    if(size_json)
+        string(APPEND size_json ",\n")
+    endif()
+    string(APPEND size_json "    { \"namespaces\": ${size}, \"generate_us\": ${size_generate_us}, \"generated_bytes\": ${generated_bytes}, \"consumer\": ${size_consumer} }")
+endforeach()
+
+string(REPLACE ";" ",\n    " consumer_json "${consumers}")
+string(TIMESTAMP timestamp UTC)
+
+file(WRITE ${out_json} "{\n")
+file(APPEND ${out_json} "  \"timestamp\": \"${timestamp}\",\n")
+file(APPEND ${out_json} "  \"compiler\": \"${compiler}\",\n")
+file(APPEND ${out_json} "  \"args\": \"${args}\",\n")
+file(APPEND ${out_json} "  \"namespaces\": ${namespace_count},\n")
+file(APPEND ${out_json} "  \"generate_us\": ${generate_us},\n")
+file(APPEND ${out_json} "  \"consumers\": [\n    ${consumer_json}\n  ],\n")
+file(APPEND ${out_json} "  \"sizes\": [\n${size_json}\n  ]\n")
+file(APPEND ${out_json} "}\n")
+
+message(STATUS "Compile benchmark written to ${out_json}")
@@ -0,0 +1,86 @@
+#include "pch.h"
+#include "cmd_reader.h"
+#include "meta_reader.h"
+
+using namespace xlang;
+
+namespace
+{
+    void write_file(std::experimental::filesystem::path const& path, std::string_view const& content)
+    {
+        std::ofstream file{ path, std::ios::out | std::ios::binary };
+        file.write(content.data(), content.size());
+    }
+}
+
+TEST_CASE("cmd_reader_files")
+{
+    using namespace std::experimental::filesystem;
+
+    auto const folder = temp_directory_path() / "xlang_test_cmd_reader";
+    remove_all(folder);
+    create_directories(folder / "first");
+    create_directories(folder / "second" / "nested");
+
+    for (int i = 0; i < 20; ++i)
+    {
+        write_file(folder / "first" / (std::to_string(i) + ".winmd"), "first");
+        write_file(folder / "second" / (std::to_string(i) + ".txt"), "second");
+    }
+
+    write_file(folder / "second" / "nested" / "skipped.winmd", "nested");
+    write_file(folder / "single.txt", "single");
+
+    auto const first = (folder / "first").string();
+    auto const second = (folder / "second").string();
+    auto const single = (folder / "single.txt").string();
+    char const* argv[]{ "test", "-input", first.c_str(), second.c_str(), single.c_str() };
+    cmd::option const options[]{ { "input", 1 } };
+    cmd::reader args{ std::size(argv), argv, options };
+
+    // Every file in the directories is offered to the filter exactly once, from any thread, while a file
+    // named on its own is always kept. Directories are not searched recursively.
+
+    std::atomic<uint32_t> calls{};
+
+    auto files = args.files("input", [&](std::string const& path)
+    {
+        ++calls;
+        return path.size() > 6 && path.compare(path.size() - 6, 6, ".winmd") == 0;
+    });
+
+    REQUIRE(calls == 40);
+    REQUIRE(files.size() == 21);
+    REQUIRE(files.count(canonical(single).string()));
+    REQUIRE(files.count(canonical(folder / "first" / "7.winmd").string()));
+    REQUIRE(!files.count(canonical(folder / "second" / "nested" / "skipped.winmd").string()));
+    REQUIRE(args.files("input").size() == 41);
+
+    char const* missing[]{ "test", "-input", "xlang_test_cmd_reader_missing" };
+    REQUIRE_THROWS(cmd::reader{ std::size(missing), missing, options }.files("input"));
+
+    remove_all(folder);
+}
+
+TEST_CASE("cmd_reader_probe")
+{
+    using namespace std::experimental::filesystem;
+
+    // The probe rejects files that are not metadata without throwing, and keeps nothing for them.
+
+    auto const folder = temp_directory_path() / "xlang_test_cmd_reader";
+    create_directories(folder);
+    auto const text = (folder / "text.winmd").string();
+    auto const executable = (folder / "executable.winmd").string();
+    write_file(text, "not metadata");
+    write_file(executable, std::string(256, '\0').replace(0, 2, "MZ"));
+
+    meta::reader::database_probe probe;
+    REQUIRE(!probe(text));
+    REQUIRE(!probe(executable));
+    REQUIRE(!probe.take(text));
+    REQUIRE(!meta::reader::database::is_database(text));
+    REQUIRE_THROWS(meta::reader::database{ text });
+
+    remove_all(folder);
+}
@@ -0,0 +1,35 @@
+#include "pch.h"
+#include "meta_reader.h"
+
+using namespace xlang::meta::reader;
+
+TEST_CASE("filter")
+{
+    std::vector<std::string> includes{ "Windows.Foundation", "Windows.UI.Xaml.Controls.Button", "A.B" };
+    std::vector<std::string> excludes{ "Windows.Foundation.Collections", "Windows.UI.Xaml.Controls.ButtonBase" };
+    filter f{ includes, excludes };
+
+    REQUIRE(!f.empty());
+    REQUIRE(f.includes("Windows.Foundation", "Uri"));
+    REQUIRE(f.includes("Windows.Foundation.Metadata", "DefaultAttribute"));
+    REQUIRE(!f.includes("Windows.Foundation.Collections", "IVector`1"));
+    REQUIRE(f.includes("Windows.UI.Xaml.Controls", "Button"));
+    REQUIRE(f.includes("Windows.UI.Xaml.Controls", "ButtonAutomationPeer"));
+    REQUIRE(!f.includes("Windows.UI.Xaml.Controls", "ButtonBase"));
+    REQUIRE(!f.includes("Windows.UI.Xaml.Controls", "TextBox"));
+    REQUIRE(!f.includes("Windows.UI", "Colors"));
+    REQUIRE(f.includes("A.Bc", "D"));
+    REQUIRE(f.includes("A", "B"));
+    REQUIRE(!f.includes("A", "C"));
+}
+
+TEST_CASE("filter_empty")
+{
+    filter f;
+    REQUIRE(f.empty());
+    REQUIRE(f.includes("Windows.Foundation", "Uri"));
+
+    filter g{ std::vector<std::string>{}, std::vector<std::string>{} };
+    REQUIRE(g.empty());
+    REQUIRE(g.includes("Windows.Foundation", "Uri"));
+}
@@ -0,0 +1,33 @@
+#include "pch.h"
+#include "task_group.h"
+
+using namespace xlang;
+
+TEST_CASE("task_group")
+{
+    // Every task runs, including those added after an earlier get(), and a failing task does not stop
+    // the others. get() waits for all of them before it reports the failure.
+
+    std::atomic<uint32_t> count{};
+    task_group group;
+
+    for (uint32_t i = 0; i != 100; ++i)
+    {
+        group.add([&] { ++count; });
+    }
+
+    group.get();
+    REQUIRE(count == 100);
+
+    group.add([] { throw std::invalid_argument("task"); });
+
+    for (uint32_t i = 0; i != 100; ++i)
+    {
+        group.add([&] { ++count; });
+    }
+
+    REQUIRE_THROWS_AS(group.get(), std::invalid_argument);
+    REQUIRE(count == 200);
+
+    group.get();
+}
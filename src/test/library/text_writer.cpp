@@ -18,3 +18,153 @@ TEST_CASE("writer")
 
     REQUIRE(w.flush_to_string() == "pre 123 % String post");
 }
+
+TEST_CASE("writer_manifest")
+{
+    using namespace std::experimental::filesystem;
+
+    auto const folder = temp_directory_path() / "xlang_test_library";
+    create_directories(folder);
+    auto const filename = (folder / "output.h").string();
+    auto const manifest_filename = (folder / "output.manifest").string();
+    remove(filename);
+    remove(manifest_filename);
+
+    auto read_file = [&]
+    {
+        std::ifstream file{ filename, std::ios::in | std::ios::binary };
+        return std::string{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+    };
+
+    {
+        xlang::text::output_manifest manifest{ manifest_filename };
+        writer w;
+        w.write("content");
+        w.flush_to_file(filename, manifest);
+        manifest.save();
+    }
+
+    REQUIRE(read_file() == "content");
+
+    {
+        xlang::text::output_manifest manifest{ manifest_filename };
+        std::vector<char> content{ 'c', 'o', 'n', 't', 'e', 'n', 't' };
+        REQUIRE(manifest.is_current(filename, xlang::text::hash_content(content, {}), content.size()));
+
+        writer w;
+        w.write("changed");
+        w.flush_to_file(filename, manifest);
+        manifest.save();
+    }
+
+    REQUIRE(read_file() == "changed");
+
+    remove_all(folder);
+}
+
+TEST_CASE("writer_output_stage")
+{
+    using namespace std::experimental::filesystem;
+
+    auto const folder = temp_directory_path() / "xlang_test_library";
+    remove_all(folder);
+
+    for (bool asynchronous : { true, false })
+    {
+        xlang::text::output_stage stage{ asynchronous, nullptr, 64 };
+
+        for (int i = 0; i < 100; ++i)
+        {
+            writer w;
+            w.write("file %", i);
+            w.flush_to_file((folder / "nested" / (std::to_string(i) + ".h")).string(), stage);
+        }
+
+        stage.flush();
+        auto stats = stage.get_statistics();
+        REQUIRE(stats.files == 100);
+        REQUIRE(stats.written == (asynchronous ? 100 : 0));
+        REQUIRE(stats.directories == 1);
+    }
+
+    std::ifstream file{ (folder / "nested" / "42.h").string() };
+    std::string content{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+    REQUIRE(content == "file 42");
+
+    remove_all(folder);
+}
+
+TEST_CASE("writer_numbers")
+{
+    writer w;
+    w.write("% % %", -123, static_cast<int64_t>(INT64_MIN), static_cast<uint64_t>(UINT64_MAX));
+    w.write(' ');
+    w.write_decimal(static_cast<int8_t>(-128));
+    w.write(' ');
+    w.write_hex_literal(0u);
+    w.write(' ');
+    w.write_hex_literal(0xabcu);
+    w.write(' ');
+    w.write_hex(static_cast<uint8_t>(0xa), 2, true);
+    w.write(' ');
+    w.write_guid(0x1234abcd, 0x12, 0xef, { 1, 2, 3, 4, 5, 6, 7, 0xff });
+    w.write(' ');
+    w.write_guid(0x1234abcd, 0x12, 0xef, { 1, 2, 3, 4, 5, 6, 7, 0xff }, true);
+
+    REQUIRE(w.flush_to_string() == "-123 -9223372036854775808 18446744073709551615 -128 0 0xabc 0A 1234abcd-0012-00ef-0102-0304050607ff 1234ABCD-0012-00EF-0102-0304050607FF");
+}
+
+TEST_CASE("writer_numbers_benchmark", "[.benchmark]")
+{
+    // Approximates the enum and constant heavy output of large namespaces.
+
+    writer w;
+
+    BENCHMARK("write_printf")
+    {
+        for (uint32_t i = 0; i < 100'000; ++i)
+        {
+            w.write_printf("%d", static_cast<int32_t>(i));
+            w.write_printf("%#0x", i);
+        }
+    }
+
+    w.flush_to_string();
+
+    BENCHMARK("write_decimal/write_hex_literal")
+    {
+        for (uint32_t i = 0; i < 100'000; ++i)
+        {
+            w.write_decimal(static_cast<int32_t>(i));
+            w.write_hex_literal(i);
+        }
+    }
+
+    w.flush_to_string();
+}
+
+TEST_CASE("writer_indent")
+{
+    writer w;
+    w.write("a\n");
+
+    {
+        writer::indent_guard outer{ w };
+        w.write("b\nc\n");
+
+        {
+            writer::indent_guard inner{ w, 2 };
+            w.write("d");
+            REQUIRE(w.write_temp("%\n%", 1, 2) == "1\n2");
+            w.write('\n');
+            w.write('e');
+        }
+
+        w.write("\nf\n");
+    }
+
+    w.write("g");
+    w.write_indent(1);
+
+    REQUIRE(w.flush_to_string() == "a\n    b\n    c\n            d\n            e\n    f\ng    ");
+}
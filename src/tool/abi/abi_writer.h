@@ -66,10 +66,7 @@ struct writer : xlang::text::writer_base<writer>
 
     void write(indent value)
     {
-        for (std::size_t i = 0; i < (m_indentation + value.additional_indentation); ++i)
-        {
-            write("    ");
-        }
+        write_indent(static_cast<uint32_t>(m_indentation + value.additional_indentation));
     }
 
     void write_value(bool value)
@@ -79,47 +76,47 @@ struct writer : xlang::text::writer_base<writer>
 
     void write_value(char16_t value)
     {
-        write_printf("%#0hx", value);
+        write_hex_literal(value);
     }
 
     void write_value(int8_t value)
     {
-        write_printf("%hhd", value);
+        write_decimal(value);
     }
 
     void write_value(uint8_t value)
     {
-        write_printf("%#0hhx", value);
+        write_hex_literal(value);
     }
 
     void write_value(int16_t value)
     {
-        write_printf("%hd", value);
+        write_decimal(value);
     }
 
     void write_value(uint16_t value)
     {
-        write_printf("%#0hx", value);
+        write_hex_literal(value);
     }
 
     void write_value(int32_t value)
     {
-        write_printf("%d", value);
+        write_decimal(value);
     }
 
     void write_value(uint32_t value)
     {
-        write_printf("%#0x", value);
+        write_hex_literal(value);
     }
 
     void write_value(int64_t value)
     {
-        write_printf("%lld", value);
+        write_decimal(value);
     }
 
     void write_value(uint64_t value)
     {
-        write_printf("%#0llx", value);
+        write_hex_literal(value);
     }
 
     void write_value(float value)
@@ -197,12 +197,11 @@ inline void write_generated_uuid(writer& w, metadata_type const& type)
     auto iidHash = signatureHash.finalize();
     iidHash[6] = (iidHash[6] & 0x0F) | 0x50;
     iidHash[8] = (iidHash[8] & 0x3F) | 0x80;
-    w.write_printf("%02x%02x%02x%02x-%02x%02x-%02x%02x-%02x%02x-%02x%02x%02x%02x%02x%02x",
-        iidHash[0], iidHash[1], iidHash[2], iidHash[3],
-        iidHash[4], iidHash[5],
-        iidHash[6], iidHash[7],
-        iidHash[8], iidHash[9],
-        iidHash[10], iidHash[11], iidHash[12], iidHash[13], iidHash[14], iidHash[15]);
+    w.write_guid(
+        (static_cast<std::uint32_t>(iidHash[0]) << 24) | (iidHash[1] << 16) | (iidHash[2] << 8) | iidHash[3],
+        static_cast<std::uint16_t>((iidHash[4] << 8) | iidHash[5]),
+        static_cast<std::uint16_t>((iidHash[6] << 8) | iidHash[7]),
+        { iidHash[8], iidHash[9], iidHash[10], iidHash[11], iidHash[12], iidHash[13], iidHash[14], iidHash[15] });
 }
 
 inline void write_uuid(writer& w, generic_inst const& type)
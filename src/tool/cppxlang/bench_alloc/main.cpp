@@ -0,0 +1,280 @@
+#include <winrt/Windows.Foundation.Collections.h>
+#include "bench.h"
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <thread>
+#include <vector>
+
+// Measures map iteration, which creates an iterator per pass and a key/value pair per element, with the
+// objects allocated from the global heap, from the pool (allocate_with<pool_allocator>), and from a
+// pool_arena bound for each pass (allocate_with<arena_allocator>). Every global operator new is counted, so the report shows how
+// many heap allocations each pass makes as well as how long it takes, on one thread and on several.
+//
+// The map implements IIterable<IKeyValuePair<Int32, Int32>> from the Windows.Foundation.Collections
+// projection that cppxlang generates from XLANG_TEST_METADATA.
+
+static std::atomic<uint64_t> allocations;
+
+void* operator new(size_t const size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+
+    if (void* result = std::malloc(size ? size : 1))
+    {
+        return result;
+    }
+
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t const size, std::align_val_t const alignment)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+
+    if (void* result = std::aligned_alloc(static_cast<size_t>(alignment), (size + static_cast<size_t>(alignment) - 1) & ~(static_cast<size_t>(alignment) - 1)))
+    {
+        return result;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+namespace winrt::Bench::implementation
+{
+    using Windows::Foundation::Collections::IIterable;
+    using Windows::Foundation::Collections::IIterator;
+    using Windows::Foundation::Collections::IKeyValuePair;
+
+    // The same map, iterator and pair as the runtime's collections, with the markers given to implements<>
+    // (none, allocate_with<pool_allocator>, or allocate_with<arena_allocator>).
+
+    template <typename... Markers>
+    struct Pair : implements<Pair<Markers...>, Markers..., IKeyValuePair<int32_t, int32_t>>
+    {
+        Pair(int32_t const key, int32_t const value) noexcept : m_key(key), m_value(value)
+        {
+        }
+
+        int32_t Key() const noexcept
+        {
+            return m_key;
+        }
+
+        int32_t Value() const noexcept
+        {
+            return m_value;
+        }
+
+    private:
+
+        int32_t const m_key;
+        int32_t const m_value;
+    };
+
+    template <typename... Markers>
+    struct Pairs : implements<Pairs<Markers...>, Markers..., IIterable<IKeyValuePair<int32_t, int32_t>>>
+    {
+        explicit Pairs(std::map<int32_t, int32_t> values) : m_values(std::move(values))
+        {
+        }
+
+        IIterator<IKeyValuePair<int32_t, int32_t>> First();
+
+        std::map<int32_t, int32_t> const m_values;
+    };
+
+    template <typename... Markers>
+    struct PairIterator : implements<PairIterator<Markers...>, Markers..., IIterator<IKeyValuePair<int32_t, int32_t>>>
+    {
+        explicit PairIterator(Pairs<Markers...>* owner) noexcept : m_current(owner->m_values.begin()), m_end(owner->m_values.end())
+        {
+            m_owner.copy_from(owner);
+        }
+
+        IKeyValuePair<int32_t, int32_t> Current() const
+        {
+            if (m_current == m_end)
+            {
+                throw hresult_out_of_bounds();
+            }
+
+            return make<Pair<Markers...>>(m_current->first, m_current->second);
+        }
+
+        bool HasCurrent() const noexcept
+        {
+            return m_current != m_end;
+        }
+
+        bool MoveNext() noexcept
+        {
+            if (m_current != m_end)
+            {
+                ++m_current;
+            }
+
+            return m_current != m_end;
+        }
+
+        uint32_t GetMany(array_view<IKeyValuePair<int32_t, int32_t>> values)
+        {
+            uint32_t count{};
+
+            for (; count != values.size() && m_current != m_end; ++count, ++m_current)
+            {
+                values[count] = make<Pair<Markers...>>(m_current->first, m_current->second);
+            }
+
+            return count;
+        }
+
+    private:
+
+        com_ptr<Pairs<Markers...>> m_owner;
+        typename std::map<int32_t, int32_t>::const_iterator m_current;
+        typename std::map<int32_t, int32_t>::const_iterator const m_end;
+    };
+
+    template <typename... Markers>
+    IIterator<IKeyValuePair<int32_t, int32_t>> Pairs<Markers...>::First()
+    {
+        return make<PairIterator<Markers...>>(this);
+    }
+}
+
+using pair_iterable = winrt::Windows::Foundation::Collections::IIterable<winrt::Windows::Foundation::Collections::IKeyValuePair<int32_t, int32_t>>;
+
+static int64_t visit(pair_iterable const& pairs)
+{
+    int64_t sum{};
+    auto iterator = pairs.First();
+
+    while (iterator.HasCurrent())
+    {
+        auto pair = iterator.Current();
+        sum += pair.Key() + pair.Value();
+        iterator.MoveNext();
+    }
+
+    return sum;
+}
+
+template <bool Arena>
+static void iterate(pair_iterable const& pairs, int64_t const expected, uint64_t const passes)
+{
+    int64_t sum{};
+
+    for (uint64_t pass = 0; pass != passes; ++pass)
+    {
+        if constexpr (Arena)
+        {
+            winrt::pool_arena const arena;
+            sum += visit(pairs);
+        }
+        else
+        {
+            sum += visit(pairs);
+        }
+    }
+
+    if (sum != expected * static_cast<int64_t>(passes))
+    {
+        std::abort();
+    }
+}
+
+struct result
+{
+    double ns;
+    double allocations;
+};
+
+// Each thread makes passes over the same map, and the time and global allocations are per pass.
+
+template <bool Arena>
+static result measure(pair_iterable const& pairs, int64_t const expected, uint64_t const passes, uint32_t const threads)
+{
+    std::vector<std::thread> workers;
+    uint64_t const before = allocations.load();
+    auto const start = clock_type::now();
+
+    for (uint32_t thread = 1; thread < threads; ++thread)
+    {
+        workers.emplace_back([&]
+        {
+            iterate<Arena>(pairs, expected, passes);
+        });
+    }
+
+    iterate<Arena>(pairs, expected, passes);
+
+    for (auto&& worker : workers)
+    {
+        worker.join();
+    }
+
+    double const ns = elapsed_ns(start) / (passes * threads);
+    return { ns, static_cast<double>(allocations.load() - before - (threads - 1)) / (passes * threads) };
+}
+
+int main(int const argc, char** argv)
+{
+    using namespace winrt;
+    using namespace Bench::implementation;
+
+    // The amount of work is the number of elements visited by each thread.
+
+    uint64_t const work = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20'000'000;
+    uint32_t const threads = (std::max)((std::min)(std::thread::hardware_concurrency(), 8u), 2u);
+
+    for (int32_t size : { 1, 8, 64, 1024 })
+    {
+        std::map<int32_t, int32_t> values;
+        int64_t expected{};
+
+        for (int32_t i = 0; i != size; ++i)
+        {
+            values[i] = i * 2;
+            expected += i + i * 2;
+        }
+
+        uint64_t const passes = (std::max)(work / size, uint64_t{ 1 });
+        pair_iterable const heap = make<Pairs<>>(values);
+        pair_iterable const pool = make<Pairs<allocate_with<pool_allocator>>>(values);
+        pair_iterable const arena = make<Pairs<allocate_with<arena_allocator>>>(values);
+
+        for (uint32_t count : { 1u, threads })
+        {
+            result const heap_result = measure<false>(heap, expected, passes, count);
+            result const pool_result = measure<false>(pool, expected, passes, count);
+            result const arena_result = measure<true>(arena, expected, passes, count);
+
+            printf("%4d items x%u: heap %6.1f ns/item %7.2f allocations/pass  pool %6.1f ns/item %5.2f allocations/pass  arena %6.1f ns/item %5.2f allocations/pass\n",
+                size, count,
+                heap_result.ns / size, heap_result.allocations,
+                pool_result.ns / size, pool_result.allocations,
+                arena_result.ns / size, arena_result.allocations);
+        }
+    }
+}
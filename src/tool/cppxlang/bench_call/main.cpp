@@ -0,0 +1,188 @@
+#include <winrt/base.h>
+#include "bench.h"
+#include <cstdio>
+#include <cstdlib>
+
+// Measures the cost of a property call on a component implemented in the same module. A projected call
+// goes through the ABI (consume -> vtable -> produce -> check_hresult), and is compared against:
+//
+//   produce   the same produce method called without the virtual call, which is what the ABI costs
+//             once the vtable is out of the way
+//   direct    a consume method that recognizes an implementation in the same module by its
+//             produce<D, I> vtable and calls it through an out-of-line thunk, skipping the ABI
+//   fallback  the direct consume method called on an implementation it does not recognize, which pays
+//             for the failed check and then the ABI call
+//
+// The direct call is what an earlier -direct option of cppxlang emitted. It never beat the ABI call it
+// was meant to bypass, so cppxlang no longer emits it, and this benchmark reproduces that result.
+//
+// The projection below is written out by hand in the shape cppxlang generates for a component interface
+// "Bench.IWidget { Int32 Value; }".
+
+WINRT_EXPORT namespace winrt::Bench
+{
+    struct IWidget;
+}
+
+WINRT_EXPORT namespace winrt::impl
+{
+    template <> struct category<Bench::IWidget>
+    {
+        using type = interface_category;
+    };
+    template <> struct name<Bench::IWidget>
+    {
+        static constexpr auto & value{ L"Bench.IWidget" };
+    };
+    template <> struct guid_storage<Bench::IWidget>
+    {
+        static constexpr guid value{ 0x6A37D1A2,0x0C5B,0x4E4B,{ 0x9B,0x3E,0x5D,0x1F,0x2A,0x40,0x71,0x01 } };
+    };
+    template <> struct abi<Bench::IWidget>
+    {
+        struct WINRT_NOVTABLE type : inspectable_abi
+        {
+            virtual int32_t WINRT_CALL get_Value(int32_t* value) noexcept = 0;
+        };
+    };
+    template <typename D>
+    struct consume_Bench_IWidget
+    {
+        int32_t Value() const;
+    };
+    template <> struct consume<Bench::IWidget>
+    {
+        template <typename D> using type = consume_Bench_IWidget<D>;
+    };
+}
+
+WINRT_EXPORT namespace winrt::Bench
+{
+    struct WINRT_EBO IWidget :
+        Windows::Foundation::IInspectable,
+        impl::consume_t<IWidget>
+    {
+        IWidget(std::nullptr_t = nullptr) noexcept {}
+        IWidget(void* ptr, take_ownership_from_abi_t) noexcept : Windows::Foundation::IInspectable(ptr, take_ownership_from_abi) {}
+    };
+}
+
+WINRT_EXPORT namespace winrt::impl
+{
+    template <typename D> int32_t consume_Bench_IWidget<D>::Value() const
+    {
+        int32_t value;
+        check_hresult(WINRT_SHIM(Bench::IWidget)->get_Value(&value));
+        return value;
+    }
+    template <typename D>
+    struct produce<D, Bench::IWidget> : produce_base<D, Bench::IWidget>
+    {
+        int32_t WINRT_CALL get_Value(int32_t* value) noexcept final try
+        {
+            typename D::abi_guard guard(this->shim());
+            *value = detach_from<int32_t>(this->shim().Value());
+            return 0;
+        }
+        catch (...) { return to_hresult(); }
+    };
+}
+
+namespace winrt::Bench::implementation
+{
+    struct Widget : implements<Widget, Bench::IWidget>
+    {
+        int32_t Value() const noexcept
+        {
+            return m_value;
+        }
+
+        int32_t m_value{ 1 };
+    };
+
+    struct OtherWidget : implements<OtherWidget, Bench::IWidget>
+    {
+        int32_t Value() const noexcept
+        {
+            return m_value;
+        }
+
+        int32_t m_value{ 1 };
+    };
+}
+
+namespace
+{
+    using namespace winrt;
+    using widget_produce = impl::produce<Bench::implementation::Widget, Bench::IWidget>;
+
+    // What Widget.g.cpp contained with -direct: the vtable that identifies the implementation, and the
+    // thunk that calls it. The vtable is read from a Widget when the benchmark starts.
+
+    void* direct_vtable{};
+
+    int32_t direct_get_Value(void* abi)
+    {
+        auto& self = static_cast<widget_produce*>(static_cast<impl::abi_t<Bench::IWidget>*>(abi))->shim();
+        Bench::implementation::Widget::abi_guard guard(self);
+        return self.Value();
+    }
+
+    // What the consume method was with -direct.
+
+    int32_t direct_Value(Bench::IWidget const& object)
+    {
+        auto const abi = *(impl::abi_t<Bench::IWidget>**)&object;
+
+        if (*reinterpret_cast<void* const*>(abi) == direct_vtable)
+        {
+            return direct_get_Value(abi);
+        }
+
+        int32_t value;
+        check_hresult(abi->get_Value(&value));
+        return value;
+    }
+
+    int32_t produce_Value(Bench::IWidget const& object)
+    {
+        auto const abi = static_cast<widget_produce*>(*(impl::abi_t<Bench::IWidget>**)&object);
+        int32_t value;
+        check_hresult(abi->widget_produce::get_Value(&value));
+        return value;
+    }
+
+    template <typename Call>
+    double measure(Bench::IWidget const& object, uint64_t const iterations, Call call)
+    {
+        auto const start = clock_type::now();
+        int64_t sum{};
+
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            sum += call(object);
+        }
+
+        double const elapsed = elapsed_ns(start);
+
+        if (sum != static_cast<int64_t>(iterations))
+        {
+            std::abort();
+        }
+
+        return elapsed / iterations;
+    }
+}
+
+int main(int const argc, char** argv)
+{
+    uint64_t const iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100'000'000;
+    Bench::IWidget const widget = make<Bench::implementation::Widget>();
+    Bench::IWidget const other = make<Bench::implementation::OtherWidget>();
+    direct_vtable = *reinterpret_cast<void* const*>(get_abi(widget));
+
+    printf("abi:      %6.2f ns/call\n", measure(widget, iterations, [](Bench::IWidget const& object) { return object.Value(); }));
+    printf("produce:  %6.2f ns/call\n", measure(widget, iterations, produce_Value));
+    printf("direct:   %6.2f ns/call\n", measure(widget, iterations, direct_Value));
+    printf("fallback: %6.2f ns/call\n", measure(other, iterations, direct_Value));
+}
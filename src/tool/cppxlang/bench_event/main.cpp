@@ -0,0 +1,163 @@
+#include <winrt/base.h>
+#include "bench.h"
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+// Measures winrt::event registration, revocation, and invocation with 1, 10 and 10k handlers, invoked
+// from one thread, from several threads at once, and from several threads while another thread keeps
+// adding and removing a handler.
+
+using handler = winrt::delegate<int32_t>;
+
+static thread_local uint64_t calls;
+
+static handler make_handler()
+{
+    return [](int32_t value)
+    {
+        calls += value;
+    };
+}
+
+static double remove_all(winrt::event<handler>& event, std::vector<winrt::event_token> const& tokens)
+{
+    auto const start = clock_type::now();
+
+    for (auto&& token : tokens)
+    {
+        event.remove(token);
+    }
+
+    return elapsed_ns(start);
+}
+
+static void measure(uint32_t const count, uint64_t const work, uint32_t const threads)
+{
+    winrt::event<handler> event;
+    std::vector<winrt::event_token> tokens(count);
+    std::vector<handler> handlers(count);
+
+    for (auto&& value : handlers)
+    {
+        value = make_handler();
+    }
+
+    // Adding and removing every handler is repeated until a million of each have been timed, so that
+    // the measurement with few handlers is not a single call.
+
+    uint64_t const rounds = (std::max)(uint64_t{ 1'000'000 } / count, uint64_t{ 1 });
+    double add{};
+    double remove{};
+
+    for (uint64_t round = 0; round != rounds; ++round)
+    {
+        auto const start = clock_type::now();
+
+        for (uint32_t i = 0; i != count; ++i)
+        {
+            tokens[i] = event.add(handlers[i]);
+        }
+
+        add += elapsed_ns(start);
+
+        if (round + 1 == rounds)
+        {
+            break;
+        }
+
+        remove += remove_all(event, tokens);
+    }
+
+    uint64_t const fires = (std::max)(work / count, uint64_t{ 1 });
+
+    auto start = clock_type::now();
+
+    for (uint64_t i = 0; i != fires; ++i)
+    {
+        event(1);
+    }
+
+    double const fire = elapsed_ns(start) / fires;
+
+    // Every thread fires the same event, first on its own and then while the event keeps changing.
+
+    auto fire_threads = [&](bool const churn)
+    {
+        std::atomic<bool> done{};
+        std::thread changer;
+        uint64_t changes{};
+
+        if (churn)
+        {
+            changer = std::thread([&]
+            {
+                auto extra = make_handler();
+
+                while (!done.load(std::memory_order_relaxed))
+                {
+                    event.remove(event.add(extra));
+                    ++changes;
+                }
+            });
+        }
+
+        std::vector<std::thread> workers;
+        auto const start = clock_type::now();
+
+        for (uint32_t thread = 0; thread != threads; ++thread)
+        {
+            workers.emplace_back([&]
+            {
+                for (uint64_t i = 0; i != fires; ++i)
+                {
+                    event(1);
+                }
+            });
+        }
+
+        for (auto&& worker : workers)
+        {
+            worker.join();
+        }
+
+        double const result = elapsed_ns(start) / (fires * threads);
+        done = true;
+
+        if (changer.joinable())
+        {
+            changer.join();
+        }
+
+        return result;
+    };
+
+    double const parallel = fire_threads(false);
+    double const churn = fire_threads(true);
+
+    remove += remove_all(event, tokens);
+    add /= static_cast<double>(rounds) * count;
+    remove /= static_cast<double>(rounds) * count;
+
+    if (event)
+    {
+        std::abort();
+    }
+
+    printf("%6u handlers: add %8.1f ns  remove %9.1f ns  fire %10.1f ns  fire x%u %10.1f ns  fire x%u with churn %10.1f ns\n",
+        count, add, remove, fire, threads, parallel, threads, churn);
+}
+
+int main(int const argc, char** argv)
+{
+    // The amount of work is the number of handler calls made by each invocation test.
+
+    uint64_t const work = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10'000'000;
+    uint32_t const threads = (std::max)((std::min)(std::thread::hardware_concurrency(), 8u), 2u);
+
+    for (uint32_t count : { 1u, 10u, 10'000u })
+    {
+        measure(count, work, threads);
+    }
+}
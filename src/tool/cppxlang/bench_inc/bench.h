@@ -0,0 +1,12 @@
+#pragma once
+
+#include <chrono>
+
+// Timing shared by the benchmarks.
+
+using clock_type = std::chrono::high_resolution_clock;
+
+inline double elapsed_ns(clock_type::time_point const start)
+{
+    return std::chrono::duration<double, std::nano>(clock_type::now() - start).count();
+}
@@ -0,0 +1,171 @@
+#include <winrt/Windows.Foundation.Collections.h>
+#include "bench.h"
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+// Measures iteration-heavy code, where every pass creates an iterator that holds a reference to its
+// collection, for objects with the default atomic reference count and for single_threaded objects. It
+// also measures copying a reference on its own (an AddRef and a Release).
+//
+// The collection implements IIterable<Int32> from the Windows.Foundation.Collections projection that
+// cppxlang generates from XLANG_TEST_METADATA.
+
+namespace winrt::Bench::implementation
+{
+    using Windows::Foundation::Collections::IIterable;
+    using Windows::Foundation::Collections::IIterator;
+
+    // The same collection and iterator, with the markers given to implements<> (none, or single_threaded).
+
+    template <typename... Markers>
+    struct Numbers : implements<Numbers<Markers...>, Markers..., IIterable<int32_t>>
+    {
+        explicit Numbers(std::vector<int32_t> values) : m_values(std::move(values))
+        {
+        }
+
+        IIterator<int32_t> First();
+
+        std::vector<int32_t> const m_values;
+    };
+
+    template <typename... Markers>
+    struct NumberIterator : implements<NumberIterator<Markers...>, Markers..., IIterator<int32_t>>
+    {
+        explicit NumberIterator(Numbers<Markers...>* owner) noexcept
+        {
+            m_owner.copy_from(owner);
+        }
+
+        int32_t Current() const
+        {
+            if (m_index == m_owner->m_values.size())
+            {
+                throw hresult_out_of_bounds();
+            }
+
+            return m_owner->m_values[m_index];
+        }
+
+        bool HasCurrent() const noexcept
+        {
+            return m_index != m_owner->m_values.size();
+        }
+
+        bool MoveNext() noexcept
+        {
+            if (m_index != m_owner->m_values.size())
+            {
+                ++m_index;
+            }
+
+            return m_index != m_owner->m_values.size();
+        }
+
+        uint32_t GetMany(array_view<int32_t> values) noexcept
+        {
+            uint32_t count{};
+
+            for (; count != values.size() && m_index != m_owner->m_values.size(); ++count, ++m_index)
+            {
+                values[count] = m_owner->m_values[m_index];
+            }
+
+            return count;
+        }
+
+    private:
+
+        com_ptr<Numbers<Markers...>> m_owner;
+        size_t m_index{};
+    };
+
+    template <typename... Markers>
+    IIterator<int32_t> Numbers<Markers...>::First()
+    {
+        return make<NumberIterator<Markers...>>(this);
+    }
+}
+
+using int_iterable = winrt::Windows::Foundation::Collections::IIterable<int32_t>;
+
+static double measure_iterate(int_iterable const& numbers, int64_t const expected, uint64_t const passes)
+{
+    auto const start = clock_type::now();
+    int64_t sum{};
+
+    for (uint64_t pass = 0; pass != passes; ++pass)
+    {
+        auto iterator = numbers.First();
+
+        while (iterator.HasCurrent())
+        {
+            sum += iterator.Current();
+            iterator.MoveNext();
+        }
+    }
+
+    double const result = elapsed_ns(start) / passes;
+
+    if (sum != expected * static_cast<int64_t>(passes))
+    {
+        std::abort();
+    }
+
+    return result;
+}
+
+static double measure_copy(int_iterable const& numbers, uint64_t const copies)
+{
+    auto const start = clock_type::now();
+    uint64_t count{};
+
+    for (uint64_t i = 0; i != copies; ++i)
+    {
+        int_iterable copy = numbers;
+        count += copy != nullptr;
+    }
+
+    double const result = elapsed_ns(start) / copies;
+
+    if (count != copies)
+    {
+        std::abort();
+    }
+
+    return result;
+}
+
+int main(int const argc, char** argv)
+{
+    using namespace winrt;
+
+    // The amount of work is the number of passes over each collection.
+
+    uint64_t const passes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10'000'000;
+
+    for (int32_t size : { 0, 8, 64 })
+    {
+        std::vector<int32_t> values(size);
+        int64_t expected{};
+
+        for (int32_t i = 0; i != size; ++i)
+        {
+            values[i] = i;
+            expected += i;
+        }
+
+        int_iterable atomic = make<Bench::implementation::Numbers<>>(values);
+        int_iterable single = make<Bench::implementation::Numbers<single_threaded>>(values);
+
+        printf("%2d items: iterate atomic %7.1f ns  single_threaded %7.1f ns\n",
+            size, measure_iterate(atomic, expected, passes), measure_iterate(single, expected, passes));
+    }
+
+    int_iterable atomic = make<Bench::implementation::Numbers<>>(std::vector<int32_t>{});
+    int_iterable single = make<Bench::implementation::Numbers<single_threaded>>(std::vector<int32_t>{});
+
+    printf("copy:     atomic %7.2f ns  single_threaded %7.2f ns\n",
+        measure_copy(atomic, passes * 10), measure_copy(single, passes * 10));
+}
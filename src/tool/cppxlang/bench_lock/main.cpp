@@ -0,0 +1,107 @@
+#include <winrt/base.h>
+#include "bench.h"
+#include <cstdio>
+#include <cstdlib>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+// Measures winrt::slim_mutex against std::shared_mutex with 1 to 8 threads taking the same lock, for
+// workloads where every acquire is exclusive, where 9 in 10 are shared, and where all of them are shared,
+// followed by a slim_condition_variable ping-pong between two threads.
+
+template <typename Mutex>
+static double measure(uint32_t const threads, uint32_t const shared_in_ten, uint64_t const iterations)
+{
+    Mutex lock;
+    uint64_t value{};
+    std::vector<std::thread> workers;
+    auto const start = clock_type::now();
+
+    for (uint32_t thread = 0; thread != threads; ++thread)
+    {
+        workers.emplace_back([&]
+        {
+            uint64_t sum{};
+
+            for (uint64_t i = 0; i != iterations; ++i)
+            {
+                if (i % 10 < shared_in_ten)
+                {
+                    lock.lock_shared();
+                    sum += value;
+                    lock.unlock_shared();
+                }
+                else
+                {
+                    lock.lock();
+                    ++value;
+                    lock.unlock();
+                }
+            }
+
+            if (sum == UINT64_MAX)
+            {
+                std::abort();
+            }
+        });
+    }
+
+    for (auto&& worker : workers)
+    {
+        worker.join();
+    }
+
+    if (value != threads * (iterations - iterations / 10 * shared_in_ten - (std::min)(iterations % 10, uint64_t{ shared_in_ten })))
+    {
+        std::abort();
+    }
+
+    return elapsed_ns(start) / (iterations * threads);
+}
+
+static double measure_condition_variable(uint64_t const iterations)
+{
+    winrt::slim_mutex lock;
+    winrt::slim_condition_variable cv;
+    uint64_t turn{};
+
+    auto play = [&](uint64_t const parity)
+    {
+        for (uint64_t i = 0; i != iterations; ++i)
+        {
+            winrt::slim_lock_guard const guard(lock);
+            cv.wait(lock, [&] { return turn % 2 == parity; });
+            ++turn;
+            cv.notify_one();
+        }
+    };
+
+    auto const start = clock_type::now();
+    std::thread other(play, 1);
+    play(0);
+    other.join();
+
+    return elapsed_ns(start) / (iterations * 2);
+}
+
+int main(int const argc, char** argv)
+{
+    // The amount of work is the number of acquires made by each thread.
+
+    uint64_t const iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+
+    for (uint32_t shared_in_ten : { 0u, 9u, 10u })
+    {
+        for (uint32_t threads : { 1u, 2u, 4u, 8u })
+        {
+            double const slim = measure<winrt::slim_mutex>(threads, shared_in_ten, iterations);
+            double const standard = measure<std::shared_mutex>(threads, shared_in_ten, iterations);
+
+            printf("%3u%% shared x%u: slim_mutex %7.1f ns  std::shared_mutex %7.1f ns\n",
+                shared_in_ten * 10, threads, slim, standard);
+        }
+    }
+
+    printf("condition variable hand-off: %7.1f ns\n", measure_condition_variable(iterations / 10));
+}
@@ -0,0 +1,144 @@
+#include <winrt/base.h>
+#include "bench.h"
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Measures the work that map_view_base does for Lookup, HasKey and iteration, for each of the containers
+// that can back single_threaded_map: std::map, std::unordered_map, flat_map and flat_hash_map. Maps of
+// 8 to 64k entries are keyed by integers and by strings shaped like property names. Lookups hit in a
+// random order and HasKey misses.
+
+static int32_t make_key(int32_t const index, int32_t)
+{
+    return index * 7919;
+}
+
+static std::string make_key(int32_t const index, std::string const&)
+{
+    return "Property." + std::to_string(index * 7919) + ".Value";
+}
+
+struct result
+{
+    double lookup;
+    double has_key;
+    double iterate;
+};
+
+template <typename Container>
+static result measure(std::vector<typename Container::key_type> const& hits, std::vector<typename Container::key_type> const& misses, uint64_t const work)
+{
+    // The map is built the way a caller fills one in before handing it to single_threaded_map.
+
+    Container values;
+
+    for (size_t index = 0; index != hits.size(); ++index)
+    {
+        values.insert_or_assign(hits[index], static_cast<int32_t>(index));
+    }
+
+    Container const& container = values;
+    uint64_t const rounds = (std::max)(work / hits.size(), uint64_t{ 1 });
+    int64_t sum{};
+
+    auto start = clock_type::now();
+
+    for (uint64_t round = 0; round != rounds; ++round)
+    {
+        for (auto&& key : hits)
+        {
+            auto pair = container.find(key);
+
+            if (pair == container.end())
+            {
+                std::abort();
+            }
+
+            sum += pair->second;
+        }
+    }
+
+    double const lookup = elapsed_ns(start) / (rounds * hits.size());
+    start = clock_type::now();
+
+    for (uint64_t round = 0; round != rounds; ++round)
+    {
+        for (auto&& key : misses)
+        {
+            sum += container.find(key) != container.end();
+        }
+    }
+
+    double const has_key = elapsed_ns(start) / (rounds * misses.size());
+    start = clock_type::now();
+
+    for (uint64_t round = 0; round != rounds; ++round)
+    {
+        for (auto&& pair : container)
+        {
+            sum += pair.second;
+        }
+    }
+
+    double const iterate = elapsed_ns(start) / (rounds * hits.size());
+    int64_t const expected = static_cast<int64_t>(rounds) * 2 * static_cast<int64_t>(hits.size() * (hits.size() - 1) / 2);
+
+    if (sum != expected)
+    {
+        std::abort();
+    }
+
+    return { lookup, has_key, iterate };
+}
+
+template <typename K>
+static void measure_all(char const* const label, uint64_t const work)
+{
+    for (int32_t size : { 8, 64, 1024, 65536 })
+    {
+        std::vector<K> hits;
+        std::vector<K> misses;
+
+        for (int32_t index = 0; index != size; ++index)
+        {
+            hits.push_back(make_key(index, K{}));
+            misses.push_back(make_key(index + size, K{}));
+        }
+
+        std::shuffle(hits.begin(), hits.end(), std::mt19937{ 42 });
+
+        struct
+        {
+            char const* name;
+            result value;
+        }
+        const results[]
+        {
+            { "std::map", measure<std::map<K, int32_t>>(hits, misses, work) },
+            { "std::unordered_map", measure<std::unordered_map<K, int32_t>>(hits, misses, work) },
+            { "flat_map", measure<winrt::flat_map<K, int32_t>>(hits, misses, work) },
+            { "flat_hash_map", measure<winrt::flat_hash_map<K, int32_t>>(hits, misses, work) },
+        };
+
+        for (auto&& test : results)
+        {
+            printf("%-6s %5d items %-18s Lookup %6.1f ns  HasKey (miss) %6.1f ns  iterate %5.2f ns/item\n",
+                label, size, test.name, test.value.lookup, test.value.has_key, test.value.iterate);
+        }
+    }
+}
+
+int main(int const argc, char** argv)
+{
+    // The amount of work is the number of lookups made in each test.
+
+    uint64_t const work = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10'000'000;
+
+    measure_all<int32_t>("int", work);
+    measure_all<std::string>("string", work);
+}
@@ -0,0 +1,268 @@
+#include <winrt/Windows.Foundation.Collections.h>
+#include "bench.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Measures how calls on multi_threaded_vector and multi_threaded_map scale from 1 to 64 threads, through the
+// projected IVector and IMap. Each row compares GetAt and Lookup on a single_threaded collection that the
+// threads share by holding an exclusive lock around every call (what callers do without the multi_threaded
+// collections) with the same calls on a multi_threaded collection, which reads a vector of int32_t without
+// a lock and a map under a shared lock. The last columns repeat GetAt while another thread calls SetAt. A
+// second table counts how many changes a writer makes while other threads loop over a snapshot of the vector.
+
+using namespace winrt;
+using namespace Windows::Foundation::Collections;
+
+static constexpr uint32_t size{ 1024 };
+
+static std::vector<int32_t> make_vector()
+{
+    std::vector<int32_t> values(size);
+
+    for (uint32_t index = 0; index != size; ++index)
+    {
+        values[index] = index;
+    }
+
+    return values;
+}
+
+static flat_hash_map<int32_t, int32_t> make_map()
+{
+    flat_hash_map<int32_t, int32_t> values;
+
+    for (uint32_t index = 0; index != size; ++index)
+    {
+        values.insert_or_assign(index, index);
+    }
+
+    return values;
+}
+
+template <typename Reader, typename Writer>
+static double measure(uint32_t const threads, uint64_t const work, Reader reader, Writer writer)
+{
+    std::atomic<uint32_t> ready{};
+    std::atomic<bool> go{};
+    std::atomic<bool> done{};
+    std::vector<std::thread> readers;
+
+    for (uint32_t thread = 0; thread != threads; ++thread)
+    {
+        readers.emplace_back([&, thread]
+        {
+            ++ready;
+
+            while (!go)
+            {
+                std::this_thread::yield();
+            }
+
+            int64_t const sum = reader(thread, work);
+
+            if (sum < 0)
+            {
+                std::abort();
+            }
+        });
+    }
+
+    std::thread writing([&]
+    {
+        while (!go)
+        {
+            std::this_thread::yield();
+        }
+
+        while (!done)
+        {
+            writer();
+        }
+    });
+
+    while (ready != threads)
+    {
+        std::this_thread::yield();
+    }
+
+    auto const start = clock_type::now();
+    go = true;
+
+    for (auto&& thread : readers)
+    {
+        thread.join();
+    }
+
+    double const result = threads * work * 1000.0 / elapsed_ns(start);
+    done = true;
+    writing.join();
+    return result;
+}
+
+template <typename Reader>
+static double measure(uint32_t const threads, uint64_t const work, Reader reader)
+{
+    return measure(threads, work, reader, [] { std::this_thread::sleep_for(std::chrono::milliseconds(1)); });
+}
+
+static int64_t get_exclusive(IVector<int32_t> const& vector, std::mutex& lock, uint32_t const thread, uint64_t const work)
+{
+    int64_t sum{};
+
+    for (uint64_t read = 0; read != work; ++read)
+    {
+        std::lock_guard<std::mutex> const guard(lock);
+        sum += vector.GetAt((read + thread) % size);
+    }
+
+    return sum;
+}
+
+static int64_t get(IVector<int32_t> const& vector, uint32_t const thread, uint64_t const work)
+{
+    int64_t sum{};
+
+    for (uint64_t read = 0; read != work; ++read)
+    {
+        sum += vector.GetAt((read + thread) % size);
+    }
+
+    return sum;
+}
+
+int main(int const argc, char** argv)
+{
+    // The amount of work is the number of calls made by each thread in each test.
+
+    uint64_t const work = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+
+    printf("calls per microsecond across all threads (%u hardware threads)\n", std::thread::hardware_concurrency());
+    printf("threads  GetAt: exclusive  multi_threaded   Size  Lookup: exclusive  multi_threaded  | with SetAt, GetAt: exclusive  multi_threaded\n");
+
+    for (uint32_t threads : { 1, 2, 4, 8, 16, 32, 64 })
+    {
+        IVector<int32_t> const single = single_threaded_vector(make_vector());
+        IVector<int32_t> const multi = multi_threaded_vector(make_vector());
+        IMap<int32_t, int32_t> const single_map = single_threaded_map(make_map());
+        IMap<int32_t, int32_t> const multi_map = multi_threaded_map(make_map());
+        std::mutex lock;
+
+        double const exclusive = measure(threads, work, [&](uint32_t const thread, uint64_t const calls)
+        {
+            return get_exclusive(single, lock, thread, calls);
+        });
+
+        double const multi_threaded = measure(threads, work, [&](uint32_t const thread, uint64_t const calls)
+        {
+            return get(multi, thread, calls);
+        });
+
+        double const size_only = measure(threads, work, [&](uint32_t, uint64_t const calls)
+        {
+            int64_t sum{};
+
+            for (uint64_t call = 0; call != calls; ++call)
+            {
+                sum += multi.Size();
+            }
+
+            return sum;
+        });
+
+        double const lookup_exclusive = measure(threads, work, [&](uint32_t const thread, uint64_t const calls)
+        {
+            int64_t sum{};
+
+            for (uint64_t call = 0; call != calls; ++call)
+            {
+                std::lock_guard<std::mutex> const guard(lock);
+                sum += single_map.Lookup(static_cast<int32_t>((call + thread) % size));
+            }
+
+            return sum;
+        });
+
+        double const lookup_multi_threaded = measure(threads, work, [&](uint32_t const thread, uint64_t const calls)
+        {
+            int64_t sum{};
+
+            for (uint64_t call = 0; call != calls; ++call)
+            {
+                sum += multi_map.Lookup(static_cast<int32_t>((call + thread) % size));
+            }
+
+            return sum;
+        });
+
+        // The writer sets one element at a time to the value it already has.
+
+        uint32_t next{};
+
+        double const exclusive_writer = measure(threads, work, [&](uint32_t const thread, uint64_t const calls)
+        {
+            return get_exclusive(single, lock, thread, calls);
+        },
+        [&]
+        {
+            uint32_t const index = next++ % size;
+            std::lock_guard<std::mutex> const guard(lock);
+            single.SetAt(index, index);
+        });
+
+        double const multi_threaded_writer = measure(threads, work, [&](uint32_t const thread, uint64_t const calls)
+        {
+            return get(multi, thread, calls);
+        },
+        [&]
+        {
+            uint32_t const index = next++ % size;
+            multi.SetAt(index, index);
+        });
+
+        printf("%7u  %16.1f %15.1f %6.0f  %17.1f %15.1f  | %28.1f %15.1f\n",
+            threads, exclusive, multi_threaded, size_only, lookup_exclusive, lookup_multi_threaded, exclusive_writer, multi_threaded_writer);
+    }
+
+    // Every reader loops over the whole vector in each pass, which walks a snapshot of it, while a writer
+    // appends and removes an element. The writer only waits for the moment it takes to copy the snapshot
+    // pointer.
+
+    printf("\nthreads  iterating snapshots: passes per ms  writes per ms\n");
+
+    for (uint32_t threads : { 1, 2, 4, 8, 16, 32, 64 })
+    {
+        IVector<int32_t> const vector = multi_threaded_vector(make_vector());
+        IIterable<int32_t> const iterable = vector;
+        uint64_t const passes = (std::max)(work / size, uint64_t{ 1 });
+        std::atomic<uint64_t> writes{};
+
+        auto const start = clock_type::now();
+
+        double const iterate = measure(threads, passes, [&](uint32_t, uint64_t const count)
+        {
+            int64_t sum{};
+
+            for (uint64_t pass = 0; pass != count; ++pass)
+            {
+                for (int32_t value : batched(iterable))
+                {
+                    sum += value;
+                }
+            }
+
+            return sum;
+        },
+        [&]
+        {
+            vector.Append(0);
+            vector.RemoveAtEnd();
+            writes += 2;
+        });
+
+        printf("%7u  %34.1f %14.1f\n", threads, iterate * 1000, writes * 1'000'000.0 / elapsed_ns(start));
+    }
+}
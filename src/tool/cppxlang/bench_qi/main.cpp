@@ -0,0 +1,160 @@
+#include <winrt/base.h>
+#include "bench.h"
+#include <cstdio>
+#include <cstdlib>
+
+// Measures QueryInterface on an object implementing 32 interfaces, as XAML classes and observable
+// collections do. The IID table that implements<> builds is compared against a linear scan of the same
+// interfaces, for the first, middle and last interface and for an IID the object does not implement.
+//
+// The interfaces are empty "Bench.IWidgetN" interfaces written out in the shape cppxlang generates.
+
+#define BENCH_INTERFACES(X) \
+    X(0) X(1) X(2) X(3) X(4) X(5) X(6) X(7) X(8) X(9) X(10) X(11) X(12) X(13) X(14) X(15) \
+    X(16) X(17) X(18) X(19) X(20) X(21) X(22) X(23) X(24) X(25) X(26) X(27) X(28) X(29) X(30) X(31)
+
+#define BENCH_FORWARD(n) struct IWidget##n;
+
+#define BENCH_ABI(n) \
+    template <> struct category<Bench::IWidget##n> \
+    { \
+        using type = interface_category; \
+    }; \
+    template <> struct name<Bench::IWidget##n> \
+    { \
+        static constexpr auto & value{ L"Bench.IWidget" #n }; \
+    }; \
+    template <> struct guid_storage<Bench::IWidget##n> \
+    { \
+        static constexpr guid value{ 0x6A37D1A2u ^ (n * 0x2545F491u), 0x0C5B, 0x4E4B, { 0x9B,0x3E,0x5D,0x1F,0x2A,0x40,0x71,n } }; \
+    }; \
+    template <> struct abi<Bench::IWidget##n> \
+    { \
+        struct WINRT_NOVTABLE type : inspectable_abi \
+        { \
+        }; \
+    }; \
+    template <typename D> \
+    struct consume_Bench_IWidget##n \
+    { \
+    }; \
+    template <> struct consume<Bench::IWidget##n> \
+    { \
+        template <typename D> using type = consume_Bench_IWidget##n<D>; \
+    }; \
+    template <typename D> \
+    struct produce<D, Bench::IWidget##n> : produce_base<D, Bench::IWidget##n> \
+    { \
+    };
+
+#define BENCH_TYPE(n) \
+    struct WINRT_EBO IWidget##n : \
+        Windows::Foundation::IInspectable, \
+        impl::consume_t<IWidget##n> \
+    { \
+        IWidget##n(std::nullptr_t = nullptr) noexcept {} \
+    };
+
+#define BENCH_LIST(n) , Bench::IWidget##n
+
+WINRT_EXPORT namespace winrt::Bench
+{
+    BENCH_INTERFACES(BENCH_FORWARD)
+}
+
+WINRT_EXPORT namespace winrt::impl
+{
+    BENCH_INTERFACES(BENCH_ABI)
+}
+
+WINRT_EXPORT namespace winrt::Bench
+{
+    BENCH_INTERFACES(BENCH_TYPE)
+}
+
+namespace winrt::Bench::implementation
+{
+    struct Widget : implements<Widget BENCH_INTERFACES(BENCH_LIST)>
+    {
+    };
+}
+
+template <typename Find>
+static double measure(winrt::guid const& iid, bool const expected, uint64_t const iterations, Find find)
+{
+    auto const start = clock_type::now();
+    uint64_t found{};
+
+    for (uint64_t i = 0; i < iterations; ++i)
+    {
+        found += find(iid) != nullptr;
+    }
+
+    auto const elapsed = elapsed_ns(start);
+
+    if (found != (expected ? iterations : 0))
+    {
+        std::abort();
+    }
+
+    return elapsed / iterations;
+}
+
+int main(int const argc, char** argv)
+{
+    using namespace winrt;
+    using widget = Bench::implementation::Widget;
+
+    uint64_t const iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100'000'000;
+    com_ptr<widget> const self = make_self<widget>();
+    Windows::Foundation::IInspectable const object = self.as<Windows::Foundation::IInspectable>();
+
+    // The scan is what find_iid did before the table: one IID comparison per implemented interface.
+
+    auto table = [&](guid const& iid)
+    {
+        return impl::find_iid(self.get(), iid);
+    };
+
+    auto scan = [&](guid const& iid)
+    {
+        return impl::implemented_interfaces<widget>::find(self.get(), impl::iid_finder{ iid });
+    };
+
+    auto query = [&](guid const& iid)
+    {
+        void* result{};
+
+        if (0 == static_cast<impl::unknown_abi*>(get_abi(object))->QueryInterface(iid, &result))
+        {
+            static_cast<impl::unknown_abi*>(result)->Release();
+        }
+
+        return result;
+    };
+
+    guid const missing{ 0x12345678, 0x1234, 0x1234, { 1, 2, 3, 4, 5, 6, 7, 8 } };
+
+    struct
+    {
+        char const* label;
+        guid const& iid;
+        bool expected;
+    }
+    const cases[]
+    {
+        { "first", guid_of<Bench::IWidget0>(), true },
+        { "middle", guid_of<Bench::IWidget15>(), true },
+        { "last", guid_of<Bench::IWidget31>(), true },
+        { "missing", missing, false },
+    };
+
+    for (auto&& test : cases)
+    {
+        printf("%-8s table %6.2f ns  scan %6.2f ns  QueryInterface %6.2f ns\n",
+            test.label,
+            measure(test.iid, test.expected, iterations, table),
+            measure(test.iid, test.expected, iterations, scan),
+            measure(test.iid, test.expected, iterations, query));
+    }
+}
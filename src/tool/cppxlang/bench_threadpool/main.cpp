@@ -0,0 +1,106 @@
+#include <winrt/coroutine.h>
+#include "bench.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <future>
+#include <thread>
+#include <vector>
+
+// Measures the thread pool behind resume_background: callbacks submitted from one and from several threads
+// outside the pool, and coroutines that keep moving to another worker, which submit from inside the pool.
+// Times are per callback.
+
+struct countdown
+{
+    std::atomic<uint64_t> remaining;
+    std::promise<void> done;
+
+    explicit countdown(uint64_t const count) : remaining(count)
+    {
+    }
+
+    void signal()
+    {
+        if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            done.set_value();
+        }
+    }
+};
+
+static void WINRT_CALL callback(void*, void* context) noexcept
+{
+    static_cast<countdown*>(context)->signal();
+}
+
+static double submit(uint32_t const threads, uint64_t const count)
+{
+    countdown remaining{ count };
+    std::vector<std::thread> submitters;
+    auto const start = clock_type::now();
+
+    for (uint32_t thread = 0; thread != threads; ++thread)
+    {
+        submitters.emplace_back([&, thread]
+        {
+            for (uint64_t i = thread; i < count; i += threads)
+            {
+                winrt::impl::submit_threadpool_callback(callback, &remaining);
+            }
+        });
+    }
+
+    for (auto&& submitter : submitters)
+    {
+        submitter.join();
+    }
+
+    remaining.done.get_future().wait();
+    return elapsed_ns(start) / count;
+}
+
+static winrt::fire_and_forget hop(uint64_t const hops, countdown& remaining)
+{
+    for (uint64_t i = 0; i != hops; ++i)
+    {
+        co_await winrt::resume_background();
+        remaining.signal();
+    }
+}
+
+static double chains(uint32_t const count, uint64_t const hops)
+{
+    countdown remaining{ count * hops };
+    auto const start = clock_type::now();
+
+    for (uint32_t chain = 0; chain != count; ++chain)
+    {
+        hop(hops, remaining);
+    }
+
+    remaining.done.get_future().wait();
+    return elapsed_ns(start) / (count * hops);
+}
+
+int main(int const argc, char** argv)
+{
+    // The amount of work is the number of callbacks each measurement runs.
+
+    uint64_t const work = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2'000'000;
+    uint32_t const cores = (std::max)(std::thread::hardware_concurrency(), 1u);
+
+    // The first submission starts the pool, which is left out of the measurements.
+
+    submit(1, 1);
+
+    for (uint32_t threads : { 1u, 2u, 4u, 8u })
+    {
+        printf("submit from %u thread%s %8.1f ns\n", threads, threads == 1 ? ": " : "s:", submit(threads, work));
+    }
+
+    for (uint32_t count : { 1u, cores, cores * 4 })
+    {
+        printf("%4u resume_background chain%s %8.1f ns\n", count, count == 1 ? ": " : "s:", chains(count, work / count));
+    }
+}
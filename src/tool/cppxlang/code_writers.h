@@ -82,6 +82,11 @@ namespace xlang
         if (found != c.namespaces().end() && has_projected_types(found->second))
         {
             w.write_root_include(parent);
+
+            if (settings.fanout)
+            {
+                settings.fanout->add(w.type_namespace, 0, parent, 0, 0);
+            }
         }
         else
         {
@@ -100,9 +105,27 @@ namespace xlang
         }
     }
 
+    static void write_module_fragment(writer& w)
+    {
+        // The standard library is included in the global module fragment so that it isn't attached to
+        // the module when the headers include it again.
+
+        w.write(R"(module;
+)");
+
+        w.write(strings::base_dependencies);
+
+        w.write(R"(
+#if __has_include(<WindowsNumerics.impl.h>)
+#include <directxmath.h>
+#endif
+
+)");
+    }
+
     static void write_impl_namespace(writer& w)
     {
-        auto format = R"(namespace winrt::impl
+        auto format = R"(WINRT_EXPORT namespace winrt::impl
 {
 )";
 
@@ -118,7 +141,7 @@ namespace xlang
 
     static void write_type_namespace(writer& w, std::string_view const& ns)
     {
-        auto format = R"(namespace winrt::@
+        auto format = R"(WINRT_EXPORT namespace winrt::@
 {
 )";
 
@@ -255,18 +278,26 @@ namespace xlang
     {
         using std::get;
 
-        w.write_printf("0x%08X,0x%04X,0x%04X,{ 0x%02X,0x%02X,0x%02X,0x%02X,0x%02X,0x%02X,0x%02X,0x%02X }",
-            get<uint32_t>(get<ElemSig>(args[0].value).value),
-            get<uint16_t>(get<ElemSig>(args[1].value).value),
-            get<uint16_t>(get<ElemSig>(args[2].value).value),
-            get<uint8_t>(get<ElemSig>(args[3].value).value),
-            get<uint8_t>(get<ElemSig>(args[4].value).value),
-            get<uint8_t>(get<ElemSig>(args[5].value).value),
-            get<uint8_t>(get<ElemSig>(args[6].value).value),
-            get<uint8_t>(get<ElemSig>(args[7].value).value),
-            get<uint8_t>(get<ElemSig>(args[8].value).value),
-            get<uint8_t>(get<ElemSig>(args[9].value).value),
-            get<uint8_t>(get<ElemSig>(args[10].value).value));
+        w.write("0x");
+        w.write_hex(get<uint32_t>(get<ElemSig>(args[0].value).value), 8, true);
+        w.write(",0x");
+        w.write_hex(get<uint16_t>(get<ElemSig>(args[1].value).value), 4, true);
+        w.write(",0x");
+        w.write_hex(get<uint16_t>(get<ElemSig>(args[2].value).value), 4, true);
+        w.write(",{ ");
+
+        for (size_t i = 3; i != 11; ++i)
+        {
+            if (i != 3)
+            {
+                w.write(',');
+            }
+
+            w.write("0x");
+            w.write_hex(get<uint8_t>(get<ElemSig>(args[i].value).value), 2, true);
+        }
+
+        w.write(" }");
     }
 
     static void write_category(writer& w, TypeDef const& type, std::string_view const& category)
@@ -395,6 +426,96 @@ namespace xlang
         }
     }
 
+    static void write_pinterface_guid_value(writer& w, std::array<uint8_t, 16> const& guid)
+    {
+        w.write("0x");
+        w.write_hex(static_cast<uint32_t>(guid[0]) << 24 | static_cast<uint32_t>(guid[1]) << 16 | static_cast<uint32_t>(guid[2]) << 8 | guid[3], 8, true);
+        w.write(",0x");
+        w.write_hex(static_cast<uint16_t>(guid[4] << 8 | guid[5]), 4, true);
+        w.write(",0x");
+        w.write_hex(static_cast<uint16_t>(guid[6] << 8 | guid[7]), 4, true);
+        w.write(",{ ");
+
+        for (size_t i = 8; i != 16; ++i)
+        {
+            if (i != 8)
+            {
+                w.write(',');
+            }
+
+            w.write("0x");
+            w.write_hex(guid[i], 2, true);
+        }
+
+        w.write(" }");
+    }
+
+    static void write_pinterface_guid_macro(writer& w, std::array<uint8_t, 16> const& guid)
+    {
+        for (auto&& byte : guid)
+        {
+            w.write_hex(byte, 2, true);
+        }
+    }
+
+    static void write_pinterface_guids(writer& w, cache const& c, cache::namespace_members const& members)
+    {
+        // The IIDs of generic instances are otherwise hashed by the compiler in every translation unit that
+        // uses them, so they are written out as values that pinterface_guid looks up before hashing. Each
+        // instance is written next to the generic type it instantiates, since no translation unit can name
+        // the instance, and so look up its value, before that header declares the generic type. The
+        // instances are therefore collected from every namespace, and each value is guarded in case more
+        // than one projection writes it.
+
+        if (!settings.guids)
+        {
+            return;
+        }
+
+        auto const is_generic = [](TypeDef const& type) { return !empty(type.GenericParam()); };
+
+        if (std::none_of(members.interfaces.begin(), members.interfaces.end(), is_generic) &&
+            std::none_of(members.delegates.begin(), members.delegates.end(), is_generic))
+        {
+            return;
+        }
+
+        pinterface_collector collector{ w, w.type_namespace };
+
+        for (auto&&[ns, other] : c.namespaces())
+        {
+            if (!has_projected_types(other))
+            {
+                continue;
+            }
+
+            for (auto types : { &other.interfaces, &other.classes, &other.structs, &other.delegates })
+            {
+                for (auto&& type : *types)
+                {
+                    collector.add(type);
+                }
+            }
+        }
+
+        for (auto&&[name, signature] : collector.instances())
+        {
+            auto format = R"(#ifndef WINRT_GUID_%
+#define WINRT_GUID_%
+    template <> inline constexpr std::optional<guid> generated_pinterface_guid<%>{ guid{ % } };
+#endif
+)";
+
+            auto const guid = get_pinterface_guid(signature);
+
+            w.write(format,
+                bind<write_pinterface_guid_macro>(guid),
+                bind<write_pinterface_guid_macro>(guid),
+                name,
+                bind<write_pinterface_guid_value>(guid));
+        }
+    }
+
     static void write_default_interface(writer& w, TypeDef const& type)
     {
         if (auto default_interface = get_default_interface(type))
@@ -2752,6 +2873,7 @@ struct WINRT_EBO produce_dispatch_to_overridable<T, D, %>
         {
             w.write(strings::base_collections);
             w.write(strings::base_collections_base);
+            w.write(strings::base_collections_multi_threaded);
             w.write(strings::base_collections_input_iterable);
             w.write(strings::base_collections_input_vector_view);
             w.write(strings::base_collections_input_map_view);
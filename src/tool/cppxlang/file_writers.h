@@ -10,12 +10,14 @@ namespace xlang
 
         w.write(strings::base_dependencies);
         w.write(strings::base_macros);
+        w.write(strings::base_numerics);
         w.write(strings::base_types);
         w.write(strings::base_extern);
         w.write(strings::base_meta);
         w.write(strings::base_identity);
         w.write(strings::base_handle);
         w.write(strings::base_lock);
+        w.write(strings::base_pool);
         w.write(strings::base_abi);
         w.write(strings::base_windows);
         w.write(strings::base_com_ptr);
@@ -36,6 +38,8 @@ namespace xlang
         w.write(strings::base_chrono);
         w.write(strings::base_security);
         w.write(strings::base_std_hash);
+        w.write(strings::base_collections_flat_map);
+        w.write(strings::base_collections_concurrent);
         w.write(strings::base_reflect);
         w.write(strings::base_natvis);
         w.write(strings::base_version, XLANG_VERSION_STRING);
@@ -58,6 +62,7 @@ namespace xlang
 )");
 
         w.write(strings::base_coroutine);
+        w.write(strings::base_coroutine_threadpool);
         w.write(strings::base_coroutine_resume);
         w.write(strings::base_coroutine_action);
         w.write(strings::base_coroutine_action_with_progress);
@@ -69,7 +74,66 @@ namespace xlang
         w.flush_to_file(settings.output_folder + "winrt/coroutine.h");
     }
 
-    static void write_namespace_0_h(std::string_view const& ns, cache::namespace_members const& members)
+    static void write_base_module()
+    {
+        writer w;
+        write_preamble(w);
+        write_module_fragment(w);
+
+        w.write(R"(export module winrt.base;
+#define WINRT_EXPORT export
+)");
+
+        w.write_root_include("base");
+        w.flush_to_file(settings.output_folder + "winrt/winrt.base.ixx");
+    }
+
+    static void write_projection_module(cache const& c)
+    {
+        // The namespace headers forward declare the types of the namespaces they depend on, so the same
+        // declarations appear in several headers and all of the namespaces must be attached to a single
+        // module. The runtime comes from the base module, and only its macros are redefined here.
+
+        std::vector<std::string_view> namespaces;
+
+        for (auto&&[ns, members] : c.namespaces())
+        {
+            if (has_projected_types(members) && settings.projection_filter.includes(members))
+            {
+                namespaces.push_back(ns);
+            }
+        }
+
+        if (namespaces.empty())
+        {
+            return;
+        }
+
+        writer w;
+        write_preamble(w);
+        write_module_fragment(w);
+
+        w.write(R"(export module winrt;
+export import winrt.base;
+#define WINRT_EXPORT export
+#define WINRT_BASE_H
+)");
+
+        w.write(strings::base_macros);
+        w.write(R"(
+#define CPPWINRT_VERSION "%"
+
+)", XLANG_VERSION_STRING);
+
+        for (auto&& ns : namespaces)
+        {
+            w.write_root_include(ns);
+        }
+
+        w.flush_to_file(settings.output_folder + "winrt/winrt.ixx");
+    }
+
+    static void write_namespace_0_h(std::string_view const& ns, cache::namespace_members const& members, cache const& c)
     {
         writer w;
         w.type_namespace = ns;
@@ -95,6 +159,7 @@ namespace xlang
         w.write_each<write_name>(members.delegates);
         w.write_each<write_guid>(members.interfaces);
         w.write_each<write_guid>(members.delegates);
+        write_pinterface_guids(w, c, members);
         w.write_each<write_default_interface>(members.classes);
         w.write_each<write_interface_abi>(members.interfaces);
         w.write_each<write_delegate_abi>(members.delegates);
@@ -117,6 +182,60 @@ namespace xlang
         w.save_header('0');
     }
 
+    static char get_include_level(TypeDef const& type, char header)
+    {
+        // Each impl header holds progressively more of a namespace: .0.h forward declares every type and
+        // fully defines enums, .1.h defines interfaces, and .2.h defines structs, delegates, and classes.
+        // Interface declarations (.1.h) only refer to other types by name. Class declarations (.2.h) derive
+        // from their default interface and embed struct fields, while the namespace header's definitions
+        // need every type they use to be complete.
+
+        if (header == '1')
+        {
+            return '0';
+        }
+
+        switch (get_category(type))
+        {
+        case category::enum_type:
+            return '0';
+        case category::interface_type:
+            return '1';
+        case category::struct_type:
+            return '2';
+        default:
+            return header == '2' ? '0' : '2';
+        }
+    }
+
+    static void write_namespace_depends(writer& w, char header, char previous)
+    {
+        for (auto&& [ns, types] : w.depends)
+        {
+            char level = '0';
+
+            for (auto&& type : types)
+            {
+                level = std::max(level, get_include_level(type, header));
+            }
+
+            w.write_depends(ns, level);
+
+            if (settings.fanout)
+            {
+                settings.fanout->add(w.type_namespace, header, ns, level, previous);
+            }
+        }
+
+        char const self = header ? header - 1 : '2';
+        w.write_depends(w.type_namespace, self);
+
+        if (settings.fanout)
+        {
+            settings.fanout->add(w.type_namespace, header, w.type_namespace, self, self);
+        }
+    }
+
     static void write_namespace_1_h(std::string_view const& ns, cache::namespace_members const& members)
     {
         writer w;
@@ -131,12 +250,7 @@ namespace xlang
         write_preamble(w);
         write_open_file_guard(w, ns, '1');
 
-        for (auto&& depends : w.depends)
-        {
-            w.write_depends(depends.first, '0');
-        }
-
-        w.write_depends(w.type_namespace, '0');
+        write_namespace_depends(w, '1', '0');
         w.save_header('1');
     }
 
@@ -158,14 +272,7 @@ namespace xlang
         write_preamble(w);
         write_open_file_guard(w, ns, '2');
 
-        char const impl = promote ? '2' : '1';
-
-        for (auto&& depends : w.depends)
-        {
-            w.write_depends(depends.first, impl);
-        }
-
-        w.write_depends(w.type_namespace, '1');
+        write_namespace_depends(w, '2', promote ? '2' : '1');
         w.save_header('2');
     }
 
@@ -199,12 +306,7 @@ namespace xlang
         write_version_assert(w);
         write_parent_depends(w, c, ns);
 
-        for (auto&& depends : w.depends)
-        {
-            w.write_depends(depends.first, '2');
-        }
-
-        w.write_depends(w.type_namespace, '2');
+        write_namespace_depends(w, 0, '2');
         w.save_header();
     }
 
@@ -233,9 +335,6 @@ namespace xlang
         }
 
         auto filename = settings.output_folder + get_generated_component_filename(type) + ".g.h";
-        path folder = filename;
-        folder.remove_filename();
-        create_directories(folder);
         w.flush_to_file(filename);
     }
 
@@ -251,9 +350,6 @@ namespace xlang
         write_component_g_cpp(w, type);
 
         auto filename = settings.output_folder + get_generated_component_filename(type) + ".g.cpp";
-        path folder = filename;
-        folder.remove_filename();
-        create_directories(folder);
         w.flush_to_file(filename);
     }
 
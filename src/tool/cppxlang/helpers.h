@@ -192,6 +192,69 @@ namespace xlang
         return async;
     }
 
+    template <typename Key, typename Value>
+    struct memoized
+    {
+        // A thread-safe, per-run cache of values derived from metadata. Values are never evicted, so the
+        // references handed out remain valid for the duration of the run. Should two threads race to
+        // compute the same value, the first one stored wins and the other is discarded.
+
+        memoized(memoized const&) = delete;
+        memoized& operator=(memoized const&) = delete;
+        memoized() = default;
+
+        template <typename F>
+        Value const& get(Key const& key, F&& compute)
+        {
+            {
+                std::shared_lock<std::shared_mutex> guard{ m_lock };
+                auto found = m_values.find(key);
+
+                if (found != m_values.end())
+                {
+                    return found->second;
+                }
+            }
+
+            auto value = compute();
+            std::unique_lock<std::shared_mutex> guard{ m_lock };
+            return m_values.emplace(key, std::move(value)).first->second;
+        }
+
+    private:
+
+        std::shared_mutex m_lock;
+        std::map<Key, Value> m_values;
+    };
+
+    template <typename T>
+    struct resolved
+    {
+        // Writing type names records dependencies on the writer, so the dependencies discovered while
+        // resolving a value are kept alongside it and replayed on every writer that uses it.
+
+        T value;
+        std::vector<TypeDef> depends;
+
+        explicit resolved(writer const& w)
+        {
+            for (auto&&[ns, types] : w.depends)
+            {
+                depends.insert(depends.end(), types.begin(), types.end());
+            }
+        }
+
+        T const& get(writer& w) const
+        {
+            for (auto&& type : depends)
+            {
+                w.add_depends(type);
+            }
+
+            return value;
+        }
+    };
+
     static TypeDef get_base_class(TypeDef const& derived)
     {
         auto extends = derived.Extends();
@@ -214,16 +277,21 @@ namespace xlang
     };
 
 
-    static auto get_bases(TypeDef const& type)
+    static auto const& get_bases(TypeDef const& type)
     {
-        std::vector<TypeDef> bases;
+        static memoized<TypeDef, std::vector<TypeDef>> cache;
 
-        for (auto base = get_base_class(type); base; base = get_base_class(base))
+        return cache.get(type, [&]
         {
-            bases.push_back(base);
-        }
+            std::vector<TypeDef> bases;
+
+            for (auto base = get_base_class(type); base; base = get_base_class(base))
+            {
+                bases.push_back(base);
+            }
 
-        return bases;
+            return bases;
+        });
     }
 
     struct interface_info
@@ -309,17 +377,68 @@ namespace xlang
         }
     };
 
-    static auto get_interfaces(writer& w, TypeDef const& type)
+    static void init_resolution_writer(writer& result, writer const& w)
     {
-        std::map<std::string, interface_info> result;
-        get_interfaces_impl(w, result, false, false, false, {}, type.InterfaceImpl());
+        // Interface and factory names only depend on the writer's type modes and the innermost generic
+        // arguments. Resolving them on a writer without a namespace records every dependency.
 
-        for (auto&& base : get_bases(type))
+        result.abi_types = w.abi_types;
+        result.consume_types = w.consume_types;
+        result.async_types = w.async_types;
+
+        if (!w.generic_param_stack.empty())
         {
-            get_interfaces_impl(w, result, false, false, true, {}, base.InterfaceImpl());
+            result.generic_param_stack.push_back(w.generic_param_stack.back());
         }
+    }
 
-        return result;
+    struct resolution_key
+    {
+        TypeDef type;
+        bool abi_types{};
+        bool consume_types{};
+        bool async_types{};
+        std::vector<std::string> generic_params;
+
+        resolution_key(writer const& w, TypeDef const& type) :
+            type(type),
+            abi_types(w.abi_types),
+            consume_types(w.consume_types),
+            async_types(w.async_types)
+        {
+            if (!w.generic_param_stack.empty())
+            {
+                generic_params = w.generic_param_stack.back();
+            }
+        }
+
+        bool operator<(resolution_key const& other) const
+        {
+            return std::tie(type, abi_types, consume_types, async_types, generic_params) <
+                std::tie(other.type, other.abi_types, other.consume_types, other.async_types, other.generic_params);
+        }
+    };
+
+    static auto const& get_interfaces(writer& w, TypeDef const& type)
+    {
+        static memoized<resolution_key, resolved<std::map<std::string, interface_info>>> cache;
+
+        return cache.get({ w, type }, [&]
+        {
+            writer scratch;
+            init_resolution_writer(scratch, w);
+            std::map<std::string, interface_info> result;
+            get_interfaces_impl(scratch, result, false, false, false, {}, type.InterfaceImpl());
+
+            for (auto&& base : get_bases(type))
+            {
+                get_interfaces_impl(scratch, result, false, false, true, {}, base.InterfaceImpl());
+            }
+
+            resolved<std::map<std::string, interface_info>> value{ scratch };
+            value.value = std::move(result);
+            return value;
+        }).get(w);
     }
 
     struct factory_info
@@ -331,7 +450,7 @@ namespace xlang
         bool visible{};
     };
 
-    static auto get_factories(writer& w, TypeDef const& type)
+    static auto get_factories_impl(writer& w, TypeDef const& type)
     {
         auto get_system_type = [&](auto&& signature) -> TypeDef
         {
@@ -402,6 +521,21 @@ namespace xlang
         return result;
     }
 
+    static auto const& get_factories(writer& w, TypeDef const& type)
+    {
+        static memoized<resolution_key, resolved<std::map<std::string, factory_info>>> cache;
+
+        return cache.get({ w, type }, [&]
+        {
+            writer scratch;
+            init_resolution_writer(scratch, w);
+            auto result = get_factories_impl(scratch, type);
+            resolved<std::map<std::string, factory_info>> value{ scratch };
+            value.value = std::move(result);
+            return value;
+        }).get(w);
+    }
+
     static bool wrap_abi(TypeSig const& signature)
     {
         bool wrap{};
@@ -558,4 +692,256 @@ namespace xlang
             !members.structs.empty() ||
             !members.delegates.empty();
     }
+
+    static std::string get_guid_signature(TypeDef const& type)
+    {
+        using std::get;
+
+        auto attribute = get_attribute(type, "Windows.Foundation.Metadata", "GuidAttribute");
+
+        if (!attribute)
+        {
+            throw_invalid("'Windows.Foundation.Metadata.GuidAttribute' attribute for type '", type.TypeNamespace(), ".", type.TypeName(), "' not found");
+        }
+
+        auto const args = attribute.Value().FixedArgs();
+        auto byte = [&](size_t index) { return get<uint8_t>(get<ElemSig>(args[index].value).value); };
+        char buffer[40];
+
+        snprintf(buffer, sizeof(buffer), "{%08x-%04x-%04x-%02x%02x-%02x%02x%02x%02x%02x%02x}",
+            get<uint32_t>(get<ElemSig>(args[0].value).value),
+            get<uint16_t>(get<ElemSig>(args[1].value).value),
+            get<uint16_t>(get<ElemSig>(args[2].value).value),
+            byte(3), byte(4), byte(5), byte(6), byte(7), byte(8), byte(9), byte(10));
+
+        return buffer;
+    }
+
+    struct pinterface_collector
+    {
+        // Finds the closed instances of the generic interfaces and delegates that the given types refer to,
+        // along with the instances those require in turn, and builds the WinRT type signature that each
+        // instance's IID is derived from. Only the instances of generic types declared in generic_namespace
+        // are kept, and only their names are written with the writer. Signatures follow category_signature in
+        // base_identity.h, which remains the fallback for instances that only appear in user code.
+
+        pinterface_collector(writer& w, std::string_view const& generic_namespace) : w(w), m_generic_namespace(generic_namespace)
+        {
+        }
+
+        void add(TypeDef const& type)
+        {
+            if (!empty(type.GenericParam()))
+            {
+                return;
+            }
+
+            for (auto&& impl : type.InterfaceImpl())
+            {
+                signature(impl.Interface());
+            }
+
+            for (auto&& method : type.MethodList())
+            {
+                // A delegate's constructor takes a native function pointer, which has no signature.
+
+                if (get_category(type) == category::delegate_type && method.Name() != "Invoke")
+                {
+                    continue;
+                }
+
+                auto method_signature = method.Signature();
+
+                if (method_signature.ReturnType())
+                {
+                    signature(method_signature.ReturnType().Type().Type());
+                }
+
+                for (auto&& param : method_signature.Params())
+                {
+                    signature(param.Type().Type());
+                }
+            }
+
+            if (get_category(type) == category::struct_type)
+            {
+                for (auto&& field : type.FieldList())
+                {
+                    signature(field.Signature().Type().Type());
+                }
+            }
+        }
+
+        // Maps the projected name of each instance to its signature.
+
+        std::map<std::string, std::string> const& instances() const noexcept
+        {
+            return m_instances;
+        }
+
+    private:
+
+        // An empty signature means that the type refers to a generic parameter that is not bound.
+
+        std::string signature(TypeSig::value_type const& type)
+        {
+            std::string result;
+
+            call(type,
+                [&](ElementType type)
+                {
+                    switch (type)
+                    {
+                    case ElementType::Boolean: result = "b1"; break;
+                    case ElementType::Char: result = "c2"; break;
+                    case ElementType::I1: result = "i1"; break;
+                    case ElementType::U1: result = "u1"; break;
+                    case ElementType::I2: result = "i2"; break;
+                    case ElementType::U2: result = "u2"; break;
+                    case ElementType::I4: result = "i4"; break;
+                    case ElementType::U4: result = "u4"; break;
+                    case ElementType::I8: result = "i8"; break;
+                    case ElementType::U8: result = "u8"; break;
+                    case ElementType::R4: result = "f4"; break;
+                    case ElementType::R8: result = "f8"; break;
+                    case ElementType::String: result = "string"; break;
+                    case ElementType::Object: result = "cinterface(IInspectable)"; break;
+                    default: throw_invalid("Element type has no signature");
+                    }
+                },
+                [&](coded_index<TypeDefOrRef> const& type)
+                {
+                    result = signature(type);
+                },
+                [&](GenericTypeIndex var)
+                {
+                    if (!m_stack.empty())
+                    {
+                        result = m_stack.back()[var.index];
+                    }
+                },
+                [&](GenericTypeInstSig const& type)
+                {
+                    result = signature(type);
+                });
+
+            return result;
+        }
+
+        std::string signature(coded_index<TypeDefOrRef> const& type)
+        {
+            switch (type.type())
+            {
+            case TypeDefOrRef::TypeDef:
+                return signature(type.TypeDef());
+            case TypeDefOrRef::TypeRef:
+                if (type_name(type.TypeRef()) == "System.Guid")
+                {
+                    return "g16";
+                }
+
+                return signature(find_required(type.TypeRef()));
+            default:
+                return signature(type.TypeSpec().Signature().GenericTypeInst());
+            }
+        }
+
+        std::string signature(TypeDef const& type)
+        {
+            std::string result;
+            auto const full_name = [&] { return std::string{ type.TypeNamespace() } + "." + std::string{ type.TypeName() }; };
+
+            switch (get_category(type))
+            {
+            case category::enum_type:
+                return "enum(" + full_name() + ";" + signature(type.FieldList().first.Signature().Type().Type()) + ")";
+            case category::struct_type:
+                result = "struct(" + full_name();
+
+                for (auto&& field : type.FieldList())
+                {
+                    result += ";" + signature(field.Signature().Type().Type());
+                }
+
+                return result + ")";
+            case category::interface_type:
+                return get_guid_signature(type);
+            case category::delegate_type:
+                return "delegate(" + get_guid_signature(type) + ")";
+            default:
+                return "rc(" + full_name() + ";" + signature(get_default_interface(type)) + ")";
+            }
+        }
+
+        std::string signature(GenericTypeInstSig const& type)
+        {
+            std::vector<std::string> args;
+
+            for (auto&& arg : type.GenericArgs())
+            {
+                args.push_back(signature(arg.Type()));
+
+                if (args.back().empty())
+                {
+                    return {};
+                }
+            }
+
+            auto const generic_type = find_required(type.GenericType().TypeRef());
+            std::string result = "pinterface(" + get_guid_signature(generic_type);
+
+            for (auto&& arg : args)
+            {
+                result += ";" + arg;
+            }
+
+            result += ")";
+
+            if (m_visited.insert(result).second)
+            {
+                if (generic_type.TypeNamespace() == m_generic_namespace)
+                {
+                    m_instances.emplace(w.write_temp("%", type), result);
+                }
+
+                // Instances of the interfaces that this generic type requires, such as IIterable<T> for IVector<T>.
+
+                auto guard = w.push_generic_params(type);
+                m_stack.push_back(std::move(args));
+
+                for (auto&& impl : generic_type.InterfaceImpl())
+                {
+                    signature(impl.Interface());
+                }
+
+                m_stack.pop_back();
+            }
+
+            return result;
+        }
+
+        writer& w;
+        std::string_view const m_generic_namespace;
+        std::vector<std::vector<std::string>> m_stack;
+        std::set<std::string> m_visited;
+        std::map<std::string, std::string> m_instances;
+    };
+
+    static std::array<uint8_t, 16> get_pinterface_guid(std::string_view const& signature)
+    {
+        // The IID is a version 5 (SHA-1 name-based) GUID in the WinRT pinterface namespace.
+
+        static constexpr uint8_t namespace_guid[]{ 0x11, 0xf4, 0x7a, 0xd5, 0x7b, 0x73, 0x42, 0xc0, 0xab, 0xae, 0x87, 0x8b, 0x1e, 0x16, 0xad, 0xee };
+
+        sha1 hash;
+        hash.append(namespace_guid, sizeof(namespace_guid));
+        hash.append(signature);
+        auto const digest = hash.finalize();
+
+        std::array<uint8_t, 16> result;
+        std::copy_n(digest.begin(), result.size(), result.begin());
+        result[6] = (result[6] & 0x0F) | 0x50;
+        result[8] = (result[8] & 0x3F) | 0x80;
+        return result;
+    }
 }
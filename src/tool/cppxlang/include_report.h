@@ -0,0 +1,103 @@
+#pragma once
+
+namespace xlang
+{
+    struct include_report
+    {
+        include_report(include_report const&) = delete;
+        include_report& operator=(include_report const&) = delete;
+
+        explicit include_report(std::string filename) : m_filename(std::move(filename))
+        {
+        }
+
+        // Records that the given header of a namespace includes a header of another (or the same) namespace.
+        // The header is identified as in writer::write_depends: '0', '1' or '2' for the impl headers and
+        // zero for the namespace header itself. The previous level is what would have been included before
+        // includes were narrowed to the declarations each header actually needs.
+
+        void add(std::string_view const& ns, char header, std::string_view const& depends, char current, char previous)
+        {
+            std::lock_guard<std::mutex> guard{ m_lock };
+            m_edges[{ std::string{ ns }, header }].push_back({ std::string{ depends }, current, previous });
+        }
+
+        void save() const
+        {
+            std::lock_guard<std::mutex> guard{ m_lock };
+            std::string content = "previous current namespace\n";
+            uint64_t previous_total{};
+            uint64_t current_total{};
+            char buffer[64];
+
+            for (auto&&[node, edges] : m_edges)
+            {
+                if (node.second != 0)
+                {
+                    continue;
+                }
+
+                auto const previous = closure(node, &edge::previous);
+                auto const current = closure(node, &edge::current);
+                previous_total += previous;
+                current_total += current;
+
+                int const size = snprintf(buffer, sizeof(buffer), "%8llu %7llu ", static_cast<unsigned long long>(previous), static_cast<unsigned long long>(current));
+                content.append(buffer, size);
+                content += node.first;
+                content += '\n';
+            }
+
+            int const size = snprintf(buffer, sizeof(buffer), "%8llu %7llu total\n", static_cast<unsigned long long>(previous_total), static_cast<unsigned long long>(current_total));
+            content.append(buffer, size);
+
+            text::write_file(m_filename, { content.begin(), content.end() }, {});
+        }
+
+    private:
+
+        using node_type = std::pair<std::string, char>;
+
+        struct edge
+        {
+            std::string ns;
+            char current;
+            char previous;
+        };
+
+        // Counts the headers reachable from a namespace header, including itself.
+
+        uint64_t closure(node_type const& root, char edge::* level) const
+        {
+            std::set<node_type> visited{ root };
+            std::vector<node_type const*> pending{ &root };
+
+            while (!pending.empty())
+            {
+                auto found = m_edges.find(*pending.back());
+                pending.pop_back();
+
+                if (found == m_edges.end())
+                {
+                    continue;
+                }
+
+                for (auto&& target : found->second)
+                {
+                    auto[position, inserted] = visited.insert({ target.ns, target.*level });
+
+                    if (inserted)
+                    {
+                        pending.push_back(&*position);
+                    }
+                }
+            }
+
+            return visited.size();
+        }
+
+        std::string const m_filename;
+        mutable std::mutex m_lock;
+        std::map<node_type, std::vector<edge>> m_edges;
+    };
+}
@@ -0,0 +1,358 @@
+#pragma once
+
+namespace xlang
+{
+    inline std::string get_lean_name(std::string_view const& name)
+    {
+        // Accepts both the metadata and the C++ spelling of a name, with or without the winrt prefix.
+
+        std::string result;
+
+        for (size_t i = 0; i != name.size(); ++i)
+        {
+            if (name[i] == ':' && i + 1 != name.size() && name[i + 1] == ':')
+            {
+                result += '.';
+                ++i;
+            }
+            else
+            {
+                result += name[i];
+            }
+        }
+
+        if (starts_with(result, "winrt."))
+        {
+            result.erase(0, 6);
+        }
+
+        return result;
+    }
+
+    inline uint32_t get_lean_arity(std::string_view const& source, size_t pos)
+    {
+        // Counts the template arguments that follow a name, so that IVector<int> is recorded with the
+        // metadata name IVector`1. Nested brackets and parentheses are skipped, and zero is returned
+        // when the name is not followed by an argument list.
+
+        while (pos != source.size() && isspace(static_cast<unsigned char>(source[pos])))
+        {
+            ++pos;
+        }
+
+        if (pos == source.size() || source[pos] != '<')
+        {
+            return 0;
+        }
+
+        uint32_t arity{ 1 };
+        uint32_t depth{};
+
+        for (++pos; pos != source.size(); ++pos)
+        {
+            switch (source[pos])
+            {
+            case '<':
+            case '(':
+                ++depth;
+                break;
+            case ')':
+                --depth;
+                break;
+            case '>':
+                if (depth == 0)
+                {
+                    return arity;
+                }
+
+                --depth;
+                break;
+            case ',':
+                if (depth == 0)
+                {
+                    ++arity;
+                }
+                break;
+            case ';':
+            case '{':
+                return 0;
+            }
+        }
+
+        return 0;
+    }
+
+    inline std::vector<std::string> scan_lean_names(std::string_view const& source)
+    {
+        // Returns the metadata names of the winrt:: names used in the source. A name may continue past the
+        // type into a member, which add_lean_seed drops again.
+
+        std::vector<std::string> names;
+
+        auto is_identifier = [](char c)
+        {
+            return isalnum(static_cast<unsigned char>(c)) || c == '_';
+        };
+
+        for (auto pos = source.find("winrt::"); pos != std::string_view::npos; pos = source.find("winrt::", pos))
+        {
+            if (pos != 0 && is_identifier(source[pos - 1]))
+            {
+                pos += 7;
+                continue;
+            }
+
+            auto last = pos + 5;
+
+            while (source.compare(last, 2, "::") == 0 && last + 2 != source.size() && is_identifier(source[last + 2]))
+            {
+                last += 2;
+
+                while (last != source.size() && is_identifier(source[last]))
+                {
+                    ++last;
+                }
+            }
+
+            auto name = get_lean_name(source.substr(pos, last - pos));
+
+            if (auto const arity = get_lean_arity(source, last))
+            {
+                name += '`';
+                name += std::to_string(arity);
+            }
+
+            names.push_back(std::move(name));
+            pos = last;
+        }
+
+        return names;
+    }
+
+    inline bool add_lean_seed(cache const& c, std::string name, std::vector<TypeDef>& seeds)
+    {
+        // A namespace seeds all of its types. Names scanned from source may continue past the type into
+        // a member, so trailing segments are dropped until the name resolves. A generic type named
+        // without its arity seeds every type of that name.
+
+        while (true)
+        {
+            auto ns = c.namespaces().find(name);
+
+            if (ns != c.namespaces().end())
+            {
+                for (auto&&[type_name, type] : ns->second.types)
+                {
+                    seeds.push_back(type);
+                }
+
+                return true;
+            }
+
+            auto pos = name.rfind('.');
+
+            if (pos == std::string::npos)
+            {
+                return false;
+            }
+
+            std::string_view const type_namespace{ name.data(), pos };
+            std::string_view const type_name{ name.data() + pos + 1, name.size() - pos - 1 };
+
+            if (auto type = c.find(type_namespace, type_name))
+            {
+                seeds.push_back(type);
+                return true;
+            }
+
+            auto members = c.namespaces().find(type_namespace);
+
+            if (members != c.namespaces().end() && type_name.find('`') == std::string_view::npos)
+            {
+                std::string const prefix = std::string{ type_name } + '`';
+                bool found{};
+
+                for (auto type = members->second.types.lower_bound(prefix); type != members->second.types.end() && starts_with(type->first, prefix); ++type)
+                {
+                    seeds.push_back(type->second);
+                    found = true;
+                }
+
+                if (found)
+                {
+                    return true;
+                }
+            }
+
+            name.resize(pos);
+
+            if (auto const arity = name.rfind('`'); arity != std::string::npos && arity > name.rfind('.'))
+            {
+                name.resize(arity);
+            }
+        }
+    }
+
+    struct lean_closure
+    {
+        cache const& c;
+        std::set<TypeDef> types;
+        std::vector<TypeDef> pending;
+
+        void add(TypeDef const& type)
+        {
+            if (type && types.insert(type).second)
+            {
+                pending.push_back(type);
+            }
+        }
+
+        void add(coded_index<TypeDefOrRef> const& type)
+        {
+            if (!type)
+            {
+                return;
+            }
+
+            switch (type.type())
+            {
+            case TypeDefOrRef::TypeDef:
+                add(type.TypeDef());
+                break;
+            case TypeDefOrRef::TypeRef:
+                // References outside of the cache, such as System.Object, are simply not projected.
+                add(c.find(type.TypeRef().TypeNamespace(), type.TypeRef().TypeName()));
+                break;
+            case TypeDefOrRef::TypeSpec:
+                add(type.TypeSpec().Signature().GenericTypeInst());
+                break;
+            }
+        }
+
+        void add(GenericTypeInstSig const& signature)
+        {
+            add(signature.GenericType());
+
+            for (auto&& arg : signature.GenericArgs())
+            {
+                add(arg);
+            }
+        }
+
+        void add(TypeSig const& signature)
+        {
+            call(signature.Type(),
+                [&](coded_index<TypeDefOrRef> const& type)
+                {
+                    add(type);
+                },
+                [&](GenericTypeInstSig const& type)
+                {
+                    add(type);
+                },
+                [](auto&&) {});
+        }
+
+        void add_members(TypeDef const& type)
+        {
+            add(type.Extends());
+
+            for (auto&& impl : type.InterfaceImpl())
+            {
+                add(impl.Interface());
+            }
+
+            for (auto&& field : type.FieldList())
+            {
+                add(field.Signature().Type());
+            }
+
+            for (auto&& method : type.MethodList())
+            {
+                auto const signature = method.Signature();
+
+                if (signature.ReturnType())
+                {
+                    add(signature.ReturnType().Type());
+                }
+
+                for (auto&& param : signature.Params())
+                {
+                    add(param.Type());
+                }
+            }
+
+            for (auto&& attribute : type.CustomAttribute())
+            {
+                auto const[attribute_namespace, attribute_name] = attribute.TypeNamespaceAndName();
+
+                if (attribute_namespace != "Windows.Foundation.Metadata" ||
+                    (attribute_name != "ActivatableAttribute" && attribute_name != "StaticAttribute" && attribute_name != "ComposableAttribute"))
+                {
+                    continue;
+                }
+
+                auto const signature = attribute.Value();
+
+                for (auto&& arg : signature.FixedArgs())
+                {
+                    if (auto factory = std::get_if<ElemSig::SystemType>(&std::get<ElemSig>(arg.value).value))
+                    {
+                        add(c.find_required(factory->name));
+                    }
+                }
+            }
+        }
+
+        void add_namespace(std::string_view const& ns)
+        {
+            auto found = c.namespaces().find(ns);
+
+            if (found != c.namespaces().end())
+            {
+                for (auto&&[name, type] : found->second.types)
+                {
+                    add(type);
+                }
+            }
+        }
+
+        void complete()
+        {
+            // The namespaces that carry hand-written support code (see write_namespace_special) depend on
+            // most of their types, so reaching any of them brings in the whole namespace.
+
+            static constexpr std::string_view special[]{ "Windows.Foundation", "Windows.Foundation.Collections", "Windows.UI.Xaml.Interop" };
+            std::set<std::string_view> expanded;
+
+            while (!pending.empty())
+            {
+                while (!pending.empty())
+                {
+                    auto type = pending.back();
+                    pending.pop_back();
+                    add_members(type);
+                }
+
+                for (auto&& ns : special)
+                {
+                    if (expanded.count(ns))
+                    {
+                        continue;
+                    }
+
+                    auto reached = std::find_if(types.begin(), types.end(), [&](auto&& type)
+                    {
+                        return type.TypeNamespace() == ns;
+                    });
+
+                    if (reached != types.end())
+                    {
+                        expanded.insert(ns);
+                        add_namespace(ns);
+                    }
+                }
+            }
+        }
+    };
+}
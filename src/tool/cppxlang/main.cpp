@@ -1,12 +1,17 @@
 #include "pch.h"
 #include <time.h>
 #include "strings.h"
+#include "include_report.h"
+#include "../abi/sha1.h"
 #include "settings.h"
 #include "type_writers.h"
 #include "helpers.h"
 #include "code_writers.h"
 #include "component_writers.h"
 #include "file_writers.h"
+#include "manifest.h"
+#include "lean.h"
+#include "server.h"
 #include "type_writers.h"
 
 namespace xlang
@@ -29,12 +34,21 @@ namespace xlang
         { "include", 0, cmd::option::no_max, "<prefix>", "One or more prefixes to include in input" },
         { "exclude", 0, cmd::option::no_max, "<prefix>", "One or more prefixes to exclude from input" },
         { "base", 0, 0, {}, "Generate base.h unconditionally" },
+        { "modules", 0, 0, {}, "Generate C++20 module interface units for base.h and the projection" },
         { "opt", 0, 0, {}, "Generate component projection with unified construction support" },
+        { "manifest", 0, 0, {}, "Skip unchanged output files using a content hash manifest" },
+        { "incremental", 0, 0, {}, "Skip namespaces whose metadata and dependencies are unchanged" },
+        { "fanout", 0, 0, {}, "Report the headers reachable from each namespace header" },
+        { "guids", 0, 0, {}, "Precompute the GUIDs of generic interface instances used by the projection" },
         { "help", 0, cmd::option::no_max, {}, "Show detailed help with examples" },
         { "lib", 0, 1, "Specify library prefix (defaults to winrt)" },
+        { "lean", 0, cmd::option::no_max, "<name|path>", "Project only types reachable from seed types, namespaces, or winrt:: names in source files" },
+        { "server", 0, 1, "<path>", "Serve generation requests on a local socket, keeping metadata loaded" },
+        { "connect", 0, 1, "<path>", "Send this invocation to a generation server" },
         { "filter" }, // One or more prefixes to include in input (same as -include)
         { "license", 0, 0 }, // Generate license comment
         { "brackets", 0, 0 }, // Use angle brackets for #includes (defaults to quotes)
+        { "sync", 0, 0 }, // Write output files synchronously from generator tasks
     };
 
     static void print_usage(writer& w)
@@ -73,7 +87,8 @@ Where <spec> is one or more of:
         w.write(format, XLANG_VERSION_STRING, bind_each(printOption, options));
     }
 
-    static void process_args(int const argc, char** argv)
+    template <typename F>
+    static void process_args(int const argc, char** argv, F const& is_database)
     {
         cmd::reader args{ argc, argv, options };
 
@@ -83,12 +98,15 @@ Where <spec> is one or more of:
         }
 
         settings.verbose = args.exists("verbose");
+        settings.incremental = args.exists("incremental");
 
-        settings.input = args.files("input", database::is_database);
-        settings.reference = args.files("reference", database::is_database);
+        settings.input = args.files("input", is_database);
+        settings.reference = args.files("reference", is_database);
 
         settings.component = args.exists("component");
         settings.base = args.exists("base");
+        settings.modules = args.exists("modules");
+        settings.guids = args.exists("guids");
 
         settings.license = args.exists("license");
         settings.brackets = args.exists("brackets");
@@ -98,6 +116,18 @@ Where <spec> is one or more of:
         output_folder += '/';
         settings.output_folder = output_folder.string();
 
+        if (args.exists("manifest"))
+        {
+            settings.manifest.emplace(settings.output_folder + "cppxlang.manifest");
+        }
+
+        if (args.exists("fanout"))
+        {
+            settings.fanout.emplace(settings.output_folder + "cppxlang.fanout");
+        }
+
+        settings.output.emplace(!args.exists("sync"), settings.manifest ? &*settings.manifest : nullptr);
+
         for (auto && include : args.values("include"))
         {
             settings.include.insert(include);
@@ -113,6 +143,11 @@ Where <spec> is one or more of:
             settings.exclude.insert(exclude);
         }
 
+        for (auto && lean : args.values("lean"))
+        {
+            settings.lean.insert(lean);
+        }
+
         if (settings.component)
         {
             settings.component_overwrite = args.exists("overwrite");
@@ -204,7 +239,284 @@ Where <spec> is one or more of:
 
     }
 
-    static int run(int const argc, char** argv)
+    static void scan_lean_source(cache const& c, std::string const& filename, std::vector<TypeDef>& seeds)
+    {
+        std::ifstream file{ filename, std::ios::binary };
+        std::string const source{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+
+        for (auto&& name : scan_lean_names(source))
+        {
+            add_lean_seed(c, name, seeds);
+        }
+    }
+
+    static auto get_lean_seeds(cache const& c)
+    {
+        std::vector<TypeDef> seeds;
+
+        auto is_source = [](path const& filename)
+        {
+            static constexpr std::string_view extensions[]{ ".h", ".hpp", ".hxx", ".inl", ".ixx", ".c", ".cc", ".cpp", ".cxx" };
+            auto const extension = filename.extension().string();
+            return std::find(std::begin(extensions), std::end(extensions), extension) != std::end(extensions);
+        };
+
+        for (auto&& spec : settings.lean)
+        {
+            if (is_directory(spec))
+            {
+                for (auto&& file : recursive_directory_iterator(spec))
+                {
+                    if (is_regular_file(file) && is_source(file.path()))
+                    {
+                        scan_lean_source(c, file.path().string(), seeds);
+                    }
+                }
+            }
+            else if (is_regular_file(spec))
+            {
+                scan_lean_source(c, spec, seeds);
+            }
+            else if (!add_lean_seed(c, get_lean_name(spec), seeds))
+            {
+                throw_invalid("Type or namespace '", spec, "' could not be found");
+            }
+        }
+
+        return seeds;
+    }
+
+    static void build_lean_projection(cache& c)
+    {
+        lean_closure closure{ c };
+
+        for (auto&& type : get_lean_seeds(c))
+        {
+            closure.add(type);
+        }
+
+        // A component's own classes are always projected, since its templates are generated for them
+        // whether or not the seeds reach them.
+
+        if (settings.component)
+        {
+            for (auto&&[ns, members] : c.namespaces())
+            {
+                for (auto&& type : members.classes)
+                {
+                    if (settings.component_filter.includes(type))
+                    {
+                        closure.add(type);
+                    }
+                }
+            }
+        }
+
+        closure.complete();
+
+        c.retain_projected_types([&](TypeDef const& type)
+        {
+            return closure.types.count(type) != 0;
+        });
+    }
+
+    // A cache kept loaded by a generation server, along with the metadata files it was built from and
+    // their timestamps, so that it can be rebuilt when any of them changes. The candidate files that turned
+    // out not to be metadata are remembered as well, so that the request need not probe them again.
+
+    using file_stamp = std::pair<file_time_type, uintmax_t>;
+
+    struct warm_cache
+    {
+        std::set<std::string> databases;
+        std::set<std::string> skipped;
+        std::vector<file_stamp> stamps;
+        std::unique_ptr<cache> value;
+        uint64_t last_used{};
+    };
+
+    // The number of input sets a generation server keeps loaded. The least recently used is released
+    // when another one is loaded.
+
+    constexpr size_t max_warm_caches{ 4 };
+
+    static file_stamp get_file_stamp(std::string const& file)
+    {
+        std::error_code error;
+        return { last_write_time(file, error), file_size(file, error) };
+    }
+
+    static auto get_file_stamps(std::vector<std::string> const& files)
+    {
+        std::vector<file_stamp> stamps;
+
+        for (auto&& file : files)
+        {
+            stamps.push_back(get_file_stamp(file));
+        }
+
+        return stamps;
+    }
+
+    static int run(int const argc, char** argv, warm_cache* warm = nullptr);
+
+    static void serve(std::string const& socket_path)
+    {
+        // Every file the server has probed, with its timestamp and whether it holds metadata, so that only
+        // new or changed files are opened and mapped again.
+
+        struct probed_file
+        {
+            file_stamp stamp;
+            bool database;
+        };
+
+        std::map<std::vector<std::string>, warm_cache> caches;
+        std::map<std::string, probed_file> probed;
+        uint64_t requests{};
+        warm_cache cold;
+        warm_cache* current{};
+
+        auto prepare = [&](server_request const& request)
+        {
+            current = nullptr;
+
+            try
+            {
+                std::vector<char*> argv;
+
+                for (auto&& arg : request.args)
+                {
+                    argv.push_back(const_cast<char*>(arg.c_str()));
+                }
+
+                cmd::reader args{ static_cast<int>(argv.size()), argv.data(), options };
+
+                if (!args)
+                {
+                    return;
+                }
+
+                // The server's own working folder never changes, so relative metadata paths are resolved
+                // against the client's folder here. The request itself runs from that folder.
+
+                std::vector<std::string> resolved{ request.args.front() };
+
+                for (auto name : { "input", "reference" })
+                {
+                    auto const& values = args.values(name);
+
+                    if (values.empty())
+                    {
+                        continue;
+                    }
+
+                    resolved.push_back(std::string{ "-" } + name);
+
+                    for (auto&& value : values)
+                    {
+                        path const folder_path = path{ request.folder } / value;
+                        std::error_code error;
+                        resolved.push_back(path{ value }.is_relative() && exists(folder_path, error) ? folder_path.string() : value);
+                    }
+                }
+
+                argv.clear();
+
+                for (auto&& arg : resolved)
+                {
+                    argv.push_back(const_cast<char*>(arg.c_str()));
+                }
+
+                cmd::reader files_args{ static_cast<int>(argv.size()), argv.data(), options };
+                database_probe probe;
+                std::set<std::string> skipped;
+                std::mutex lock;
+
+                auto is_database = [&](std::string const& path)
+                {
+                    auto const stamp = get_file_stamp(path);
+
+                    {
+                        std::lock_guard<std::mutex> const guard{ lock };
+                        auto found = probed.find(path);
+
+                        if (found != probed.end() && found->second.stamp == stamp)
+                        {
+                            if (!found->second.database)
+                            {
+                                skipped.insert(path);
+                            }
+
+                            return found->second.database;
+                        }
+                    }
+
+                    bool const database = probe(path);
+                    std::lock_guard<std::mutex> const guard{ lock };
+                    probed[path] = { stamp, database };
+
+                    if (!database)
+                    {
+                        skipped.insert(path);
+                    }
+
+                    return database;
+                };
+
+                auto input = files_args.files("input", is_database);
+                auto reference = files_args.files("reference", is_database);
+                std::vector<std::string> files;
+                files.insert(files.end(), input.begin(), input.end());
+                files.insert(files.end(), reference.begin(), reference.end());
+
+                auto stamps = get_file_stamps(files);
+                auto& entry = caches[files];
+
+                if (!entry.value || entry.stamps != stamps)
+                {
+                    entry.value.reset();
+                    entry.value = std::make_unique<cache>(files, &probe);
+                    entry.databases.clear();
+                    entry.databases.insert(files.begin(), files.end());
+                    entry.stamps = std::move(stamps);
+                }
+
+                entry.skipped = std::move(skipped);
+                entry.last_used = ++requests;
+                current = &entry;
+
+                while (caches.size() > max_warm_caches)
+                {
+                    caches.erase(std::min_element(caches.begin(), caches.end(), [](auto&& left, auto&& right)
+                    {
+                        return left.second.last_used < right.second.last_used;
+                    }));
+                }
+            }
+            catch (std::exception const&)
+            {
+                // The request runs without a warm cache and reports the error itself.
+            }
+        };
+
+        auto execute = [&](server_request const& request)
+        {
+            std::vector<char*> argv;
+
+            for (auto&& arg : request.args)
+            {
+                argv.push_back(const_cast<char*>(arg.c_str()));
+            }
+
+            // Requests always run as served, even without a warm cache, since they carry the client's -connect.
+            return run(static_cast<int>(argv.size()), argv.data(), current ? current : &cold);
+        };
+
+        run_server(socket_path, prepare, execute);
+    }
+
+    static int run(int const argc, char** argv, warm_cache* warm)
     {
         int result{};
         writer w;
@@ -212,10 +524,44 @@ Where <spec> is one or more of:
         try
         {
             auto start = get_start_time();
-            process_args(argc, argv);
-            cache c{ get_files_to_cache() };
+
+            if (!warm)
+            {
+                cmd::reader args{ argc, argv, options };
+
+                if (args.exists("connect"))
+                {
+                    return run_client(args.value("connect"), argc, argv);
+                }
+
+                if (args.exists("server"))
+                {
+                    serve(args.value("server"));
+                    return 0;
+                }
+            }
+
+            database_probe probe;
+
+            process_args(argc, argv, [&](std::string const& path)
+            {
+                return (warm && warm->databases.count(path)) || (!(warm && warm->skipped.count(path)) && probe(path));
+            });
+
+            // The warm cache is this process's own copy, so it is changed in place like a fresh one.
+
+            std::optional<cache> fresh;
+            auto files = get_files_to_cache();
+            bool const use_warm = warm && warm->value && warm->databases == std::set<std::string>{ files.begin(), files.end() };
+            cache& c = use_warm ? *warm->value : fresh.emplace(files, &probe);
             c.remove_cppwinrt_foundation_types();
             build_filters(c);
+
+            if (!settings.lean.empty())
+            {
+                build_lean_projection(c);
+            }
+
             settings.base = settings.base || (!settings.component && settings.projection_filter.empty());
 
             if (settings.verbose)
@@ -242,66 +588,156 @@ Where <spec> is one or more of:
             }
 
             w.flush_to_console();
+            std::optional<generation_manifest> generation;
+            std::map<std::string_view, uint64_t> fingerprints;
+            uint64_t skipped{};
+
+            if (settings.incremental)
+            {
+                generation.emplace(settings.output_folder + "cppxlang.namespaces");
+                fingerprints = get_namespace_fingerprints(c);
+            }
+
+            std::deque<std::atomic<uint32_t>> remaining;
+            std::vector<TypeDef> classes;
             task_group group;
 
             for (auto&&[ns, members] : c.namespaces())
             {
-                group.add([&, &ns = ns, &members = members]
+                if (!has_projected_types(members) || !settings.projection_filter.includes(members))
                 {
-                    if (!has_projected_types(members) || !settings.projection_filter.includes(members))
+                    continue;
+                }
+
+                auto fingerprint = fingerprints.find(ns);
+
+                if (fingerprint != fingerprints.end() && generation->is_current(ns, fingerprint->second))
+                {
+                    ++skipped;
+                    continue;
+                }
+
+                // Each header is written by its own task. The namespace's fingerprint is only recorded by
+                // whichever task completes last, once all four headers have been written.
+
+                auto& passes = remaining.emplace_back(4);
+
+                auto complete = [&, &ns = ns, &passes, fingerprint]
+                {
+                    if (--passes == 0 && fingerprint != fingerprints.end())
                     {
-                        return;
+                        generation->update(ns, fingerprint->second);
                     }
+                };
+
+                group.add([&, &ns = ns, &members = members, complete]
+                {
+                    write_namespace_0_h(ns, members, c);
+                    complete();
+                });
 
-                    write_namespace_0_h(ns, members);
+                group.add([&, &ns = ns, &members = members, complete]
+                {
                     write_namespace_1_h(ns, members);
+                    complete();
+                });
+
+                group.add([&, &ns = ns, &members = members, complete]
+                {
                     write_namespace_2_h(ns, members, c);
+                    complete();
+                });
+
+                group.add([&, &ns = ns, &members = members, complete]
+                {
                     write_namespace_h(c, ns, members);
+                    complete();
                 });
             }
 
-            group.add([&]
+            if (settings.base)
             {
-                if (settings.base)
+                group.add([]
                 {
                     write_base_h();
                     write_coroutine_h();
-                }
 
-                if (settings.component)
+                    if (settings.modules)
+                    {
+                        write_base_module();
+                    }
+                });
+            }
+
+            if (settings.modules)
+            {
+                group.add([&]
                 {
-                    std::vector<TypeDef> classes;
+                    write_projection_module(c);
+                });
+            }
 
-                    for (auto&&[ns, members] : c.namespaces())
+            if (settings.component)
+            {
+                for (auto&&[ns, members] : c.namespaces())
+                {
+                    for (auto&& type : members.classes)
                     {
-                        for (auto&& type : members.classes)
+                        if (settings.component_filter.includes(type))
                         {
-                            if (settings.component_filter.includes(type))
-                            {
-                                classes.push_back(type);
-                            }
+                            classes.push_back(type);
                         }
                     }
+                }
+            }
 
-                    if (!classes.empty())
-                    {
-                        write_module_g_cpp(classes);
+            if (!classes.empty())
+            {
+                group.add([&]
+                {
+                    write_module_g_cpp(classes);
+                });
 
-                        for (auto&& type : classes)
-                        {
-                            write_component_g_h(type);
-                            write_component_g_cpp(type);
-                            write_component_h(type);
-                            write_component_cpp(type);
-                        }
-                    }
+                for (auto&& type : classes)
+                {
+                    group.add([&type]
+                    {
+                        write_component_g_h(type);
+                        write_component_g_cpp(type);
+                        write_component_h(type);
+                        write_component_cpp(type);
+                    });
                 }
-            });
+            }
 
             group.get();
+            settings.output->flush();
+
+            if (settings.manifest)
+            {
+                settings.manifest->save();
+            }
+
+            if (generation)
+            {
+                generation->save();
+            }
+
+            if (settings.fanout)
+            {
+                settings.fanout->save();
+            }
 
             if (settings.verbose)
             {
+                if (generation)
+                {
+                    w.write(" skip:  % namespaces unchanged\n", skipped);
+                }
+
+                auto stats = settings.output->get_statistics();
+                w.write(" files: % (% written, % folders, % batches)\n", stats.files, stats.written, stats.directories, stats.batches);
+                w.write(" io:    %ms (%ms waiting)\n", stats.io_time / 1000, stats.wait_time / 1000);
                 w.write(" time:  %ms\n", get_elapsed_time(start));
             }
         }
@@ -0,0 +1,581 @@
+#pragma once
+
+namespace xlang
+{
+    struct namespace_fingerprint
+    {
+        // Hashes everything about a namespace's metadata that the namespace headers are generated from.
+        // Type references are hashed by name rather than by row so that unrelated changes elsewhere in a
+        // winmd don't invalidate the namespace, and every referenced namespace is recorded so that its
+        // fingerprint can be folded in as well.
+
+        uint64_t hash{ 0xcbf29ce484222325ull };
+        std::set<std::string_view> depends;
+
+        namespace_fingerprint(cache const& c, std::string_view const& ns, cache::namespace_members const& members) : m_namespace(ns)
+        {
+            add(std::string_view{ XLANG_VERSION_STRING });
+            add(ns);
+            add(settings.license);
+            add(settings.brackets);
+            add(settings.component_opt);
+            add(settings.guids);
+
+            for (auto parent = ns; parent.rfind('.') != std::string_view::npos;)
+            {
+                parent = parent.substr(0, parent.rfind('.'));
+                auto found = c.namespaces().find(parent);
+                add(found != c.namespaces().end() && has_projected_types(found->second));
+            }
+
+            for (auto&&[name, type] : members.types)
+            {
+                add_type(type);
+            }
+
+            // The projected categories may have been pruned, as with -lean, independently of the metadata.
+
+            for (auto projected : { &members.interfaces, &members.classes, &members.enums, &members.structs, &members.delegates })
+            {
+                add(projected->size());
+
+                for (auto&& type : *projected)
+                {
+                    add(type.TypeName());
+                }
+            }
+
+            // With -guids, the .0.h of a namespace that declares generic types holds the IIDs of their
+            // instances in every namespace.
+
+            auto const is_generic = [](TypeDef const& type) { return !empty(type.GenericParam()); };
+
+            if (settings.guids &&
+                (std::any_of(members.interfaces.begin(), members.interfaces.end(), is_generic) ||
+                 std::any_of(members.delegates.begin(), members.delegates.end(), is_generic)))
+            {
+                for (auto&&[other, other_members] : c.namespaces())
+                {
+                    if (other != ns && has_projected_types(other_members))
+                    {
+                        depends.insert(other);
+                    }
+                }
+            }
+        }
+
+    private:
+
+        void add(uint64_t value) noexcept
+        {
+            // FNV-1a
+            for (uint32_t i = 0; i != sizeof(value); ++i)
+            {
+                hash ^= static_cast<uint8_t>(value >> (i * 8));
+                hash *= 0x100000001b3ull;
+            }
+        }
+
+        void add(std::string_view const& value) noexcept
+        {
+            add(value.size());
+
+            for (auto&& c : value)
+            {
+                hash ^= static_cast<uint8_t>(c);
+                hash *= 0x100000001b3ull;
+            }
+        }
+
+        template <typename T>
+        void add_value(T const& value)
+        {
+            if constexpr (std::is_same_v<T, std::string_view>)
+            {
+                add(value);
+            }
+            else if constexpr (std::is_floating_point_v<T>)
+            {
+                double const widened = value;
+                uint64_t bits;
+                memcpy(&bits, &widened, sizeof(bits));
+                add(bits);
+            }
+            else if constexpr (std::is_same_v<T, std::nullptr_t>)
+            {
+                add(0);
+            }
+            else
+            {
+                add(static_cast<uint64_t>(value));
+            }
+        }
+
+        void add_name(std::string_view const& type_namespace, std::string_view const& type_name)
+        {
+            if (type_namespace != m_namespace)
+            {
+                depends.insert(type_namespace);
+            }
+
+            add(type_namespace);
+            add(type_name);
+        }
+
+        void add_name(std::string_view const& full_name)
+        {
+            auto const pos = full_name.rfind('.');
+
+            if (pos == std::string_view::npos)
+            {
+                add_name({}, full_name);
+            }
+            else
+            {
+                add_name(full_name.substr(0, pos), full_name.substr(pos + 1));
+            }
+        }
+
+        void add_type(coded_index<TypeDefOrRef> const& type)
+        {
+            if (!type)
+            {
+                add(0);
+                return;
+            }
+
+            add(static_cast<uint64_t>(type.type()));
+
+            switch (type.type())
+            {
+            case TypeDefOrRef::TypeDef:
+            {
+                auto const& def = type.TypeDef();
+                add_name(def.TypeNamespace(), def.TypeName());
+                break;
+            }
+            case TypeDefOrRef::TypeRef:
+            {
+                auto const& ref = type.TypeRef();
+                add_name(ref.TypeNamespace(), ref.TypeName());
+                break;
+            }
+            case TypeDefOrRef::TypeSpec:
+                add_signature(type.TypeSpec().Signature().GenericTypeInst());
+                break;
+            }
+        }
+
+        void add_signature(GenericTypeInstSig const& signature)
+        {
+            add(static_cast<uint64_t>(signature.ClassOrValueType()));
+            add_type(signature.GenericType());
+            add(signature.GenericArgCount());
+
+            for (auto&& arg : signature.GenericArgs())
+            {
+                add_signature(arg);
+            }
+        }
+
+        void add_signature(TypeSig const& signature)
+        {
+            add(signature.is_szarray());
+            add(signature.Type().index());
+
+            std::visit([&](auto&& type)
+            {
+                using T = std::decay_t<decltype(type)>;
+
+                if constexpr (std::is_same_v<T, ElementType>)
+                {
+                    add(static_cast<uint64_t>(type));
+                }
+                else if constexpr (std::is_same_v<T, GenericTypeIndex>)
+                {
+                    add(type.index);
+                }
+                else
+                {
+                    add_signature(type);
+                }
+            },
+                signature.Type());
+        }
+
+        void add_signature(coded_index<TypeDefOrRef> const& type)
+        {
+            add_type(type);
+        }
+
+        void add_signature(MethodDefSig const& signature)
+        {
+            add(static_cast<uint64_t>(signature.CallConvention()));
+            add(signature.GenericParamCount());
+            add(static_cast<bool>(signature.ReturnType()));
+
+            if (signature.ReturnType())
+            {
+                add(signature.ReturnType().ByRef());
+                add_signature(signature.ReturnType().Type());
+            }
+
+            for (auto&& param : signature.Params())
+            {
+                add(param.ByRef());
+                add_signature(param.Type());
+            }
+        }
+
+        void add_constant(Constant const& constant)
+        {
+            add(static_cast<bool>(constant));
+
+            if (constant)
+            {
+                add(static_cast<uint64_t>(constant.Type()));
+                std::visit([&](auto&& value) { add_value(value); }, constant.Value());
+            }
+        }
+
+        void add_element(ElemSig const& element)
+        {
+            add(element.value.index());
+
+            std::visit([&](auto&& value)
+            {
+                using T = std::decay_t<decltype(value)>;
+
+                if constexpr (std::is_same_v<T, ElemSig::SystemType>)
+                {
+                    add_name(value.name);
+                }
+                else if constexpr (std::is_same_v<T, ElemSig::EnumValue>)
+                {
+                    add_name(value.type.m_typedef.TypeNamespace(), value.type.m_typedef.TypeName());
+                    std::visit([&](auto&& enum_value) { add_value(enum_value); }, value.value);
+                }
+                else
+                {
+                    add_value(value);
+                }
+            },
+                element.value);
+        }
+
+        void add_argument(FixedArgSig const& arg)
+        {
+            if (auto element = std::get_if<ElemSig>(&arg.value))
+            {
+                add_element(*element);
+            }
+            else
+            {
+                auto const& elements = std::get<std::vector<ElemSig>>(arg.value);
+                add(elements.size());
+
+                for (auto&& item : elements)
+                {
+                    add_element(item);
+                }
+            }
+        }
+
+        template <typename T>
+        void add_attributes(T const& row)
+        {
+            auto const attributes = row.CustomAttribute();
+            add(static_cast<uint64_t>(distance(attributes)));
+
+            for (auto&& attribute : attributes)
+            {
+                auto const[type_namespace, type_name] = attribute.TypeNamespaceAndName();
+                add_name(type_namespace, type_name);
+                auto const signature = attribute.Value();
+
+                for (auto&& arg : signature.FixedArgs())
+                {
+                    add_argument(arg);
+                }
+
+                for (auto&& arg : signature.NamedArgs())
+                {
+                    add(arg.name);
+                    add_argument(arg.value);
+                }
+            }
+        }
+
+        template <typename T>
+        void add_semantics(T const& row)
+        {
+            for (auto&& semantic : row.MethodSemantic())
+            {
+                add(semantic.Semantic().value);
+                add(semantic.Method().Name());
+            }
+        }
+
+        void add_type(TypeDef const& type)
+        {
+            add_name(type.TypeNamespace(), type.TypeName());
+            add(type.Flags().value);
+            add_type(type.Extends());
+            add_attributes(type);
+
+            for (auto&& param : type.GenericParam())
+            {
+                add(param.Number());
+                add(param.Flags().value);
+                add(param.Name());
+            }
+
+            for (auto&& impl : type.InterfaceImpl())
+            {
+                add_type(impl.Interface());
+                add_attributes(impl);
+            }
+
+            for (auto&& field : type.FieldList())
+            {
+                add(field.Name());
+                add(field.Flags().value);
+                add_signature(field.Signature().Type());
+                add_constant(field.Constant());
+                add_attributes(field);
+            }
+
+            for (auto&& method : type.MethodList())
+            {
+                add(method.Name());
+                add(method.Flags().value);
+                add(method.ImplFlags().value);
+                add_signature(method.Signature());
+                add_attributes(method);
+
+                for (auto&& param : method.ParamList())
+                {
+                    add(param.Sequence());
+                    add(param.Flags().value);
+                    add(param.Name());
+                    add_attributes(param);
+                }
+            }
+
+            for (auto&& property : type.PropertyList())
+            {
+                add(property.Name());
+                add(property.Flags().value);
+                add_signature(property.Type().Type());
+                add_semantics(property);
+                add_attributes(property);
+            }
+
+            for (auto&& event : type.EventList())
+            {
+                add(event.Name());
+                add(event.EventFlags().value);
+                add_type(event.EventType());
+                add_semantics(event);
+                add_attributes(event);
+            }
+
+            if (settings.component_opt)
+            {
+                add(settings.component_filter.includes(type));
+            }
+        }
+
+        std::string_view const m_namespace;
+    };
+
+    static auto get_namespace_fingerprints(cache const& c)
+    {
+        // A namespace's headers depend on the namespaces it references and, through required interfaces,
+        // base classes and struct fields, on whatever those reference in turn. Each namespace is therefore
+        // fingerprinted on its own and then combined with the fingerprints of its transitive dependencies.
+        // Namespaces whose metadata can't be fingerprinted are left out and always regenerated.
+
+        std::vector<std::pair<std::string_view, cache::namespace_members const*>> namespaces;
+
+        for (auto&&[ns, members] : c.namespaces())
+        {
+            namespaces.emplace_back(ns, &members);
+        }
+
+        std::vector<std::optional<namespace_fingerprint>> local(namespaces.size());
+        task_group group;
+
+        for (size_t i = 0; i != namespaces.size(); ++i)
+        {
+            group.add([&, i]
+            {
+                try
+                {
+                    local[i].emplace(c, namespaces[i].first, *namespaces[i].second);
+                }
+                catch (std::exception const&)
+                {
+                }
+            });
+        }
+
+        group.get();
+        std::map<std::string_view, namespace_fingerprint const*> lookup;
+
+        for (size_t i = 0; i != namespaces.size(); ++i)
+        {
+            if (local[i])
+            {
+                lookup.emplace(namespaces[i].first, &*local[i]);
+            }
+        }
+
+        std::map<std::string_view, uint64_t> result;
+
+        for (size_t i = 0; i != namespaces.size(); ++i)
+        {
+            if (!local[i])
+            {
+                continue;
+            }
+
+            std::set<std::string_view> visited{ namespaces[i].first };
+            std::vector<std::string_view> pending(local[i]->depends.begin(), local[i]->depends.end());
+            uint64_t hash = local[i]->hash;
+            bool complete = true;
+
+            while (!pending.empty())
+            {
+                auto const ns = pending.back();
+                pending.pop_back();
+
+                if (!visited.insert(ns).second)
+                {
+                    continue;
+                }
+
+                auto const found = lookup.find(ns);
+
+                if (found == lookup.end())
+                {
+                    // References to namespaces outside of the cache can't change the output, but those
+                    // that failed to fingerprint could.
+                    if (c.namespaces().find(ns) != c.namespaces().end())
+                    {
+                        complete = false;
+                        break;
+                    }
+
+                    continue;
+                }
+
+                // The combination must not depend on the order in which dependencies are visited.
+                hash += found->second->hash * 0x9e3779b97f4a7c15ull;
+                pending.insert(pending.end(), found->second->depends.begin(), found->second->depends.end());
+            }
+
+            if (complete)
+            {
+                result.emplace(namespaces[i].first, hash);
+            }
+        }
+
+        return result;
+    }
+
+    struct generation_manifest
+    {
+        generation_manifest(generation_manifest const&) = delete;
+        generation_manifest& operator=(generation_manifest const&) = delete;
+
+        explicit generation_manifest(std::string filename) : m_filename(std::move(filename))
+        {
+            // Each line holds "<fingerprint> <namespace>".
+
+            std::ifstream file{ m_filename };
+            std::string line;
+
+            while (std::getline(file, line))
+            {
+                char* cursor = line.data();
+                auto const hash = std::strtoull(cursor, &cursor, 16);
+
+                if (*cursor != ' ' || !*(cursor + 1))
+                {
+                    continue;
+                }
+
+                m_entries[cursor + 1] = hash;
+            }
+        }
+
+        bool is_current(std::string_view const& ns, uint64_t const hash) const
+        {
+            {
+                std::lock_guard<std::mutex> guard{ m_lock };
+                auto found = m_entries.find(ns);
+
+                if (found == m_entries.end() || found->second != hash)
+                {
+                    return false;
+                }
+            }
+
+            // The headers must still be there, otherwise they are simply generated again.
+
+            std::string const impl = settings.output_folder + "winrt/impl/" + std::string{ ns } + '.';
+
+            return
+                std::experimental::filesystem::exists(impl + "0.h") &&
+                std::experimental::filesystem::exists(impl + "1.h") &&
+                std::experimental::filesystem::exists(impl + "2.h") &&
+                std::experimental::filesystem::exists(settings.output_folder + "winrt/" + std::string{ ns } + ".h");
+        }
+
+        void update(std::string_view const& ns, uint64_t const hash)
+        {
+            std::lock_guard<std::mutex> guard{ m_lock };
+            auto& entry = m_entries[std::string{ ns }];
+
+            if (entry != hash)
+            {
+                entry = hash;
+                m_dirty = true;
+            }
+        }
+
+        void save() const
+        {
+            std::vector<char> content;
+
+            {
+                std::lock_guard<std::mutex> guard{ m_lock };
+
+                if (!m_dirty)
+                {
+                    return;
+                }
+
+                char buffer[32];
+
+                for (auto&&[ns, hash] : m_entries)
+                {
+                    int const size = snprintf(buffer, sizeof(buffer), "%016llx ", static_cast<unsigned long long>(hash));
+                    content.insert(content.end(), buffer, buffer + size);
+                    content.insert(content.end(), ns.begin(), ns.end());
+                    content.push_back('\n');
+                }
+            }
+
+            text::write_file(m_filename, content, {});
+        }
+
+    private:
+
+        std::string const m_filename;
+        mutable std::mutex m_lock;
+        std::map<std::string, uint64_t, std::less<>> m_entries;
+        bool m_dirty{};
+    };
+}
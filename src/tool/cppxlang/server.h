@@ -0,0 +1,259 @@
+#pragma once
+
+#if !defined(_WIN32)
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace xlang
+{
+    // A generation request carries the client's working folder and its command line, including argv[0].
+    // The response is the exit code followed by everything the request wrote to the console.
+
+    struct server_request
+    {
+        std::string folder;
+        std::vector<std::string> args;
+    };
+
+#if defined(_WIN32)
+
+    inline int run_client(std::string const&, int const, char**)
+    {
+        throw_invalid("Generation servers are not supported on this platform");
+    }
+
+    template <typename Prepare, typename Execute>
+    void run_server(std::string const&, Prepare&&, Execute&&)
+    {
+        throw_invalid("Generation servers are not supported on this platform");
+    }
+
+#else
+
+    namespace impl
+    {
+        inline void send_bytes(int const socket, void const* data, size_t size)
+        {
+            auto bytes = static_cast<char const*>(data);
+
+            while (size)
+            {
+                auto const sent = ::send(socket, bytes, size, MSG_NOSIGNAL);
+
+                if (sent <= 0)
+                {
+                    throw_invalid("Failed to write to generation server socket");
+                }
+
+                bytes += sent;
+                size -= sent;
+            }
+        }
+
+        inline void receive_bytes(int const socket, void* data, size_t size)
+        {
+            auto bytes = static_cast<char*>(data);
+
+            while (size)
+            {
+                auto const received = ::recv(socket, bytes, size, 0);
+
+                if (received <= 0)
+                {
+                    throw_invalid("Failed to read from generation server socket");
+                }
+
+                bytes += received;
+                size -= received;
+            }
+        }
+
+        inline void send_string(int const socket, std::string_view const& value)
+        {
+            uint32_t const size = static_cast<uint32_t>(value.size());
+            send_bytes(socket, &size, sizeof(size));
+            send_bytes(socket, value.data(), value.size());
+        }
+
+        inline std::string receive_string(int const socket)
+        {
+            uint32_t size{};
+            receive_bytes(socket, &size, sizeof(size));
+            std::string value(size, '\0');
+            receive_bytes(socket, value.data(), size);
+            return value;
+        }
+
+        inline sockaddr_un get_socket_address(std::string const& socket_path)
+        {
+            sockaddr_un address{};
+            address.sun_family = AF_UNIX;
+
+            if (socket_path.size() >= sizeof(address.sun_path))
+            {
+                throw_invalid("Socket path '", socket_path, "' is too long");
+            }
+
+            socket_path.copy(address.sun_path, socket_path.size());
+            return address;
+        }
+
+        struct socket_handle
+        {
+            explicit socket_handle(int const value) : value(value)
+            {
+                if (value == -1)
+                {
+                    throw_invalid("Failed to create generation server socket");
+                }
+            }
+
+            socket_handle(socket_handle const&) = delete;
+            socket_handle& operator=(socket_handle const&) = delete;
+
+            ~socket_handle()
+            {
+                if (value != -1)
+                {
+                    ::close(value);
+                }
+            }
+
+            int value;
+        };
+    }
+
+    inline int run_client(std::string const& socket_path, int const argc, char** argv)
+    {
+        auto const address = impl::get_socket_address(socket_path);
+        impl::socket_handle client{ ::socket(AF_UNIX, SOCK_STREAM, 0) };
+
+        if (::connect(client.value, reinterpret_cast<sockaddr const*>(&address), sizeof(address)) == -1)
+        {
+            throw_invalid("Failed to connect to generation server '", socket_path, "'");
+        }
+
+        impl::send_string(client.value, std::experimental::filesystem::current_path().string());
+        uint32_t const count = static_cast<uint32_t>(argc);
+        impl::send_bytes(client.value, &count, sizeof(count));
+
+        for (int i = 0; i < argc; ++i)
+        {
+            impl::send_string(client.value, argv[i]);
+        }
+
+        int32_t result{};
+        impl::receive_bytes(client.value, &result, sizeof(result));
+        auto const output = impl::receive_string(client.value);
+        printf("%.*s", static_cast<int>(output.size()), output.data());
+        return result;
+    }
+
+    // Serves requests one at a time. Prepare runs in the server process so that whatever it caches stays
+    // warm for later requests, while each request executes in a forked child that inherits that state. The
+    // child starts from the server's memory, so per-run global state never leaks from one request to the next.
+    // Only the child moves to the client's working folder; the server's own folder never changes.
+
+    template <typename Prepare, typename Execute>
+    void run_server(std::string const& socket_path, Prepare&& prepare, Execute&& execute)
+    {
+        auto const address = impl::get_socket_address(socket_path);
+        impl::socket_handle server{ ::socket(AF_UNIX, SOCK_STREAM, 0) };
+        ::unlink(socket_path.c_str());
+
+        if (::bind(server.value, reinterpret_cast<sockaddr const*>(&address), sizeof(address)) == -1 ||
+            ::listen(server.value, SOMAXCONN) == -1)
+        {
+            throw_invalid("Failed to listen on '", socket_path, "'");
+        }
+
+        // Children are never waited for.
+        ::signal(SIGCHLD, SIG_IGN);
+
+        while (true)
+        {
+            int const accepted = ::accept(server.value, nullptr, nullptr);
+
+            if (accepted == -1)
+            {
+                continue;
+            }
+
+            impl::socket_handle client{ accepted };
+            server_request request;
+
+            try
+            {
+                request.folder = impl::receive_string(client.value);
+                uint32_t count{};
+                impl::receive_bytes(client.value, &count, sizeof(count));
+
+                for (uint32_t i = 0; i < count; ++i)
+                {
+                    request.args.push_back(impl::receive_string(client.value));
+                }
+
+                if (request.args.empty())
+                {
+                    continue;
+                }
+            }
+            catch (std::exception const&)
+            {
+                continue;
+            }
+
+            prepare(request);
+            fflush(stdout);
+
+            if (::fork() != 0)
+            {
+                continue;
+            }
+
+            // Console output is captured in a temporary file and sent back once the request completes.
+
+            ::close(server.value);
+            FILE* capture = tmpfile();
+            int result = 1;
+
+            if (capture)
+            {
+                ::dup2(fileno(capture), STDOUT_FILENO);
+                ::dup2(fileno(capture), STDERR_FILENO);
+
+                if (::chdir(request.folder.c_str()) == 0)
+                {
+                    result = execute(request);
+                }
+                else
+                {
+                    printf("Failed to change to folder '%s'\n", request.folder.c_str());
+                }
+
+                fflush(stdout);
+
+                std::string output(static_cast<size_t>(::lseek(fileno(capture), 0, SEEK_END)), '\0');
+                ::pread(fileno(capture), output.data(), output.size(), 0);
+
+                try
+                {
+                    int32_t const code = result;
+                    impl::send_bytes(client.value, &code, sizeof(code));
+                    impl::send_string(client.value, output);
+                }
+                catch (std::exception const&)
+                {
+                }
+            }
+
+            ::close(client.value);
+            _exit(result);
+        }
+    }
+
+#endif
+}
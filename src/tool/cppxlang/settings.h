@@ -9,6 +9,8 @@ namespace xlang
 
         std::string output_folder;
         bool base{};
+        bool modules{};
+        bool guids{};
         bool license{};
         bool brackets{};
 
@@ -22,9 +24,14 @@ namespace xlang
         bool component_opt{};
 
         bool verbose{};
+        bool incremental{};
+        std::optional<text::output_manifest> manifest;
+        std::optional<text::output_stage> output;
+        std::optional<include_report> fanout;
 
         std::set<std::string> include;
         std::set<std::string> exclude;
+        std::set<std::string> lean;
 
         meta::reader::filter projection_filter;
         meta::reader::filter component_filter;
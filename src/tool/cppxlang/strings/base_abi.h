@@ -1,5 +1,5 @@
 
-namespace winrt::impl
+WINRT_EXPORT namespace winrt::impl
 {
     inline constexpr hresult error_ok{ 0 }; // S_OK
     inline constexpr hresult error_fail{ static_cast<hresult>(0x80004005) }; // E_FAIL
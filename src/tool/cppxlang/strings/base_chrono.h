@@ -1,10 +1,10 @@
 
-namespace winrt::impl
+WINRT_EXPORT namespace winrt::impl
 {
     using filetime_period = std::ratio_multiply<std::ratio<100>, std::nano>;
 }
 
-namespace winrt
+WINRT_EXPORT namespace winrt
 {
     struct clock;
 
@@ -15,7 +15,7 @@ namespace winrt
     }
 }
 
-namespace winrt::impl
+WINRT_EXPORT namespace winrt::impl
 {
     template <> struct abi<Windows::Foundation::TimeSpan>
     {
@@ -48,7 +48,7 @@ namespace winrt::impl
     };
 }
 
-namespace winrt
+WINRT_EXPORT namespace winrt
 {
     struct file_time
     {
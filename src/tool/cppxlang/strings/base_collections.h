@@ -1,20 +1,151 @@
-
-namespace winrt::impl
+WINRT_EXPORT namespace winrt::impl
 {
     namespace wfc = Windows::Foundation::Collections;
 
+    // Range-for loops and algorithms over a projected IVector or IVectorView copy its elements out in
+    // batches with GetMany, so that a loop costs one call across the ABI per batch rather than one per
+    // element. A batch is only fetched once an element is read, and batches start small and double up to
+    // the batch size, so that a loop that stops early fetches little more than it reads. Loops over an
+    // IIterable walk the IIterator that begin returns, unless they opt in with winrt::batched. Collections
+    // without GetMany (the bindable interfaces) are walked one element at a time.
+    //
+    // An iterator reads its current batch rather than the collection, so a loop that changes the collection
+    // with SetAt, InsertAt or RemoveAt only sees the change once it fetches a batch that covers it. Reading
+    // past the end of a collection that has shrunk still throws hresult_out_of_bounds, once the next batch
+    // comes back empty. Loops that change the collection they walk should index it with GetAt instead.
+
+    inline constexpr uint32_t initial_batch_size{ 4 };
+    inline constexpr uint32_t default_batch_size{ 64 };
+
+    template <typename T>
+    struct batch_buffer
+    {
+        // Belongs to a single iterator or range. A copy starts out empty and fetches its own batch when
+        // it is first read. Batches of up to the default batch size are kept inline, and their elements
+        // are only constructed as the batches grow, so that a loop neither allocates nor constructs more
+        // than it reads. Only a larger size asked for with winrt::batched goes to the heap.
+
+        batch_buffer() noexcept = default;
+
+        batch_buffer(batch_buffer const&) noexcept
+        {
+        }
+
+        batch_buffer& operator=(batch_buffer const&) noexcept
+        {
+            first = 0;
+            size = 0;
+            return *this;
+        }
+
+        ~batch_buffer() noexcept
+        {
+            release();
+        }
+
+        // Makes room for the next batch, which is twice the size of the last one up to the given limit.
+
+        array_view<T> next(uint32_t const limit)
+        {
+            uint32_t const count = (std::min)(capacity ? capacity * 2 : initial_batch_size, limit);
+            first = 0;
+            size = 0;
+
+            if (count > capacity)
+            {
+                if (count <= default_batch_size && (!data || data == local()))
+                {
+                    std::uninitialized_fill(local() + capacity, local() + count, empty_value<T>());
+                    data = local();
+                }
+                else
+                {
+                    T* const storage = static_cast<T*>(::operator new(sizeof(T) * count));
+                    std::uninitialized_fill_n(storage, count, empty_value<T>());
+                    release();
+                    data = storage;
+                }
+
+                capacity = count;
+            }
+
+            return { data, data + count };
+        }
+
+        T* data{};
+        uint32_t capacity{};
+        uint32_t first{};
+        uint32_t size{};
+
+    private:
+
+        T* local() noexcept
+        {
+            return reinterpret_cast<T*>(m_local);
+        }
+
+        void release() noexcept
+        {
+            if (data)
+            {
+                std::destroy_n(data, capacity);
+
+                if (data != local())
+                {
+                    ::operator delete(data);
+                }
+            }
+        }
+
+        alignas(T) unsigned char m_local[sizeof(T) * default_batch_size];
+    };
+
+    template <typename T>
+    class has_GetAt
+    {
+        template <typename U, typename = decltype(std::declval<U>().GetAt(0))> static constexpr bool get_value(int) { return true; }
+        template <typename> static constexpr bool get_value(...) { return false; }
+
+    public:
+
+        static constexpr bool value = get_value<T>(0);
+    };
+
+    template <typename T>
+    class has_GetMany
+    {
+        template <typename U, typename = decltype(std::declval<U>().GetMany(0, std::declval<array_view<decltype(std::declval<U>().GetAt(0))>>()))> static constexpr bool get_value(int) { return true; }
+        template <typename> static constexpr bool get_value(...) { return false; }
+
+    public:
+
+        static constexpr bool value = get_value<T>(0);
+    };
+
+    template <typename T>
+    class has_iterator_GetMany
+    {
+        template <typename U, typename = decltype(std::declval<U>().First().GetMany(std::declval<array_view<decltype(std::declval<U>().First().Current())>>()))> static constexpr bool get_value(int) { return true; }
+        template <typename> static constexpr bool get_value(...) { return false; }
+
+    public:
+
+        static constexpr bool value = get_value<T>(0);
+    };
+
     template <typename T>
     struct fast_iterator
     {
         using iterator_category = std::input_iterator_tag;
-        using value_type = T;
+        using value_type = decltype(std::declval<T const&>().GetAt(0));
         using difference_type = ptrdiff_t;
-        using pointer = T * ;
-        using reference = T & ;
+        using pointer = value_type * ;
+        using reference = value_type & ;
 
-        fast_iterator(T const& collection, uint32_t const index) noexcept :
-        m_collection(&collection),
-            m_index(index)
+        fast_iterator(T const& collection, uint32_t const index, uint32_t const batch_size = default_batch_size) noexcept :
+            m_collection(&collection),
+            m_index(index),
+            m_batch_size(batch_size)
         {}
 
         fast_iterator& operator++() noexcept
@@ -23,9 +154,23 @@ namespace winrt::impl
             return*this;
         }
 
-        auto operator*() const
+        value_type operator*() const
         {
-            return m_collection->GetAt(m_index);
+            if constexpr (has_GetMany<T>::value)
+            {
+                // Indexes before the batch wrap around and so also fetch a new one.
+
+                if (m_index - m_batch.first >= m_batch.size)
+                {
+                    fill();
+                }
+
+                return m_batch.data[m_index - m_batch.first];
+            }
+            else
+            {
+                return m_collection->GetAt(m_index);
+            }
         }
 
         bool operator==(fast_iterator const& other) const noexcept
@@ -41,19 +186,22 @@ namespace winrt::impl
 
     private:
 
-        T const* m_collection = nullptr;
-        uint32_t m_index = 0;
-    };
-
-    template <typename T>
-    class has_GetAt
-    {
-        template <typename U, typename = decltype(std::declval<U>().GetAt(0))> static constexpr bool get_value(int) { return true; }
-        template <typename> static constexpr bool get_value(...) { return false; }
+        void fill() const
+        {
+            auto items = m_batch.next(m_batch_size);
+            m_batch.size = m_collection->GetMany(m_index, items);
+            m_batch.first = m_index;
 
-    public:
+            if (m_batch.size == 0)
+            {
+                throw hresult_out_of_bounds();
+            }
+        }
 
-        static constexpr bool value = get_value<T>(0);
+        T const* m_collection = nullptr;
+        uint32_t m_index = 0;
+        uint32_t m_batch_size = default_batch_size;
+        mutable batch_buffer<value_type> m_batch;
     };
 
     template <typename T, std::enable_if_t<!has_GetAt<T>::value>* = nullptr>
@@ -88,10 +236,130 @@ namespace winrt::impl
     }
 
     template <typename T>
+    struct batched_range
+    {
+        // Holds on to the collection, which may be a temporary in the range-for statement.
+
+        T const collection;
+        uint32_t const batch_size;
+
+        auto begin() const
+        {
+            if constexpr (has_GetAt<T>::value)
+            {
+                return fast_iterator<T>(collection, 0, batch_size);
+            }
+            else
+            {
+                return impl::begin(collection);
+            }
+        }
+
+        auto end() const
+        {
+            return impl::end(collection);
+        }
+    };
+
+    template <typename T>
+    struct batched_iterable
+    {
+        // Walks the collection's IIterator with GetMany. The range owns the IIterator and the batch, and
+        // its iterators point to it, so that copies share the position as copies of an IIterator do.
+
+        using iterator_type = decltype(std::declval<T const&>().First());
+        using value_type = decltype(std::declval<iterator_type const&>().Current());
+
+        struct iterator
+        {
+            using iterator_category = std::input_iterator_tag;
+            using value_type = typename batched_iterable::value_type;
+            using difference_type = ptrdiff_t;
+            using pointer = value_type * ;
+            using reference = value_type & ;
+
+            iterator& operator++()
+            {
+                if (!m_range->at_end())
+                {
+                    ++m_range->m_batch.first;
+                }
+
+                return *this;
+            }
+
+            value_type operator*() const
+            {
+                if (m_range->at_end())
+                {
+                    throw hresult_out_of_bounds();
+                }
+
+                return m_range->m_batch.data[m_range->m_batch.first];
+            }
+
+            // An iterator that has run off the end compares equal to end().
+
+            bool operator==(iterator const& other) const
+            {
+                return (!m_range || m_range->at_end()) ? (!other.m_range || other.m_range->at_end()) : m_range == other.m_range;
+            }
+
+            bool operator!=(iterator const& other) const
+            {
+                return !(*this == other);
+            }
+
+            batched_iterable* m_range;
+        };
+
+        batched_iterable(T const& collection, uint32_t const batch_size) :
+            m_iterator(collection.First()),
+            m_batch_size(batch_size)
+        {
+        }
+
+        batched_iterable(batched_iterable const&) = delete;
+        batched_iterable& operator=(batched_iterable const&) = delete;
+
+        iterator begin() noexcept
+        {
+            return { this };
+        }
+
+        iterator end() noexcept
+        {
+            return { nullptr };
+        }
+
+    private:
+
+        bool at_end()
+        {
+            if (m_batch.first == m_batch.size && m_iterator)
+            {
+                auto items = m_batch.next(m_batch_size);
+                m_batch.size = m_iterator.GetMany(items);
+
+                if (m_batch.size == 0)
+                {
+                    m_iterator = nullptr;
+                }
+            }
+
+            return m_batch.first == m_batch.size;
+        }
+
+        iterator_type m_iterator;
+        batch_buffer<value_type> m_batch;
+        uint32_t const m_batch_size;
+    };
+
+    template <typename T, typename Threading = void>
     struct key_value_pair;
 
-    template <typename K, typename V>
-    struct key_value_pair<wfc::IKeyValuePair<K, V>> final : implements<key_value_pair<wfc::IKeyValuePair<K, V>>, wfc::IKeyValuePair<K, V>>
+    template <typename K, typename V, typename Threading>
+    struct key_value_pair<wfc::IKeyValuePair<K, V>, Threading> final : implements<key_value_pair<wfc::IKeyValuePair<K, V>, Threading>, Threading, allocate_with<arena_allocator>, wfc::IKeyValuePair<K, V>>
     {
         key_value_pair(K key, V value) :
             m_key(std::move(key)),
@@ -209,3 +477,25 @@ namespace winrt::impl
         }
     };
 }
+
+WINRT_EXPORT namespace winrt
+{
+    // Iterates a collection with batches of up to the given size, for instance "for (auto&& item :
+    // batched(items, 1024))" for a large collection of small elements. An IIterable is walked with
+    // IIterator::GetMany rather than one element at a time.
+
+    template <typename T>
+    auto batched(T const& collection, uint32_t const batch_size = impl::default_batch_size)
+    {
+        WINRT_ASSERT(batch_size > 0);
+
+        if constexpr (!impl::has_GetAt<T>::value && impl::has_iterator_GetMany<T>::value)
+        {
+            return impl::batched_iterable<T>(collection, batch_size);
+        }
+        else
+        {
+            return impl::batched_range<T>{ collection, batch_size };
+        }
+    }
+}
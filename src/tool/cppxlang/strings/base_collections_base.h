@@ -1,5 +1,5 @@
 
-namespace winrt
+WINRT_EXPORT namespace winrt
 {
     template <typename D, typename T, typename Version = impl::no_collection_version>
     struct iterable_base : Version
@@ -40,7 +40,7 @@ namespace winrt
                     }
                     else
                     {
-                        return make<impl::key_value_pair<T>>(static_cast<D const&>(*this).unwrap_value(value.first), static_cast<D const&>(*this).unwrap_value(value.second));
+                        return make<impl::key_value_pair<T, impl::threading_marker<D>>>(static_cast<D const&>(*this).unwrap_value(value.first), static_cast<D const&>(*this).unwrap_value(value.second));
                     }
                 });
             }
@@ -48,7 +48,7 @@ namespace winrt
 
     private:
 
-        struct iterator final : Version::iterator_type, implements<iterator, Windows::Foundation::Collections::IIterator<T>>
+        struct iterator final : Version::iterator_type, implements<iterator, impl::threading_marker<D>, allocate_with<arena_allocator>, Windows::Foundation::Collections::IIterator<T>>
         {
             void abi_enter()
             {
@@ -82,7 +82,7 @@ namespace winrt
                 }
                 else
                 {
-                    return make<impl::key_value_pair<T>>(m_owner->unwrap_value(m_current->first), m_owner->unwrap_value(m_current->second));
+                    return make<impl::key_value_pair<T, impl::threading_marker<D>>>(m_owner->unwrap_value(m_current->first), m_owner->unwrap_value(m_current->second));
                 }
             }
 
@@ -318,7 +318,7 @@ namespace winrt
             m_changed(static_cast<D const&>(*this), make<args>(change, index));
         }
 
-        struct args final : implements<args, Windows::Foundation::Collections::IVectorChangedEventArgs>
+        struct args final : implements<args, impl::threading_marker<D>, allocate_with<pool_allocator>, Windows::Foundation::Collections::IVectorChangedEventArgs>
         {
             args(Windows::Foundation::Collections::CollectionChange const change, uint32_t const index) noexcept :
                 m_change(change),
@@ -444,7 +444,7 @@ namespace winrt
             m_changed(static_cast<D const&>(*this), make<args>(change, key));
         }
 
-        struct args final : implements<args, Windows::Foundation::Collections::IMapChangedEventArgs<K>>
+        struct args final : implements<args, impl::threading_marker<D>, allocate_with<pool_allocator>, Windows::Foundation::Collections::IMapChangedEventArgs<K>>
         {
             args(Windows::Foundation::Collections::CollectionChange const change, K const& key) noexcept :
                 m_change(change),
@@ -0,0 +1,209 @@
+
+WINRT_EXPORT namespace winrt::impl
+{
+    // multi_threaded_vector and multi_threaded_map keep their values in a concurrent_collection, which takes
+    // a reader/writer lock around them: point reads share it and changes hold it exclusively. The size is
+    // copied to an atomic after every change, so Size needs no lock at all. Iterators walk an immutable
+    // copy of the values that is made on the first First() after a change and shared by every iterator
+    // until the next change, so a long iteration never holds up a writer.
+
+    template <typename Container>
+    struct has_optimistic_reads : std::false_type {};
+
+    template <typename T, typename Allocator>
+    struct has_optimistic_reads<std::vector<T, Allocator>> : std::bool_constant<std::is_trivially_copyable_v<T> && !std::is_same_v<T, bool>> {};
+
+    inline constexpr uint32_t optimistic_read_attempts{ 4 };
+
+    template <typename Container>
+    struct concurrent_collection
+    {
+        using container_type = Container;
+        using value_type = typename Container::value_type;
+
+        // A vector of trivially copyable values can also be read without the lock, under a sequence count
+        // that is odd while a change is being made (a seqlock). A reader copies the value's bytes and keeps
+        // them only if the count has not moved in the meantime. Since the value may be copied while it is
+        // written, the buffers it lives in must stay valid, so the vector grows by moving to a new buffer
+        // of twice the capacity and the old one is kept until the collection is destroyed. That keeps at
+        // most as much memory again as the current capacity.
+
+        static constexpr bool optimistic_reads{ has_optimistic_reads<Container>::value };
+
+        explicit concurrent_collection(Container&& values) :
+            m_values(std::move(values))
+        {
+            publish();
+        }
+
+        concurrent_collection(concurrent_collection const&) = delete;
+        concurrent_collection& operator=(concurrent_collection const&) = delete;
+
+        // The container may only be used from within read or write.
+
+        Container& container() noexcept
+        {
+            return m_values;
+        }
+
+        Container const& container() const noexcept
+        {
+            return m_values;
+        }
+
+        template <typename F>
+        auto read(F&& f) const
+        {
+            slim_shared_lock_guard const guard(m_lock);
+            return f();
+        }
+
+        template <typename F>
+        auto write(F&& f)
+        {
+            // The snapshot the change makes stale is released after the lock, since it may be the last
+            // reference to a copy of every value.
+
+            std::shared_ptr<Container const> stale;
+            slim_lock_guard const guard(m_lock);
+            write_scope const scope(*this);
+            stale = std::move(m_snapshot);
+            return f();
+        }
+
+        uint32_t size() const noexcept
+        {
+            return m_size.load(std::memory_order_acquire);
+        }
+
+        bool try_get(uint32_t const index, value_type& value) const noexcept
+        {
+            static_assert(optimistic_reads);
+
+            // Gives up, so that the caller takes the lock, if a change is under way, if the index is out of
+            // range (which the caller reports), or if the values keep changing under the reader.
+
+            for (uint32_t attempt = 0; attempt != optimistic_read_attempts; ++attempt)
+            {
+                uint32_t const sequence = m_sequence.load(std::memory_order_acquire);
+
+                if (sequence & 1)
+                {
+                    return false;
+                }
+
+                value_type const* const data = m_data.load(std::memory_order_relaxed);
+
+                if (index >= m_size.load(std::memory_order_relaxed))
+                {
+                    return false;
+                }
+
+                // The value is copied as bytes, since a change may be writing it at the same time, and
+                // only becomes a value_type once the sequence shows that it was not torn. The fence keeps
+                // the copy from moving past the second load of the sequence.
+
+                alignas(value_type) unsigned char copy[sizeof(value_type)];
+                std::memcpy(copy, data + index, sizeof(value_type));
+                std::atomic_thread_fence(std::memory_order_acquire);
+
+                if (m_sequence.load(std::memory_order_relaxed) == sequence)
+                {
+                    std::memcpy(&value, copy, sizeof(value_type));
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        void reserve(size_t const capacity)
+        {
+            // Called from within write before a change that may grow the container.
+
+            if constexpr (optimistic_reads)
+            {
+                if (capacity > m_values.capacity())
+                {
+                    Container values(m_values.get_allocator());
+                    values.reserve((std::max)(capacity, m_values.capacity() * 2));
+                    values.assign(m_values.begin(), m_values.end());
+                    m_retired.push_back(std::move(m_values));
+                    m_values = std::move(values);
+                }
+            }
+        }
+
+        std::shared_ptr<Container const> snapshot() const
+        {
+            // The copy is made under the shared lock, so that readers carry on while it is made, and only
+            // kept for the next caller if no change was made before it could be stored.
+
+            std::shared_ptr<Container const> result;
+            uint32_t sequence{};
+
+            {
+                slim_shared_lock_guard const guard(m_lock);
+
+                if (m_snapshot)
+                {
+                    return m_snapshot;
+                }
+
+                sequence = m_sequence.load(std::memory_order_relaxed);
+                result = std::make_shared<Container const>(m_values);
+            }
+
+            slim_lock_guard const guard(m_lock);
+
+            if (!m_snapshot && m_sequence.load(std::memory_order_relaxed) == sequence)
+            {
+                m_snapshot = result;
+            }
+
+            return result;
+        }
+
+    private:
+
+        struct write_scope
+        {
+            explicit write_scope(concurrent_collection& owner) noexcept : m_owner(owner)
+            {
+                m_owner.m_sequence.store(m_owner.m_sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+            }
+
+            ~write_scope() noexcept
+            {
+                m_owner.publish();
+                m_owner.m_sequence.store(m_owner.m_sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+            }
+
+            write_scope(write_scope const&) = delete;
+            write_scope& operator=(write_scope const&) = delete;
+
+        private:
+
+            concurrent_collection& m_owner;
+        };
+
+        void publish() noexcept
+        {
+            if constexpr (optimistic_reads)
+            {
+                m_data.store(m_values.data(), std::memory_order_relaxed);
+            }
+
+            m_size.store(static_cast<uint32_t>(m_values.size()), std::memory_order_release);
+        }
+
+        Container m_values;
+        mutable slim_mutex m_lock;
+        mutable std::shared_ptr<Container const> m_snapshot;
+        std::atomic<uint32_t> m_sequence{};
+        std::atomic<uint32_t> m_size{};
+        std::atomic<value_type const*> m_data{};
+        std::vector<Container> m_retired;
+    };
+}
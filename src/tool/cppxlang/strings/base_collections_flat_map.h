@@ -0,0 +1,700 @@
+
+WINRT_EXPORT namespace winrt
+{
+    // Maps that are mostly looked up, such as property bags and resource tables, spend their time chasing the
+    // nodes of a std::map or std::unordered_map. flat_map keeps its pairs sorted in one vector, which suits
+    // small or rarely changed maps, and flat_hash_map keeps them in one open-addressed table, which suits
+    // large ones. Both provide the part of the std::map interface that the collection implementations use,
+    // so either can back single_threaded_map, single_threaded_observable_map and the map parameters.
+
+    template <typename K, typename V, typename Compare = std::less<K>, typename Allocator = std::allocator<std::pair<K, V>>>
+    struct flat_map
+    {
+        using key_type = K;
+        using mapped_type = V;
+        using value_type = std::pair<K, V>;
+        using key_compare = Compare;
+        using container_type = std::vector<value_type, Allocator>;
+        using size_type = typename container_type::size_type;
+        using difference_type = typename container_type::difference_type;
+        using iterator = typename container_type::iterator;
+        using const_iterator = typename container_type::const_iterator;
+
+        flat_map() = default;
+
+        explicit flat_map(Compare const& compare, Allocator const& allocator = Allocator()) :
+            m_values(allocator),
+            m_compare(compare)
+        {
+        }
+
+        template <typename InputIt>
+        flat_map(InputIt first, InputIt last, Compare const& compare = Compare(), Allocator const& allocator = Allocator()) :
+            m_values(first, last, allocator),
+            m_compare(compare)
+        {
+            // As with std::map, the first of several equal keys is kept.
+
+            std::stable_sort(m_values.begin(), m_values.end(), [&](value_type const& left, value_type const& right)
+            {
+                return m_compare(left.first, right.first);
+            });
+
+            m_values.erase(std::unique(m_values.begin(), m_values.end(), [&](value_type const& left, value_type const& right)
+            {
+                return !m_compare(left.first, right.first);
+            }), m_values.end());
+        }
+
+        flat_map(std::initializer_list<value_type> values, Compare const& compare = Compare(), Allocator const& allocator = Allocator()) :
+            flat_map(values.begin(), values.end(), compare, allocator)
+        {
+        }
+
+        iterator begin() noexcept { return m_values.begin(); }
+        const_iterator begin() const noexcept { return m_values.begin(); }
+        const_iterator cbegin() const noexcept { return m_values.begin(); }
+        iterator end() noexcept { return m_values.end(); }
+        const_iterator end() const noexcept { return m_values.end(); }
+        const_iterator cend() const noexcept { return m_values.end(); }
+
+        bool empty() const noexcept
+        {
+            return m_values.empty();
+        }
+
+        size_type size() const noexcept
+        {
+            return m_values.size();
+        }
+
+        void reserve(size_type const count)
+        {
+            m_values.reserve(count);
+        }
+
+        void clear() noexcept
+        {
+            m_values.clear();
+        }
+
+        iterator lower_bound(K const& key)
+        {
+            // For scalar keys, halving without a data-dependent branch lets the compiler use a conditional
+            // move, where the branches of std::lower_bound are mispredicted about half the time for random
+            // keys. Other keys take longer to compare than a mispredicted branch, so they use std::lower_bound.
+
+            if constexpr (std::is_scalar_v<K>)
+            {
+                if (m_values.empty())
+                {
+                    return m_values.end();
+                }
+
+                auto first = m_values.begin();
+                size_type length = m_values.size();
+
+                while (length > 1)
+                {
+                    size_type const half = length / 2;
+                    first = m_compare(first[half].first, key) ? first + half : first;
+                    length -= half;
+                }
+
+                return first + m_compare(first->first, key);
+            }
+            else
+            {
+                return std::lower_bound(m_values.begin(), m_values.end(), key, [&](value_type const& left, K const& right)
+                {
+                    return m_compare(left.first, right);
+                });
+            }
+        }
+
+        const_iterator lower_bound(K const& key) const
+        {
+            return const_cast<flat_map&>(*this).lower_bound(key);
+        }
+
+        iterator find(K const& key)
+        {
+            auto result = lower_bound(key);
+
+            if (result != m_values.end() && !m_compare(key, result->first))
+            {
+                return result;
+            }
+
+            return m_values.end();
+        }
+
+        const_iterator find(K const& key) const
+        {
+            return const_cast<flat_map&>(*this).find(key);
+        }
+
+        size_type count(K const& key) const
+        {
+            return find(key) != end();
+        }
+
+        template <typename... Args>
+        std::pair<iterator, bool> try_emplace(K const& key, Args&&... args)
+        {
+            auto position = lower_bound(key);
+
+            if (position != m_values.end() && !m_compare(key, position->first))
+            {
+                return { position, false };
+            }
+
+            return { m_values.emplace(position, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...)), true };
+        }
+
+        std::pair<iterator, bool> insert(value_type const& value)
+        {
+            return try_emplace(value.first, value.second);
+        }
+
+        template <typename M>
+        std::pair<iterator, bool> insert_or_assign(K const& key, M&& value)
+        {
+            auto result = try_emplace(key, std::forward<M>(value));
+
+            if (!result.second)
+            {
+                result.first->second = std::forward<M>(value);
+            }
+
+            return result;
+        }
+
+        V& operator[](K const& key)
+        {
+            return try_emplace(key).first->second;
+        }
+
+        V& at(K const& key)
+        {
+            auto result = find(key);
+
+            if (result == m_values.end())
+            {
+                throw std::out_of_range("Invalid map key");
+            }
+
+            return result->second;
+        }
+
+        V const& at(K const& key) const
+        {
+            return const_cast<flat_map&>(*this).at(key);
+        }
+
+        iterator erase(const_iterator position)
+        {
+            return m_values.erase(position);
+        }
+
+        size_type erase(K const& key)
+        {
+            auto position = find(key);
+
+            if (position == m_values.end())
+            {
+                return 0;
+            }
+
+            m_values.erase(position);
+            return 1;
+        }
+
+    private:
+
+        container_type m_values;
+        Compare m_compare;
+    };
+
+    template <typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>, typename Allocator = std::allocator<std::pair<K const, V>>>
+    struct flat_hash_map
+    {
+        using key_type = K;
+        using mapped_type = V;
+        using value_type = std::pair<K const, V>;
+        using hasher = Hash;
+        using key_equal = KeyEqual;
+        using allocator_type = Allocator;
+        using size_type = size_t;
+        using difference_type = ptrdiff_t;
+
+    private:
+
+        // Each slot has a control byte: empty, deleted, or the top bit set along with seven bits of the hash,
+        // so that a probe only compares keys whose hash bits match. The hash is multiplied by the golden ratio,
+        // which mixes poor hashes such as the identity hash that std::hash uses for integers, and probing is
+        // linear from the slot picked by its top bits. Erasing leaves a deleted marker behind, and the
+        // table is rebuilt when full and deleted slots reach seven eighths of the capacity.
+
+        static constexpr uint8_t empty_slot{ 0 };
+        static constexpr uint8_t deleted_slot{ 1 };
+        static constexpr uint8_t full_slot{ 0x80 };
+        static constexpr size_t min_capacity{ 16 };
+
+        using allocator_traits = std::allocator_traits<Allocator>;
+        using control_allocator = typename allocator_traits::template rebind_alloc<uint8_t>;
+        using control_traits = std::allocator_traits<control_allocator>;
+
+        template <bool Const>
+        struct iterator_base
+        {
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = flat_hash_map::value_type;
+            using difference_type = ptrdiff_t;
+            using pointer = std::conditional_t<Const, value_type const*, value_type*>;
+            using reference = std::conditional_t<Const, value_type const&, value_type&>;
+
+            iterator_base() noexcept = default;
+
+            iterator_base(uint8_t const* control, value_type* slot, uint8_t const* end) noexcept :
+                m_control(control),
+                m_slot(slot),
+                m_end(end)
+            {
+                skip_free();
+            }
+
+            template <bool OtherConst, std::enable_if_t<Const && !OtherConst>* = nullptr>
+            iterator_base(iterator_base<OtherConst> const& other) noexcept :
+                m_control(other.m_control),
+                m_slot(other.m_slot),
+                m_end(other.m_end)
+            {
+            }
+
+            reference operator*() const noexcept
+            {
+                return *m_slot;
+            }
+
+            pointer operator->() const noexcept
+            {
+                return m_slot;
+            }
+
+            iterator_base& operator++() noexcept
+            {
+                ++m_control;
+                ++m_slot;
+                skip_free();
+                return *this;
+            }
+
+            iterator_base operator++(int) noexcept
+            {
+                auto previous = *this;
+                ++*this;
+                return previous;
+            }
+
+            bool operator==(iterator_base const& other) const noexcept
+            {
+                return m_control == other.m_control;
+            }
+
+            bool operator!=(iterator_base const& other) const noexcept
+            {
+                return !(*this == other);
+            }
+
+        private:
+
+            void skip_free() noexcept
+            {
+                while (m_control != m_end && *m_control < full_slot)
+                {
+                    ++m_control;
+                    ++m_slot;
+                }
+            }
+
+            uint8_t const* m_control{};
+            value_type* m_slot{};
+            uint8_t const* m_end{};
+
+            template <bool>
+            friend struct iterator_base;
+
+            friend struct flat_hash_map;
+        };
+
+    public:
+
+        using iterator = iterator_base<false>;
+        using const_iterator = iterator_base<true>;
+
+        flat_hash_map() = default;
+
+        explicit flat_hash_map(size_type const count, Hash const& hash = Hash(), KeyEqual const& equal = KeyEqual(), Allocator const& allocator = Allocator()) :
+            m_hash(hash),
+            m_equal(equal),
+            m_allocator(allocator)
+        {
+            reserve(count);
+        }
+
+        template <typename InputIt>
+        flat_hash_map(InputIt first, InputIt last, size_type const count = 0, Hash const& hash = Hash(), KeyEqual const& equal = KeyEqual(), Allocator const& allocator = Allocator()) :
+            flat_hash_map(count, hash, equal, allocator)
+        {
+            for (; first != last; ++first)
+            {
+                insert(*first);
+            }
+        }
+
+        flat_hash_map(std::initializer_list<value_type> values, size_type const count = 0, Hash const& hash = Hash(), KeyEqual const& equal = KeyEqual(), Allocator const& allocator = Allocator()) :
+            flat_hash_map(values.begin(), values.end(), count, hash, equal, allocator)
+        {
+        }
+
+        flat_hash_map(flat_hash_map const& other) :
+            flat_hash_map(other.begin(), other.end(), other.size(), other.m_hash, other.m_equal, allocator_traits::select_on_container_copy_construction(other.m_allocator))
+        {
+        }
+
+        flat_hash_map(flat_hash_map&& other) noexcept :
+            m_hash(std::move(other.m_hash)),
+            m_equal(std::move(other.m_equal)),
+            m_allocator(std::move(other.m_allocator)),
+            m_control(std::exchange(other.m_control, nullptr)),
+            m_slots(std::exchange(other.m_slots, nullptr)),
+            m_capacity(std::exchange(other.m_capacity, 0)),
+            m_size(std::exchange(other.m_size, 0)),
+            m_deleted(std::exchange(other.m_deleted, 0)),
+            m_shift(std::exchange(other.m_shift, 0))
+        {
+        }
+
+        flat_hash_map& operator=(flat_hash_map other) noexcept
+        {
+            swap(other);
+            return *this;
+        }
+
+        ~flat_hash_map() noexcept
+        {
+            destroy();
+        }
+
+        void swap(flat_hash_map& other) noexcept
+        {
+            std::swap(m_hash, other.m_hash);
+            std::swap(m_equal, other.m_equal);
+            std::swap(m_allocator, other.m_allocator);
+            std::swap(m_control, other.m_control);
+            std::swap(m_slots, other.m_slots);
+            std::swap(m_capacity, other.m_capacity);
+            std::swap(m_size, other.m_size);
+            std::swap(m_deleted, other.m_deleted);
+            std::swap(m_shift, other.m_shift);
+        }
+
+        iterator begin() noexcept { return { m_control, m_slots, m_control + m_capacity }; }
+        const_iterator begin() const noexcept { return { m_control, m_slots, m_control + m_capacity }; }
+        const_iterator cbegin() const noexcept { return begin(); }
+        iterator end() noexcept { return { m_control + m_capacity, m_slots + m_capacity, m_control + m_capacity }; }
+        const_iterator end() const noexcept { return { m_control + m_capacity, m_slots + m_capacity, m_control + m_capacity }; }
+        const_iterator cend() const noexcept { return end(); }
+
+        bool empty() const noexcept
+        {
+            return m_size == 0;
+        }
+
+        size_type size() const noexcept
+        {
+            return m_size;
+        }
+
+        void reserve(size_type const count)
+        {
+            if (count * 8 > m_capacity * 7)
+            {
+                rehash(count);
+            }
+        }
+
+        void clear() noexcept
+        {
+            for (size_t index = 0; index != m_capacity; ++index)
+            {
+                if (m_control[index] >= full_slot)
+                {
+                    allocator_traits::destroy(m_allocator, m_slots + index);
+                }
+
+                m_control[index] = empty_slot;
+            }
+
+            m_size = 0;
+            m_deleted = 0;
+        }
+
+        iterator find(K const& key)
+        {
+            size_t const index = find_index(key);
+            return index == m_capacity ? end() : make_iterator(index);
+        }
+
+        const_iterator find(K const& key) const
+        {
+            return const_cast<flat_hash_map&>(*this).find(key);
+        }
+
+        size_type count(K const& key) const
+        {
+            return find_index(key) != m_capacity;
+        }
+
+        template <typename... Args>
+        std::pair<iterator, bool> try_emplace(K const& key, Args&&... args)
+        {
+            uint64_t const hash = mix(key);
+            size_t index = find_index(key, hash);
+
+            if (index != m_capacity)
+            {
+                return { make_iterator(index), false };
+            }
+
+            if ((m_size + m_deleted + 1) * 8 > m_capacity * 7)
+            {
+                rehash(m_size + 1);
+            }
+
+            index = free_index(hash);
+            allocator_traits::construct(m_allocator, m_slots + index, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+            m_deleted -= m_control[index] == deleted_slot;
+            m_control[index] = control_of(hash);
+            ++m_size;
+            return { make_iterator(index), true };
+        }
+
+        std::pair<iterator, bool> insert(value_type const& value)
+        {
+            return try_emplace(value.first, value.second);
+        }
+
+        template <typename M>
+        std::pair<iterator, bool> insert_or_assign(K const& key, M&& value)
+        {
+            auto result = try_emplace(key, std::forward<M>(value));
+
+            if (!result.second)
+            {
+                result.first->second = std::forward<M>(value);
+            }
+
+            return result;
+        }
+
+        V& operator[](K const& key)
+        {
+            return try_emplace(key).first->second;
+        }
+
+        V& at(K const& key)
+        {
+            size_t const index = find_index(key);
+
+            if (index == m_capacity)
+            {
+                throw std::out_of_range("Invalid map key");
+            }
+
+            return m_slots[index].second;
+        }
+
+        V const& at(K const& key) const
+        {
+            return const_cast<flat_hash_map&>(*this).at(key);
+        }
+
+        iterator erase(const_iterator position) noexcept
+        {
+            size_t const index = position.m_control - m_control;
+            erase_index(index);
+            return make_iterator(index + 1);
+        }
+
+        size_type erase(K const& key)
+        {
+            size_t const index = find_index(key);
+
+            if (index == m_capacity)
+            {
+                return 0;
+            }
+
+            erase_index(index);
+            return 1;
+        }
+
+    private:
+
+        uint64_t mix(K const& key) const
+        {
+            return static_cast<uint64_t>(m_hash(key)) * 0x9E3779B97F4A7C15ull;
+        }
+
+        uint8_t control_of(uint64_t const hash) const noexcept
+        {
+            return static_cast<uint8_t>(full_slot | ((hash >> (m_shift - 7)) & 0x7F));
+        }
+
+        size_t home_of(uint64_t const hash) const noexcept
+        {
+            return static_cast<size_t>(hash >> m_shift);
+        }
+
+        iterator make_iterator(size_t const index) noexcept
+        {
+            return { m_control + index, m_slots + index, m_control + m_capacity };
+        }
+
+        size_t find_index(K const& key) const
+        {
+            return m_capacity == 0 ? 0 : find_index(key, mix(key));
+        }
+
+        size_t find_index(K const& key, uint64_t const hash) const
+        {
+            if (m_capacity == 0)
+            {
+                return 0;
+            }
+
+            uint8_t const control = control_of(hash);
+            size_t const mask = m_capacity - 1;
+
+            for (size_t index = home_of(hash);; index = (index + 1) & mask)
+            {
+                if (m_control[index] == control && m_equal(m_slots[index].first, key))
+                {
+                    return index;
+                }
+
+                if (m_control[index] == empty_slot)
+                {
+                    return m_capacity;
+                }
+            }
+        }
+
+        size_t free_index(uint64_t const hash) const noexcept
+        {
+            size_t const mask = m_capacity - 1;
+            size_t index = home_of(hash);
+
+            while (m_control[index] >= full_slot)
+            {
+                index = (index + 1) & mask;
+            }
+
+            return index;
+        }
+
+        void erase_index(size_t const index) noexcept
+        {
+            allocator_traits::destroy(m_allocator, m_slots + index);
+            --m_size;
+
+            // A slot followed by an empty one ends every probe sequence through it, so it can be emptied
+            // rather than marked as deleted.
+
+            if (m_control[(index + 1) & (m_capacity - 1)] == empty_slot)
+            {
+                m_control[index] = empty_slot;
+            }
+            else
+            {
+                m_control[index] = deleted_slot;
+                ++m_deleted;
+            }
+        }
+
+        void rehash(size_t const count)
+        {
+            size_t capacity = min_capacity;
+            uint32_t shift = 60;
+
+            while (count * 8 > capacity * 7)
+            {
+                capacity *= 2;
+                --shift;
+            }
+
+            control_allocator control_allocator(m_allocator);
+            uint8_t* const control = control_traits::allocate(control_allocator, capacity);
+            value_type* slots;
+
+            try
+            {
+                slots = allocator_traits::allocate(m_allocator, capacity);
+            }
+            catch (...)
+            {
+                control_traits::deallocate(control_allocator, control, capacity);
+                throw;
+            }
+
+            std::fill_n(control, capacity, empty_slot);
+            flat_hash_map table;
+            table.m_control = control;
+            table.m_slots = slots;
+            table.m_capacity = capacity;
+            table.m_shift = shift;
+            table.m_allocator = m_allocator;
+            table.m_hash = m_hash;
+            table.m_equal = m_equal;
+
+            for (size_t index = 0; index != m_capacity; ++index)
+            {
+                if (m_control[index] >= full_slot)
+                {
+                    uint64_t const hash = table.mix(m_slots[index].first);
+                    size_t const target = table.free_index(hash);
+                    allocator_traits::construct(m_allocator, slots + target, std::move(m_slots[index]));
+                    table.m_control[target] = table.control_of(hash);
+                    ++table.m_size;
+                }
+            }
+
+            swap(table);
+        }
+
+        void destroy() noexcept
+        {
+            if (m_capacity == 0)
+            {
+                return;
+            }
+
+            clear();
+            control_allocator control_allocator(m_allocator);
+            control_traits::deallocate(control_allocator, m_control, m_capacity);
+            allocator_traits::deallocate(m_allocator, m_slots, m_capacity);
+        }
+
+        Hash m_hash;
+        KeyEqual m_equal;
+        Allocator m_allocator;
+        uint8_t* m_control{};
+        value_type* m_slots{};
+        size_t m_capacity{};
+        size_t m_size{};
+        size_t m_deleted{};
+        uint32_t m_shift{};
+    };
+}
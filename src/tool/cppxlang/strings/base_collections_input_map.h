@@ -1,5 +1,5 @@
 
-namespace winrt::impl
+WINRT_EXPORT namespace winrt::impl
 {
     template <typename K, typename V, typename Container>
     struct input_map final :
@@ -34,7 +34,7 @@ namespace winrt::impl
     }
 }
 
-namespace winrt::param
+WINRT_EXPORT namespace winrt::param
 {
     template <typename K, typename V>
     struct map
@@ -72,6 +72,18 @@ namespace winrt::param
         {
         }
 
+        template <typename Compare, typename Allocator>
+        map(flat_map<K, V, Compare, Allocator>&& values) :
+            m_interface(impl::make_input_map<K, V>(std::move(values)))
+        {
+        }
+
+        template <typename Hash, typename KeyEqual, typename Allocator>
+        map(flat_hash_map<K, V, Hash, KeyEqual, Allocator>&& values) :
+            m_interface(impl::make_input_map<K, V>(std::move(values)))
+        {
+        }
+
         map(std::initializer_list<std::pair<K const, V>> values) :
             m_interface(impl::make_input_map<K, V>(std::map<K, V>(values)))
         {
@@ -1,5 +1,5 @@
 
-namespace winrt::impl
+WINRT_EXPORT namespace winrt::impl
 {
     template <typename K, typename V, typename Container>
     struct input_map_view final :
@@ -65,7 +65,7 @@ namespace winrt::impl
     }
 }
 
-namespace winrt::param
+WINRT_EXPORT namespace winrt::param
 {
     template <typename K, typename V>
     struct map_view
@@ -111,6 +111,26 @@ namespace winrt::param
         {
         }
 
+        template <typename Compare, typename Allocator>
+        map_view(flat_map<K, V, Compare, Allocator>&& values) : m_pair(impl::make_input_map_view<K, V>(std::move(values)), nullptr)
+        {
+        }
+
+        template <typename Compare, typename Allocator>
+        map_view(flat_map<K, V, Compare, Allocator> const& values) : m_pair(impl::make_scoped_input_map_view<K, V>(values))
+        {
+        }
+
+        template <typename Hash, typename KeyEqual, typename Allocator>
+        map_view(flat_hash_map<K, V, Hash, KeyEqual, Allocator>&& values) : m_pair(impl::make_input_map_view<K, V>(std::move(values)), nullptr)
+        {
+        }
+
+        template <typename Hash, typename KeyEqual, typename Allocator>
+        map_view(flat_hash_map<K, V, Hash, KeyEqual, Allocator> const& values) : m_pair(impl::make_scoped_input_map_view<K, V>(values))
+        {
+        }
+
         map_view(std::initializer_list<std::pair<K const, V>> values) : m_pair(impl::make_input_map_view<K, V>(std::map<K, V>(values)), nullptr)
         {
         }
@@ -176,6 +196,18 @@ namespace winrt::param
         {
         }
 
+        template <typename Compare, typename Allocator>
+        async_map_view(flat_map<K, V, Compare, Allocator>&& values) :
+            m_interface(impl::make_input_map_view<K, V>(std::move(values)))
+        {
+        }
+
+        template <typename Hash, typename KeyEqual, typename Allocator>
+        async_map_view(flat_hash_map<K, V, Hash, KeyEqual, Allocator>&& values) :
+            m_interface(impl::make_input_map_view<K, V>(std::move(values)))
+        {
+        }
+
         async_map_view(std::initializer_list<std::pair<K const, V>> values) :
             m_interface(impl::make_input_map_view<K, V>(std::map<K, V>(values)))
         {
@@ -1,5 +1,5 @@
 
-namespace winrt::impl
+WINRT_EXPORT namespace winrt::impl
 {
     template <typename T, typename Container>
     struct input_vector final :
@@ -28,7 +28,7 @@ namespace winrt::impl
     };
 }
 
-namespace winrt::param
+WINRT_EXPORT namespace winrt::param
 {
     template <typename T>
     struct vector
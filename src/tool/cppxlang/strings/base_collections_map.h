@@ -1,5 +1,5 @@
 
-namespace winrt::impl
+WINRT_EXPORT namespace winrt::impl
 {
     template <typename K, typename V, typename Container>
     struct observable_map final :
@@ -26,9 +26,45 @@ namespace winrt::impl
 
         Container m_values;
     };
+
+    template <typename K, typename V, typename Container>
+    struct multi_threaded_map final :
+        implements<multi_threaded_map<K, V, Container>, wfc::IMap<K, V>, wfc::IMapView<K, V>, wfc::IIterable<wfc::IKeyValuePair<K, V>>>,
+        multi_threaded_map_base<multi_threaded_map<K, V, Container>, K, V>
+    {
+        static_assert(std::is_same_v<Container, std::remove_reference_t<Container>>, "Must be constructed with rvalue.");
+
+        explicit multi_threaded_map(Container&& values) : m_values(std::forward<Container>(values))
+        {
+        }
+
+        auto& get_container() noexcept
+        {
+            return m_values.container();
+        }
+
+        auto& get_container() const noexcept
+        {
+            return m_values.container();
+        }
+
+        auto& get_collection() noexcept
+        {
+            return m_values;
+        }
+
+        auto& get_collection() const noexcept
+        {
+            return m_values;
+        }
+
+    private:
+
+        concurrent_collection<Container> m_values;
+    };
 }
 
-namespace winrt
+WINRT_EXPORT namespace winrt
 {
     template <typename K, typename V, typename Compare = std::less<K>, typename Allocator = std::allocator<std::pair<K const, V>>>
     Windows::Foundation::Collections::IMap<K, V> single_threaded_map()
@@ -48,6 +84,18 @@ namespace winrt
         return make<impl::input_map<K, V, std::unordered_map<K, V, Hash, KeyEqual, Allocator>>>(std::move(values));
     }
 
+    template <typename K, typename V, typename Compare, typename Allocator>
+    Windows::Foundation::Collections::IMap<K, V> single_threaded_map(flat_map<K, V, Compare, Allocator>&& values)
+    {
+        return make<impl::input_map<K, V, flat_map<K, V, Compare, Allocator>>>(std::move(values));
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+    Windows::Foundation::Collections::IMap<K, V> single_threaded_map(flat_hash_map<K, V, Hash, KeyEqual, Allocator>&& values)
+    {
+        return make<impl::input_map<K, V, flat_hash_map<K, V, Hash, KeyEqual, Allocator>>>(std::move(values));
+    }
+
     template <typename K, typename V, typename Compare = std::less<K>, typename Allocator = std::allocator<std::pair<K const, V>>>
     Windows::Foundation::Collections::IObservableMap<K, V> single_threaded_observable_map()
     {
@@ -65,4 +113,46 @@ namespace winrt
     {
         return make<impl::observable_map<K, V, std::unordered_map<K, V, Hash, KeyEqual, Allocator>>>(std::move(values));
     }
+
+    template <typename K, typename V, typename Compare, typename Allocator>
+    Windows::Foundation::Collections::IObservableMap<K, V> single_threaded_observable_map(flat_map<K, V, Compare, Allocator>&& values)
+    {
+        return make<impl::observable_map<K, V, flat_map<K, V, Compare, Allocator>>>(std::move(values));
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+    Windows::Foundation::Collections::IObservableMap<K, V> single_threaded_observable_map(flat_hash_map<K, V, Hash, KeyEqual, Allocator>&& values)
+    {
+        return make<impl::observable_map<K, V, flat_hash_map<K, V, Hash, KeyEqual, Allocator>>>(std::move(values));
+    }
+
+    template <typename K, typename V, typename Compare = std::less<K>, typename Allocator = std::allocator<std::pair<K const, V>>>
+    Windows::Foundation::Collections::IMap<K, V> multi_threaded_map()
+    {
+        return make<impl::multi_threaded_map<K, V, std::map<K, V, Compare, Allocator>>>(std::map<K, V, Compare, Allocator>{});
+    }
+
+    template <typename K, typename V, typename Compare = std::less<K>, typename Allocator = std::allocator<std::pair<K const, V>>>
+    Windows::Foundation::Collections::IMap<K, V> multi_threaded_map(std::map<K, V, Compare, Allocator>&& values)
+    {
+        return make<impl::multi_threaded_map<K, V, std::map<K, V, Compare, Allocator>>>(std::move(values));
+    }
+
+    template <typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>, typename Allocator = std::allocator<std::pair<K const, V>>>
+    Windows::Foundation::Collections::IMap<K, V> multi_threaded_map(std::unordered_map<K, V, Hash, KeyEqual, Allocator>&& values)
+    {
+        return make<impl::multi_threaded_map<K, V, std::unordered_map<K, V, Hash, KeyEqual, Allocator>>>(std::move(values));
+    }
+
+    template <typename K, typename V, typename Compare, typename Allocator>
+    Windows::Foundation::Collections::IMap<K, V> multi_threaded_map(flat_map<K, V, Compare, Allocator>&& values)
+    {
+        return make<impl::multi_threaded_map<K, V, flat_map<K, V, Compare, Allocator>>>(std::move(values));
+    }
+
+    template <typename K, typename V, typename Hash, typename KeyEqual, typename Allocator>
+    Windows::Foundation::Collections::IMap<K, V> multi_threaded_map(flat_hash_map<K, V, Hash, KeyEqual, Allocator>&& values)
+    {
+        return make<impl::multi_threaded_map<K, V, flat_hash_map<K, V, Hash, KeyEqual, Allocator>>>(std::move(values));
+    }
 }
@@ -0,0 +1,206 @@
+
+WINRT_EXPORT namespace winrt::impl
+{
+    // Iterates a snapshot of a multi-threaded collection, which stays alive as long as any of its iterators.
+
+    template <typename T, typename Container>
+    struct snapshot_iterable final :
+        implements<snapshot_iterable<T, Container>, no_weak_ref, allocate_with<pool_allocator>, wfc::IIterable<T>>,
+        iterable_base<snapshot_iterable<T, Container>, T>
+    {
+        explicit snapshot_iterable(std::shared_ptr<Container const>&& values) noexcept : m_values(std::move(values))
+        {
+        }
+
+        auto& get_container() const noexcept
+        {
+            return *m_values;
+        }
+
+    private:
+
+        std::shared_ptr<Container const> const m_values;
+    };
+
+    template <typename T, typename Container>
+    auto make_snapshot_iterator(std::shared_ptr<Container const>&& values)
+    {
+        return make_self<snapshot_iterable<T, Container>>(std::move(values))->First();
+    }
+}
+
+WINRT_EXPORT namespace winrt
+{
+    // The derived class keeps its values in an impl::concurrent_collection, returned by get_collection, and
+    // get_container returns the values themselves for the methods of vector_base, which are only called
+    // here under the collection's lock.
+
+    template <typename D, typename T>
+    struct multi_threaded_vector_base : vector_base<D, T>
+    {
+        auto First()
+        {
+            return impl::make_snapshot_iterator<T>(static_cast<D const&>(*this).get_collection().snapshot());
+        }
+
+        T GetAt(uint32_t const index) const
+        {
+            auto& collection = static_cast<D const&>(*this).get_collection();
+
+            if constexpr (std::decay_t<decltype(collection)>::optimistic_reads)
+            {
+                T value{};
+
+                if (collection.try_get(index, value))
+                {
+                    return value;
+                }
+            }
+
+            return collection.read([&]
+            {
+                return vector_base<D, T>::GetAt(index);
+            });
+        }
+
+        uint32_t Size() const noexcept
+        {
+            return static_cast<D const&>(*this).get_collection().size();
+        }
+
+        bool IndexOf(T const& value, uint32_t& index) const noexcept
+        {
+            return static_cast<D const&>(*this).get_collection().read([&]
+            {
+                return vector_base<D, T>::IndexOf(value, index);
+            });
+        }
+
+        uint32_t GetMany(uint32_t const startIndex, array_view<T> values) const
+        {
+            return static_cast<D const&>(*this).get_collection().read([&]
+            {
+                return vector_base<D, T>::GetMany(startIndex, values);
+            });
+        }
+
+        void SetAt(uint32_t const index, T const& value)
+        {
+            static_cast<D&>(*this).get_collection().write([&]
+            {
+                vector_base<D, T>::SetAt(index, value);
+            });
+        }
+
+        void InsertAt(uint32_t const index, T const& value)
+        {
+            auto& collection = static_cast<D&>(*this).get_collection();
+
+            collection.write([&]
+            {
+                collection.reserve(collection.container().size() + 1);
+                vector_base<D, T>::InsertAt(index, value);
+            });
+        }
+
+        void RemoveAt(uint32_t const index)
+        {
+            static_cast<D&>(*this).get_collection().write([&]
+            {
+                vector_base<D, T>::RemoveAt(index);
+            });
+        }
+
+        void Append(T const& value)
+        {
+            auto& collection = static_cast<D&>(*this).get_collection();
+
+            collection.write([&]
+            {
+                collection.reserve(collection.container().size() + 1);
+                vector_base<D, T>::Append(value);
+            });
+        }
+
+        void RemoveAtEnd()
+        {
+            static_cast<D&>(*this).get_collection().write([&]
+            {
+                vector_base<D, T>::RemoveAtEnd();
+            });
+        }
+
+        void Clear() noexcept
+        {
+            static_cast<D&>(*this).get_collection().write([&]
+            {
+                vector_base<D, T>::Clear();
+            });
+        }
+
+        void ReplaceAll(array_view<T const> value)
+        {
+            auto& collection = static_cast<D&>(*this).get_collection();
+
+            collection.write([&]
+            {
+                collection.reserve(value.size());
+                vector_base<D, T>::ReplaceAll(value);
+            });
+        }
+    };
+
+    template <typename D, typename K, typename V>
+    struct multi_threaded_map_base : map_base<D, K, V>
+    {
+        auto First()
+        {
+            return impl::make_snapshot_iterator<Windows::Foundation::Collections::IKeyValuePair<K, V>>(static_cast<D const&>(*this).get_collection().snapshot());
+        }
+
+        V Lookup(K const& key) const
+        {
+            return static_cast<D const&>(*this).get_collection().read([&]
+            {
+                return map_base<D, K, V>::Lookup(key);
+            });
+        }
+
+        uint32_t Size() const noexcept
+        {
+            return static_cast<D const&>(*this).get_collection().size();
+        }
+
+        bool HasKey(K const& key) const noexcept
+        {
+            return static_cast<D const&>(*this).get_collection().read([&]
+            {
+                return map_base<D, K, V>::HasKey(key);
+            });
+        }
+
+        bool Insert(K const& key, V const& value)
+        {
+            return static_cast<D&>(*this).get_collection().write([&]
+            {
+                return map_base<D, K, V>::Insert(key, value);
+            });
+        }
+
+        void Remove(K const& key)
+        {
+            static_cast<D&>(*this).get_collection().write([&]
+            {
+                map_base<D, K, V>::Remove(key);
+            });
+        }
+
+        void Clear() noexcept
+        {
+            static_cast<D&>(*this).get_collection().write([&]
+            {
+                map_base<D, K, V>::Clear();
+            });
+        }
+    };
+}
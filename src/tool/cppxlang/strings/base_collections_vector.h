@@ -1,5 +1,5 @@
 
-namespace winrt::impl
+WINRT_EXPORT namespace winrt::impl
 {
     template <typename T, typename Container>
     struct observable_vector final :
@@ -26,9 +26,45 @@ namespace winrt::impl
 
         Container m_values;
     };
+
+    template <typename T, typename Container>
+    struct multi_threaded_vector final :
+        implements<multi_threaded_vector<T, Container>, wfc::IVector<T>, wfc::IVectorView<T>, wfc::IIterable<T>>,
+        multi_threaded_vector_base<multi_threaded_vector<T, Container>, T>
+    {
+        static_assert(std::is_same_v<Container, std::remove_reference_t<Container>>, "Must be constructed with rvalue.");
+
+        explicit multi_threaded_vector(Container&& values) : m_values(std::forward<Container>(values))
+        {
+        }
+
+        auto& get_container() noexcept
+        {
+            return m_values.container();
+        }
+
+        auto& get_container() const noexcept
+        {
+            return m_values.container();
+        }
+
+        auto& get_collection() noexcept
+        {
+            return m_values;
+        }
+
+        auto& get_collection() const noexcept
+        {
+            return m_values;
+        }
+
+    private:
+
+        concurrent_collection<Container> m_values;
+    };
 }
 
-namespace winrt
+WINRT_EXPORT namespace winrt
 {
     template <typename T, typename Allocator = std::allocator<T>>
     Windows::Foundation::Collections::IVector<T> single_threaded_vector(std::vector<T, Allocator>&& values = {})
@@ -41,4 +77,10 @@ namespace winrt
     {
         return make<impl::observable_vector<T, std::vector<T, Allocator>>>(std::move(values));
     }
+
+    template <typename T, typename Allocator = std::allocator<T>>
+    Windows::Foundation::Collections::IVector<T> multi_threaded_vector(std::vector<T, Allocator>&& values = {})
+    {
+        return make<impl::multi_threaded_vector<T, std::vector<T, Allocator>>>(std::move(values));
+    }
 }
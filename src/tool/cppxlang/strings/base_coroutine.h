@@ -1,5 +1,5 @@
 
-namespace winrt::impl
+WINRT_EXPORT namespace winrt::impl
 {
     template <typename Async>
     struct await_adapter
@@ -38,7 +38,7 @@ namespace winrt::impl
 }
 
 #ifdef _RESUMABLE_FUNCTIONS_SUPPORTED
-namespace winrt::Windows::Foundation
+WINRT_EXPORT namespace winrt::Windows::Foundation
 {
     inline impl::await_adapter<IAsyncAction> operator co_await(IAsyncAction const& async)
     {
@@ -65,7 +65,7 @@ namespace winrt::Windows::Foundation
 }
 #endif
 
-namespace winrt
+WINRT_EXPORT namespace winrt
 {
     struct get_progress_token_t {};
 
@@ -82,7 +82,7 @@ namespace winrt
     }
 }
 
-namespace winrt::impl
+WINRT_EXPORT namespace winrt::impl
 {
     template <typename Promise>
     struct cancellation_token
@@ -153,7 +153,7 @@ namespace winrt::impl
     };
 
     template <typename Derived, typename AsyncInterface, typename CompletedHandler, typename TProgress = void>
-    struct promise_base : implements<Derived, AsyncInterface, Windows::Foundation::IAsyncInfo>
+    struct promise_base : implements<Derived, allocate_with<pool_allocator>, AsyncInterface, Windows::Foundation::IAsyncInfo>
     {
         using AsyncStatus = Windows::Foundation::AsyncStatus;
 
@@ -1,5 +1,5 @@
 
-namespace winrt
+WINRT_EXPORT namespace winrt
 {
     [[nodiscard]] inline auto resume_background() noexcept
     {
@@ -16,7 +16,7 @@ namespace winrt
 
             void await_suspend(std::experimental::coroutine_handle<> handle) const
             {
-                if (!WINRT_TrySubmitThreadpoolCallback(callback, handle.address(), nullptr))
+                if (!impl::submit_threadpool_callback(callback, handle.address()))
                 {
                     throw_last_error();
                 }
@@ -55,7 +55,7 @@ namespace winrt
             {
                 m_resume = resume;
 
-                if (!WINRT_TrySubmitThreadpoolCallback(callback, this, nullptr))
+                if (!impl::submit_threadpool_callback(callback, this))
                 {
                     throw_last_error();
                 }
@@ -127,9 +127,9 @@ namespace winrt
 
             void await_suspend(std::experimental::coroutine_handle<> handle)
             {
-                m_timer.attach(check_pointer(WINRT_CreateThreadpoolTimer(callback, handle.address(), nullptr)));
+                m_timer.attach(check_pointer(impl::create_threadpool_timer(callback, handle.address())));
                 int64_t relative_count = -m_duration.count();
-                WINRT_SetThreadpoolTimer(m_timer.get(), &relative_count, 0, 0);
+                impl::set_threadpool_timer(m_timer.get(), &relative_count);
             }
 
             void await_resume() const noexcept
@@ -149,7 +149,7 @@ namespace winrt
 
                 static void close(type value) noexcept
                 {
-                    WINRT_CloseThreadpoolTimer(value);
+                    impl::close_threadpool_timer(value);
                 }
 
                 static constexpr type invalid() noexcept
@@ -183,16 +183,16 @@ namespace winrt
 
             bool await_ready() const noexcept
             {
-                return WINRT_WaitForSingleObject(m_handle, 0) == 0;
+                return impl::wait_for_single_object(m_handle, 0) == 0;
             }
 
             void await_suspend(std::experimental::coroutine_handle<> resume)
             {
                 m_resume = resume;
-                m_wait.attach(check_pointer(WINRT_CreateThreadpoolWait(callback, this, nullptr)));
+                m_wait.attach(check_pointer(impl::create_threadpool_wait(callback, this)));
                 int64_t relative_count = -m_timeout.count();
                 int64_t* file_time = relative_count != 0 ? &relative_count : nullptr;
-                WINRT_SetThreadpoolWait(m_wait.get(), m_handle, file_time);
+                impl::set_threadpool_wait(m_wait.get(), m_handle, file_time);
             }
 
             bool await_resume() const noexcept
@@ -215,7 +215,7 @@ namespace winrt
 
                 static void close(type value) noexcept
                 {
-                    WINRT_CloseThreadpoolWait(value);
+                    impl::close_threadpool_wait(value);
                 }
 
                 static constexpr type invalid() noexcept
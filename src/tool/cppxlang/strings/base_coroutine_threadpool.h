@@ -0,0 +1,739 @@
+
+#if defined(__linux__)
+#include <cerrno>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+#endif
+
+WINRT_EXPORT namespace winrt::impl
+{
+#if !defined(__linux__)
+    inline bool submit_threadpool_callback(void(WINRT_CALL* callback)(void*, void* context), void* context) noexcept
+    {
+        return 0 != WINRT_TrySubmitThreadpoolCallback(callback, context, nullptr);
+    }
+
+    inline ptp_timer create_threadpool_timer(void(WINRT_CALL* callback)(void*, void* context, void*), void* context) noexcept
+    {
+        return WINRT_CreateThreadpoolTimer(callback, context, nullptr);
+    }
+
+    inline void set_threadpool_timer(ptp_timer timer, int64_t* time) noexcept
+    {
+        WINRT_SetThreadpoolTimer(timer, time, 0, 0);
+    }
+
+    inline void close_threadpool_timer(ptp_timer timer) noexcept
+    {
+        WINRT_CloseThreadpoolTimer(timer);
+    }
+
+    inline ptp_wait create_threadpool_wait(void(WINRT_CALL* callback)(void*, void* context, void*, uint32_t result), void* context) noexcept
+    {
+        return WINRT_CreateThreadpoolWait(callback, context, nullptr);
+    }
+
+    inline void set_threadpool_wait(ptp_wait wait, void* handle, int64_t* timeout) noexcept
+    {
+        WINRT_SetThreadpoolWait(wait, handle, timeout);
+    }
+
+    inline void close_threadpool_wait(ptp_wait wait) noexcept
+    {
+        WINRT_CloseThreadpoolWait(wait);
+    }
+
+    inline uint32_t wait_for_single_object(void* handle, uint32_t milliseconds) noexcept
+    {
+        return WINRT_WaitForSingleObject(handle, milliseconds);
+    }
+#else
+    // Linux has no system thread pool, so the awaitables are backed by one that lives in the process: work
+    // runs on a work-stealing pool, timers on a timer wheel, and waits on an epoll loop. Each part starts
+    // on first use and is never torn down, since callbacks may still be running during static destruction.
+    // The handles passed to resume_on_signal are file descriptors (an eventfd, a pipe, a socket, ...) that
+    // are signaled while they are readable. Any descriptor is a valid handle, including 0.
+
+    inline constexpr uint32_t wait_object_0{ 0 };
+    inline constexpr uint32_t wait_timeout{ 0x102 };
+    inline constexpr uint32_t wait_failed{ 0xFFFFFFFF };
+
+    // The pool starts one worker per core. When work is queued while every worker has been busy for the
+    // injection delay without completing anything, as happens when callbacks block, another worker is
+    // started, up to the thread limit. Workers started that way exit once they have been idle for the
+    // idle timeout. Callbacks that block on each other beyond the limit still deadlock, as they would on
+    // Windows.
+
+    inline constexpr uint32_t threadpool_thread_limit{ 512 };
+    inline constexpr std::chrono::milliseconds threadpool_injection_delay{ 100 };
+    inline constexpr std::chrono::seconds threadpool_idle_timeout{ 20 };
+
+    struct threadpool_work
+    {
+        void(WINRT_CALL* callback)(void*, void* context);
+        void* context;
+    };
+
+    struct threadpool
+    {
+        static threadpool& instance()
+        {
+            static threadpool* const pool{ new threadpool };
+            return *pool;
+        }
+
+        void submit(threadpool_work const& work)
+        {
+            // Work submitted by a worker stays on its own queue, where it is likely to run next and
+            // find its data in cache. Work from other threads, and from injected workers, which have
+            // no queue, is spread across the queues.
+
+            queue& target = t_pool == this && t_queue ? *t_queue : *m_queues[m_next.fetch_add(1, std::memory_order_relaxed) % m_queues.size()];
+            m_pending.fetch_add(1);
+
+            {
+                std::lock_guard<std::mutex> const guard(target.lock);
+                target.items.push_back(work);
+            }
+
+            if (m_sleeping.load() != 0)
+            {
+                std::lock_guard<std::mutex> const guard(m_lock);
+                m_wake.notify_one();
+            }
+            else if (m_monitor_idle.load())
+            {
+                std::lock_guard<std::mutex> const guard(m_lock);
+                m_monitor.notify_one();
+            }
+        }
+
+    private:
+
+        struct queue
+        {
+            std::mutex lock;
+            std::deque<threadpool_work> items;
+        };
+
+        threadpool()
+        {
+            uint32_t const count = (std::max)(std::thread::hardware_concurrency(), 2u);
+
+            for (uint32_t index = 0; index != count; ++index)
+            {
+                m_queues.push_back(std::make_unique<queue>());
+            }
+
+            m_threads = count;
+
+            for (uint32_t index = 0; index != count; ++index)
+            {
+                std::thread([this, index] { run(index); }).detach();
+            }
+
+            std::thread([this] { monitor(); }).detach();
+        }
+
+        static bool pop(queue& source, bool const newest, threadpool_work& work)
+        {
+            std::lock_guard<std::mutex> const guard(source.lock);
+
+            if (source.items.empty())
+            {
+                return false;
+            }
+
+            if (newest)
+            {
+                work = source.items.back();
+                source.items.pop_back();
+            }
+            else
+            {
+                work = source.items.front();
+                source.items.pop_front();
+            }
+
+            return true;
+        }
+
+        void run(uint32_t const index)
+        {
+            // Workers at an index past the queues were injected and only steal.
+
+            bool const injected = index >= m_queues.size();
+            t_pool = this;
+            t_queue = injected ? nullptr : m_queues[index].get();
+
+            while (true)
+            {
+                // A worker takes the newest work from its own queue and steals the oldest from the others.
+
+                threadpool_work work{};
+                bool found = t_queue && pop(*t_queue, true, work);
+
+                for (size_t offset = t_queue ? 1 : 0; !found && offset != m_queues.size(); ++offset)
+                {
+                    found = pop(*m_queues[(index + offset) % m_queues.size()], false, work);
+                }
+
+                if (found)
+                {
+                    m_pending.fetch_sub(1);
+                    work.callback(nullptr, work.context);
+                    m_completed.fetch_add(1, std::memory_order_relaxed);
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> guard(m_lock);
+                m_sleeping.fetch_add(1);
+
+                if (!injected)
+                {
+                    m_wake.wait(guard, [&] { return m_pending.load() != 0; });
+                }
+                else if (!m_wake.wait_for(guard, threadpool_idle_timeout, [&] { return m_pending.load() != 0; }))
+                {
+                    m_sleeping.fetch_sub(1);
+                    m_threads.fetch_sub(1);
+                    return;
+                }
+
+                // The last worker to wake may leave work queued with every worker busy, which the monitor
+                // needs to know about as much as work queued afterwards.
+
+                if (m_sleeping.fetch_sub(1) == 1 && m_monitor_idle.load())
+                {
+                    m_monitor.notify_one();
+                }
+            }
+        }
+
+        void monitor()
+        {
+            std::unique_lock<std::mutex> guard(m_lock);
+
+            while (true)
+            {
+                // Sleeps until work is queued while every worker is busy, then checks on the workers once
+                // per injection delay for as long as that lasts.
+
+                m_monitor_idle = true;
+                m_monitor.wait(guard, [&] { return m_pending.load() != 0 && m_sleeping.load() == 0; });
+                m_monitor_idle = false;
+
+                uint64_t const completed = m_completed.load(std::memory_order_relaxed);
+                m_monitor.wait_for(guard, threadpool_injection_delay);
+
+                if (m_pending.load() != 0 && m_sleeping.load() == 0 &&
+                    m_completed.load(std::memory_order_relaxed) == completed &&
+                    m_threads.load() < threadpool_thread_limit)
+                {
+                    uint32_t const index = m_threads.fetch_add(1);
+                    std::thread([this, index] { run(index); }).detach();
+                }
+            }
+        }
+
+        std::vector<std::unique_ptr<queue>> m_queues;
+        std::atomic<size_t> m_next{};
+        std::atomic<size_t> m_pending{};
+        std::atomic<uint64_t> m_completed{};
+        std::atomic<uint32_t> m_sleeping{};
+        std::atomic<uint32_t> m_threads{};
+        std::atomic<bool> m_monitor_idle{};
+        std::mutex m_lock;
+        std::condition_variable m_wake;
+        std::condition_variable m_monitor;
+        static inline thread_local threadpool* t_pool{};
+        static inline thread_local queue* t_queue{};
+    };
+
+    inline bool submit_threadpool_callback(void(WINRT_CALL* callback)(void*, void* context), void* context)
+    {
+        threadpool::instance().submit({ callback, context });
+        return true;
+    }
+
+    struct tp_timer
+    {
+        tp_timer(void(WINRT_CALL* callback)(void*, void* context, void*), void* context) noexcept :
+            callback(callback),
+            context(context)
+        {
+        }
+
+        void add_ref() noexcept
+        {
+            m_references.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void release() noexcept
+        {
+            if (1 == m_references.fetch_sub(1, std::memory_order_acq_rel))
+            {
+                delete this;
+            }
+        }
+
+        void(WINRT_CALL* const callback)(void*, void* context, void*);
+        void* const context;
+
+        // The remaining members are guarded by the timer wheel's lock.
+
+        tp_timer* next{};
+        tp_timer* previous{};
+        uint64_t due{};
+        uint64_t period{};
+        bool armed{};
+
+    private:
+
+        std::atomic<uint32_t> m_references{ 1 };
+    };
+
+    struct timer_wheel
+    {
+        static timer_wheel& instance()
+        {
+            static timer_wheel* const wheel{ new timer_wheel };
+            return *wheel;
+        }
+
+        void set(tp_timer* timer, int64_t const* time, uint32_t const period)
+        {
+            std::lock_guard<std::mutex> const guard(m_lock);
+            unlink(timer);
+
+            if (!time)
+            {
+                return;
+            }
+
+            // Times follow the Windows thread pool: negative values are relative and positive values are
+            // absolute, both in 100ns units, and absolute times count from 1601 on the system clock.
+
+            int64_t relative = -*time;
+
+            if (*time > 0)
+            {
+                int64_t const now = std::chrono::duration_cast<std::chrono::duration<int64_t, std::ratio<1, 10'000'000>>>(
+                    std::chrono::system_clock::now().time_since_epoch()).count() + 116'444'736'000'000'000;
+
+                relative = *time - now;
+            }
+
+            // The current tick has partly elapsed, so the timer is due one tick later to never fire early.
+
+            uint64_t const delay = relative > 0 ? static_cast<uint64_t>(relative + 9'999) / 10'000 : 0;
+            timer->due = (std::max)(ticks() + delay + 1, m_current + 1);
+            timer->period = period;
+            link(timer);
+
+            if (timer->due < m_wake_at)
+            {
+                m_wake.notify_one();
+            }
+        }
+
+        void close(tp_timer* timer)
+        {
+            {
+                std::lock_guard<std::mutex> const guard(m_lock);
+                unlink(timer);
+            }
+
+            timer->release();
+        }
+
+    private:
+
+        // Each slot holds the timers that are due on a tick (one millisecond) congruent to its index, so arming
+        // and cancelling a timer is constant time and the wheel thread only visits the slots it passes.
+
+        static constexpr uint64_t slot_count{ 512 };
+
+        timer_wheel()
+        {
+            m_current = ticks();
+            std::thread([this] { run(); }).detach();
+        }
+
+        static uint64_t ticks() noexcept
+        {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        void link(tp_timer* timer) noexcept
+        {
+            tp_timer*& head = m_slots[timer->due % slot_count];
+            timer->previous = nullptr;
+            timer->next = head;
+
+            if (head)
+            {
+                head->previous = timer;
+            }
+
+            head = timer;
+            timer->armed = true;
+        }
+
+        void unlink(tp_timer* timer) noexcept
+        {
+            if (!timer->armed)
+            {
+                return;
+            }
+
+            if (timer->previous)
+            {
+                timer->previous->next = timer->next;
+            }
+            else
+            {
+                m_slots[timer->due % slot_count] = timer->next;
+            }
+
+            if (timer->next)
+            {
+                timer->next->previous = timer->previous;
+            }
+
+            timer->armed = false;
+        }
+
+        static void WINRT_CALL dispatch(void*, void* context) noexcept
+        {
+            auto timer = static_cast<tp_timer*>(context);
+            timer->callback(nullptr, timer->context, timer);
+            timer->release();
+        }
+
+        void expire(uint64_t const slot, uint64_t const now)
+        {
+            for (tp_timer* timer = m_slots[slot]; timer; timer = timer->next)
+            {
+                if (timer->due <= now)
+                {
+                    m_expired.push_back(timer);
+                }
+            }
+
+            for (tp_timer* timer : m_expired)
+            {
+                unlink(timer);
+
+                if (timer->period)
+                {
+                    timer->due = now + timer->period;
+                    link(timer);
+                }
+
+                timer->add_ref();
+                threadpool::instance().submit({ dispatch, timer });
+            }
+
+            m_expired.clear();
+        }
+
+        uint64_t next_due() const noexcept
+        {
+            // A timer found within one turn of the wheel is due on the tick of its slot. If there is none, the
+            // wheel thread wakes after a full turn and looks again.
+
+            for (uint64_t tick = m_current + 1; tick != m_current + slot_count + 1; ++tick)
+            {
+                for (tp_timer* timer = m_slots[tick % slot_count]; timer; timer = timer->next)
+                {
+                    if (timer->due == tick)
+                    {
+                        return tick;
+                    }
+                }
+            }
+
+            return m_current + slot_count;
+        }
+
+        bool empty() const noexcept
+        {
+            return std::all_of(std::begin(m_slots), std::end(m_slots), [](tp_timer* head) { return head == nullptr; });
+        }
+
+        void run()
+        {
+            std::unique_lock<std::mutex> guard(m_lock);
+
+            while (true)
+            {
+                uint64_t const now = ticks();
+                uint64_t const first = now - m_current > slot_count ? now - slot_count + 1 : m_current + 1;
+
+                for (uint64_t tick = first; tick <= now; ++tick)
+                {
+                    expire(tick % slot_count, now);
+                }
+
+                m_current = (std::max)(m_current, now);
+
+                if (empty())
+                {
+                    m_wake_at = UINT64_MAX;
+                    m_wake.wait(guard);
+                }
+                else
+                {
+                    m_wake_at = next_due();
+                    m_wake.wait_until(guard, std::chrono::steady_clock::time_point(std::chrono::milliseconds(m_wake_at)));
+                }
+            }
+        }
+
+        std::mutex m_lock;
+        std::condition_variable m_wake;
+        tp_timer* m_slots[slot_count]{};
+        std::vector<tp_timer*> m_expired;
+        uint64_t m_current{};
+        uint64_t m_wake_at{ UINT64_MAX };
+    };
+
+    inline ptp_timer create_threadpool_timer(void(WINRT_CALL* callback)(void*, void* context, void*), void* context) noexcept
+    {
+        return new (std::nothrow) tp_timer(callback, context);
+    }
+
+    inline void set_threadpool_timer(ptp_timer timer, int64_t* time)
+    {
+        timer_wheel::instance().set(timer, time, 0);
+    }
+
+    inline void close_threadpool_timer(ptp_timer timer) noexcept
+    {
+        timer_wheel::instance().close(timer);
+    }
+
+    struct tp_wait
+    {
+        tp_wait(void(WINRT_CALL* callback)(void*, void* context, void*, uint32_t result), void* context) noexcept :
+            callback(callback),
+            context(context)
+        {
+        }
+
+        void add_ref() noexcept
+        {
+            m_references.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void release() noexcept
+        {
+            if (1 == m_references.fetch_sub(1, std::memory_order_acq_rel))
+            {
+                delete this;
+            }
+        }
+
+        void(WINRT_CALL* const callback)(void*, void* context, void*, uint32_t result);
+        void* const context;
+
+        // The remaining members are guarded by the wait loop's lock.
+
+        uint64_t registration{};
+        int descriptor{ -1 };
+        tp_timer* timeout{};
+        uint32_t result{};
+
+    private:
+
+        std::atomic<uint32_t> m_references{ 1 };
+    };
+
+    struct wait_loop
+    {
+        static wait_loop& instance()
+        {
+            static wait_loop* const loop{ new wait_loop };
+            return *loop;
+        }
+
+        void set(tp_wait* wait, void* handle, int64_t* timeout)
+        {
+            std::lock_guard<std::mutex> const guard(m_lock);
+            cancel(wait);
+
+            // Each wait registers its own duplicate of the descriptor so that several waits on one handle
+            // do not collide in the epoll set. Events carry a registration id rather than a pointer, so an
+            // event that arrives after its wait was cancelled is recognized and dropped.
+
+            uint64_t const registration = ++m_registrations;
+            wait->add_ref();
+            m_waits.emplace(registration, wait);
+            wait->registration = registration;
+            wait->descriptor = fcntl(static_cast<int>(reinterpret_cast<intptr_t>(handle)), F_DUPFD_CLOEXEC, 0);
+
+            epoll_event event{};
+            event.events = EPOLLIN | EPOLLONESHOT;
+            event.data.u64 = registration;
+
+            if (wait->descriptor == -1 || epoll_ctl(m_epoll, EPOLL_CTL_ADD, wait->descriptor, &event) != 0)
+            {
+                complete(registration, wait_failed);
+                return;
+            }
+
+            if (timeout)
+            {
+                wait->timeout = new tp_timer(on_timeout, reinterpret_cast<void*>(static_cast<uintptr_t>(registration)));
+                timer_wheel::instance().set(wait->timeout, timeout, 0);
+            }
+        }
+
+        void close(tp_wait* wait)
+        {
+            {
+                std::lock_guard<std::mutex> const guard(m_lock);
+                cancel(wait);
+            }
+
+            wait->release();
+        }
+
+    private:
+
+        wait_loop()
+        {
+            m_epoll = epoll_create1(EPOLL_CLOEXEC);
+
+            if (m_epoll == -1)
+            {
+                throw std::system_error(errno, std::system_category(), "epoll_create1");
+            }
+
+            std::thread([this] { run(); }).detach();
+        }
+
+        void unregister(tp_wait* wait)
+        {
+            m_waits.erase(wait->registration);
+            wait->registration = 0;
+
+            if (wait->descriptor != -1)
+            {
+                epoll_ctl(m_epoll, EPOLL_CTL_DEL, wait->descriptor, nullptr);
+                ::close(wait->descriptor);
+                wait->descriptor = -1;
+            }
+
+            if (wait->timeout)
+            {
+                timer_wheel::instance().close(wait->timeout);
+                wait->timeout = nullptr;
+            }
+        }
+
+        void cancel(tp_wait* wait)
+        {
+            if (wait->registration)
+            {
+                unregister(wait);
+                wait->release();
+            }
+        }
+
+        static void WINRT_CALL dispatch(void*, void* context) noexcept
+        {
+            auto wait = static_cast<tp_wait*>(context);
+            wait->callback(nullptr, wait->context, wait, wait->result);
+            wait->release();
+        }
+
+        void complete(uint64_t const registration, uint32_t const result)
+        {
+            auto found = m_waits.find(registration);
+
+            if (found == m_waits.end())
+            {
+                return;
+            }
+
+            // The registration's reference is handed to the callback.
+
+            tp_wait* wait = found->second;
+            unregister(wait);
+            wait->result = result;
+            threadpool::instance().submit({ dispatch, wait });
+        }
+
+        static void WINRT_CALL on_timeout(void*, void* context, void*) noexcept
+        {
+            auto& loop = instance();
+            std::lock_guard<std::mutex> const guard(loop.m_lock);
+            loop.complete(reinterpret_cast<uintptr_t>(context), wait_timeout);
+        }
+
+        void run()
+        {
+            std::array<epoll_event, 64> events;
+
+            while (true)
+            {
+                int const count = epoll_wait(m_epoll, events.data(), static_cast<int>(events.size()), -1);
+
+                if (count <= 0)
+                {
+                    continue;
+                }
+
+                std::lock_guard<std::mutex> const guard(m_lock);
+
+                for (int index = 0; index != count; ++index)
+                {
+                    complete(events[index].data.u64, wait_object_0);
+                }
+            }
+        }
+
+        int m_epoll{ -1 };
+        std::mutex m_lock;
+        std::unordered_map<uint64_t, tp_wait*> m_waits;
+        uint64_t m_registrations{};
+    };
+
+    inline ptp_wait create_threadpool_wait(void(WINRT_CALL* callback)(void*, void* context, void*, uint32_t result), void* context) noexcept
+    {
+        return new (std::nothrow) tp_wait(callback, context);
+    }
+
+    inline void set_threadpool_wait(ptp_wait wait, void* handle, int64_t* timeout)
+    {
+        wait_loop::instance().set(wait, handle, timeout);
+    }
+
+    inline void close_threadpool_wait(ptp_wait wait) noexcept
+    {
+        wait_loop::instance().close(wait);
+    }
+
+    inline uint32_t wait_for_single_object(void* handle, uint32_t const milliseconds) noexcept
+    {
+        pollfd descriptor{ static_cast<int>(reinterpret_cast<intptr_t>(handle)), POLLIN, 0 };
+        int const result = poll(&descriptor, 1, milliseconds == 0xFFFFFFFF ? -1 : static_cast<int>(milliseconds));
+
+        if (result < 0)
+        {
+            return wait_failed;
+        }
+
+        return result == 0 ? wait_timeout : wait_object_0;
+    }
+#endif
+}
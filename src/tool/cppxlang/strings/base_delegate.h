@@ -1,9 +1,12 @@
 
-namespace winrt::impl
+WINRT_EXPORT namespace winrt::impl
 {
     template <typename T, typename H>
-    struct implements_delegate : abi_t<T>, H
+    struct implements_delegate : abi_t<T>, H, allocated_with<pool_allocator>
     {
+        using allocated_with<pool_allocator>::operator new;
+        using allocated_with<pool_allocator>::operator delete;
+
         implements_delegate(H&& handler) : H(std::forward<H>(handler)) {}
 
         int32_t WINRT_CALL QueryInterface(guid const& id, void** result) noexcept final
@@ -91,8 +94,11 @@ namespace winrt::impl
     };
 
     template <typename H, typename... T>
-    struct variadic_delegate final : variadic_delegate_abi<T...>, H
+    struct variadic_delegate final : variadic_delegate_abi<T...>, H, allocated_with<pool_allocator>
     {
+        using allocated_with<pool_allocator>::operator new;
+        using allocated_with<pool_allocator>::operator delete;
+
         variadic_delegate(H&& handler) : H(std::forward<H>(handler)) {}
 
         void invoke(T const&... args) final
@@ -137,7 +143,7 @@ namespace winrt::impl
     };
 }
 
-namespace winrt
+WINRT_EXPORT namespace winrt
 {
     template <typename... T>
     struct WINRT_EBO delegate : Windows::Foundation::IUnknown
@@ -6,6 +6,7 @@
 #include <chrono>
 #include <clocale>
 #include <cstddef>
+#include <cstring>
 #include <cwchar>
 #include <iterator>
 #include <limits>
@@ -23,20 +24,9 @@
 #include <unordered_map>
 #include <vector>
 
-#if __has_include(<WindowsNumerics.impl.h>)
-#define WINRT_NUMERICS
-#include <directxmath.h>
-#define _WINDOWS_NUMERICS_NAMESPACE_ winrt::Windows::Foundation::Numerics
-#define _WINDOWS_NUMERICS_BEGIN_NAMESPACE_ namespace winrt::Windows::Foundation::Numerics
-#define _WINDOWS_NUMERICS_END_NAMESPACE_
-#ifdef __clang__
-#define _XM_NO_INTRINSICS_
-#endif
-#include <WindowsNumerics.impl.h>
-#ifdef __clang__
-#undef _XM_NO_INTRINSICS_
-#endif
-#undef _WINDOWS_NUMERICS_NAMESPACE_
-#undef _WINDOWS_NUMERICS_BEGIN_NAMESPACE_
-#undef _WINDOWS_NUMERICS_END_NAMESPACE_
+#if defined(__linux__)
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 #endif
@@ -1,5 +1,5 @@
 
-namespace winrt
+WINRT_EXPORT namespace winrt
 {
     struct event_token
     {
@@ -130,7 +130,7 @@ namespace winrt
     };
 }
 
-namespace winrt::impl
+WINRT_EXPORT namespace winrt::impl
 {
     template <typename I, auto Method>
     struct event_revoker
@@ -259,85 +259,88 @@ namespace winrt::impl
         return { static_cast<D const&>(*source), token };
     }
 
-    template <typename T>
-    struct event_array
+    struct event_retired : allocated_with<pool_allocator>
     {
-        using value_type = T;
-        using reference = value_type&;
-        using pointer = value_type*;
-        using iterator = value_type*;
+        // Something that an event no longer refers to but that an invocation in progress may still be
+        // using: either a removed delegate, whose reference is released along with the node, or an array.
 
-        explicit event_array(uint32_t const count) noexcept : m_size(count)
-        {
-            std::uninitialized_fill_n(data(), count, value_type());
-        }
+        event_retired* next{};
+        void* delegate{};
+    };
 
-        unsigned long AddRef() noexcept
-        {
-            return 1 + m_references.fetch_add(1, std::memory_order_relaxed);
-        }
+    struct event_array : event_retired
+    {
+        // Delegates are only ever appended, up to the capacity, and removed by clearing their slot, so an
+        // invocation can walk the first size slots without a lock while the event keeps changing. Each
+        // slot also records the handle of its delegate, which only the event's changes use.
 
-        unsigned long Release() noexcept
+        explicit event_array(uint32_t const capacity) noexcept : capacity(capacity)
         {
-            uint32_t const remaining = m_references.fetch_sub(1, std::memory_order_release) - 1;
-
-            if (remaining == 0)
-            {
-                std::atomic_thread_fence(std::memory_order_acquire);
-                this->~event_array();
-                ::operator delete(static_cast<void*>(this));
-            }
-
-            return remaining;
         }
 
-        reference back() noexcept
+        std::atomic<void*>* data() noexcept
         {
-            WINRT_ASSERT(m_size > 0);
-            return*(data() + m_size - 1);
+            return reinterpret_cast<std::atomic<void*>*>(this + 1);
         }
 
-        iterator begin() noexcept
+        uint32_t* handles() noexcept
         {
-            return data();
+            return reinterpret_cast<uint32_t*>(data() + capacity);
         }
 
-        iterator end() noexcept
-        {
-            return data() + m_size;
-        }
+        uint32_t const capacity;
+        std::atomic<uint32_t> size{};
+    };
 
-        uint32_t size() const noexcept
-        {
-            return m_size;
-        }
+    inline size_t event_array_size(uint32_t const capacity) noexcept
+    {
+        return sizeof(event_array) + ((sizeof(std::atomic<void*>) + sizeof(uint32_t)) * capacity);
+    }
 
-        ~event_array() noexcept
+    inline event_array* make_event_array(uint32_t const capacity)
+    {
+        void* raw = pool_allocator::allocate(event_array_size(capacity));
+        auto result = ::new(raw) event_array(capacity);
+        std::uninitialized_value_construct_n(result->data(), capacity);
+        return result;
+    }
+
+    inline void destroy_event_retired(event_retired* node) noexcept
+    {
+        while (node)
         {
-            std::destroy(begin(), end());
-        }
+            auto next = node->next;
 
-    private:
+            if (node->delegate)
+            {
+                static_cast<unknown_abi*>(node->delegate)->Release();
+                delete node;
+            }
+            else
+            {
+                auto array = static_cast<event_array*>(node);
+                size_t const size = event_array_size(array->capacity);
+                array->~event_array();
+                pool_allocator::deallocate(array, size);
+            }
 
-        pointer data() noexcept
-        {
-            return reinterpret_cast<pointer>(this + 1);
+            node = next;
         }
+    }
 
-        std::atomic<uint32_t> m_references{ 1 };
-        uint32_t m_size{ 0 };
+    struct event_handle
+    {
+        // A token names a handle and the generation it was issued with. The generation is odd while the
+        // handle is in use and even once it is free, when slot holds the next free handle instead.
+
+        uint32_t slot;
+        uint32_t generation;
     };
 
-    template <typename T>
-    com_ptr<event_array<T>> make_event_array(uint32_t const capacity)
-    {
-        void* raw = ::operator new(sizeof(event_array<T>) + (sizeof(T)* capacity));
-#pragma warning(suppress: 6386)
-        return { new(raw) event_array<T>(capacity), take_ownership_from_abi };
-    }
+    inline constexpr uint32_t no_event_handle{ 0xFFFFFFFF };
 }
 
-namespace winrt
+WINRT_EXPORT namespace winrt
 {
     template <typename Delegate>
     struct event
@@ -348,32 +351,58 @@ namespace winrt
         event(event<Delegate> const&) = delete;
         event<Delegate>& operator =(event<Delegate> const&) = delete;
 
+        ~event() noexcept
+        {
+            if (auto targets = m_targets.load(std::memory_order_relaxed))
+            {
+                auto slots = targets->data();
+
+                for (uint32_t index = 0, size = targets->size.load(std::memory_order_relaxed); index != size; ++index)
+                {
+                    if (void* delegate = slots[index].load(std::memory_order_relaxed))
+                    {
+                        static_cast<impl::unknown_abi*>(delegate)->Release();
+                    }
+                }
+
+                impl::destroy_event_retired(targets);
+            }
+
+            impl::destroy_event_retired(m_sealed.load(std::memory_order_relaxed));
+            impl::destroy_event_retired(m_retired);
+        }
+
         explicit operator bool() const noexcept
         {
-            return m_targets != nullptr;
+            return m_targets.load(std::memory_order_relaxed) != nullptr;
         }
 
         event_token add(delegate_type const& delegate)
         {
-            event_token token{};
-
-            // Extends life of old targets array to release delegates outside of lock.
-            delegate_array temp_targets;
+            delegate_type value = impl::make_agile_delegate(delegate);
+            event_token token;
 
             {
-                slim_lock_guard const change_guard(m_change);
-                delegate_array new_targets = impl::make_event_array<delegate_type>((!m_targets) ? 1 : m_targets->size() + 1);
+                change_guard guard(*this);
+                auto targets = m_targets.load(std::memory_order_relaxed);
 
-                if (m_targets)
+                if (!targets || targets->size.load(std::memory_order_relaxed) == targets->capacity)
                 {
-                    std::copy_n(m_targets->begin(), m_targets->size(), new_targets->begin());
-                }
+                    // Doubling the capacity keeps adding amortized constant time. Cleared slots are
+                    // dropped whenever the array is reallocated.
 
-                new_targets->back() = impl::make_agile_delegate(delegate);
-                token = get_token(new_targets->back());
+                    targets = resize((m_count + 1) * 2);
+                }
 
-                slim_lock_guard const swap_guard(m_swap);
-                temp_targets = std::exchange(m_targets, std::move(new_targets));
+                uint32_t const handle = allocate_handle();
+                uint32_t const size = targets->size.load(std::memory_order_relaxed);
+                m_handles[handle].slot = size;
+                targets->handles()[size] = handle;
+                targets->data()[size].store(detach_abi(value), std::memory_order_relaxed);
+                targets->size.store(size + 1, std::memory_order_release);
+                ++m_count;
+                token = get_token(handle);
+                guard.released = reclaim();
             }
 
             return token;
@@ -381,110 +410,357 @@ namespace winrt
 
         void remove(event_token const token)
         {
-            // Extends life of old targets array to release delegates outside of lock.
-            delegate_array temp_targets;
+            // The token leads straight to the slot, so removal takes constant time however many
+            // delegates there are. A token that was already removed no longer matches its handle.
+
+            auto const handle = static_cast<uint32_t>(static_cast<uint64_t>(token.value));
+            auto const generation = static_cast<uint32_t>(static_cast<uint64_t>(token.value) >> 32);
+            change_guard guard(*this);
+
+            if (!(generation & 1) || handle >= m_handles.size() || m_handles[handle].generation != generation)
+            {
+                return;
+            }
+
+            remove_slot(m_handles[handle].slot);
+            guard.released = reclaim();
+        }
+
+        template<typename...Arg>
+        void operator()(Arg const&... args)
+        {
+            // Invocation takes no lock. It announces itself in the current epoch so that nothing it may
+            // reach is released until it completes, then walks the delegates present when it started.
 
+            struct reader_guard
             {
-                slim_lock_guard const change_guard(m_change);
+                event& self;
+                uint32_t const epoch{ self.enter() };
 
-                if (!m_targets)
+                ~reader_guard() noexcept
                 {
-                    return;
+                    self.leave(epoch);
                 }
+            }
+            const guard{ *this };
+
+            auto targets = m_targets.load();
+
+            if (!targets)
+            {
+                return;
+            }
 
-                uint32_t available_slots = m_targets->size() - 1;
-                delegate_array new_targets;
-                bool removed = false;
+            auto slots = targets->data();
 
-                if (available_slots == 0)
+            for (uint32_t index = 0, size = targets->size.load(std::memory_order_acquire); index != size; ++index)
+            {
+                void* const delegate = slots[index].load();
+
+                if (!delegate)
                 {
-                    if (get_token(*m_targets->begin()) == token)
-                    {
-                        removed = true;
-                    }
+                    continue;
                 }
-                else
-                {
-                    new_targets = impl::make_event_array<delegate_type>(available_slots);
-                    auto new_iterator = new_targets->begin();
 
-                    for (delegate_type const& element : *m_targets)
+                delegate_type const& element = *reinterpret_cast<delegate_type const*>(&delegate);
+                bool remove_delegate = false;
+
+                try
+                {
+                    element(args...);
+                }
+                catch (hresult_error const& e)
+                {
+                    if (e.code() == static_cast<int32_t>(0x80010108) || // RPC_E_DISCONNECTED
+                        e.code() == static_cast<int32_t>(0x800706BA) || // HRESULT_FROM_WIN32(RPC_S_SERVER_UNAVAILABLE)
+                        e.code() ==  static_cast<int32_t>(0x89020001))  // JSCRIPT_E_CANTEXECUTE
                     {
-                        if (!removed && token == get_token(element))
-                        {
-                            removed = true;
-                            continue;
-                        }
-
-                        if (available_slots == 0)
-                        {
-                            WINRT_ASSERT(!removed);
-                            break;
-                        }
-
-                        *new_iterator = element;
-                        ++new_iterator;
-                        --available_slots;
+                        remove_delegate = true;
                     }
                 }
 
-                if (removed)
+                if (remove_delegate)
                 {
-                    slim_lock_guard const swap_guard(m_swap);
-                    temp_targets = std::exchange(m_targets, std::move(new_targets));
+                    remove_disconnected(delegate);
                 }
             }
         }
 
-        template<typename...Arg>
-        void operator()(Arg const&... args)
+    private:
+
+        event_token get_token(uint32_t const handle) const noexcept
+        {
+            return event_token{ static_cast<int64_t>((static_cast<uint64_t>(m_handles[handle].generation) << 32) | handle) };
+        }
+
+        // The handles are only used under m_change. Freed handles are reused first, so the table only
+        // grows to the largest number of delegates the event has held at once.
+
+        uint32_t allocate_handle()
         {
-            delegate_array temp_targets;
+            uint32_t handle = m_free_handle;
 
+            if (handle == impl::no_event_handle)
             {
-                slim_lock_guard const swap_guard(m_swap);
-                temp_targets = m_targets;
+                handle = static_cast<uint32_t>(m_handles.size());
+                m_handles.push_back({ 0, 0 });
             }
+            else
+            {
+                m_free_handle = m_handles[handle].slot;
+            }
+
+            ++m_handles[handle].generation;
+            return handle;
+        }
 
-            if (temp_targets)
+        void free_handle(uint32_t const handle) noexcept
+        {
+            ++m_handles[handle].generation;
+            m_handles[handle].slot = m_free_handle;
+            m_free_handle = handle;
+        }
+
+        // Removes a delegate that an invocation found to be disconnected. The slot is looked up, since
+        // the array may have been replaced since the invocation started, but this is rare.
+
+        void remove_disconnected(void* const delegate)
+        {
+            change_guard guard(*this);
+            auto targets = m_targets.load(std::memory_order_relaxed);
+
+            if (!targets)
             {
-                for (delegate_type const& element : *temp_targets)
-                {
-                    bool remove_delegate = false;
+                return;
+            }
+
+            auto slots = targets->data();
+            uint32_t const size = targets->size.load(std::memory_order_relaxed);
+            uint32_t index = 0;
+
+            while (index != size && slots[index].load(std::memory_order_relaxed) != delegate)
+            {
+                ++index;
+            }
+
+            if (index == size)
+            {
+                return;
+            }
+
+            remove_slot(index);
+            guard.released = reclaim();
+        }
+
+        // The caller holds m_change.
+
+        void remove_slot(uint32_t const index)
+        {
+            auto targets = m_targets.load(std::memory_order_relaxed);
+            auto removed = new impl::event_retired;
+            removed->delegate = targets->data()[index].exchange(nullptr);
+            free_handle(targets->handles()[index]);
+            retire(removed);
+            --m_count;
+
+            if (m_count == 0)
+            {
+                retire(m_targets.exchange(nullptr));
+            }
+            else if (m_count * 4 < targets->size.load(std::memory_order_relaxed))
+            {
+                // Compacting once most slots are cleared keeps invocation proportional to the number
+                // of delegates, and is amortized over the removals that cleared them.
+
+                resize(m_count * 2);
+            }
+        }
+
+        // Replaces the array with one holding only the remaining delegates, and points their handles at
+        // their new slots. The caller holds m_change.
+
+        impl::event_array* resize(uint32_t const capacity)
+        {
+            auto result = impl::make_event_array(capacity);
+            auto targets = m_targets.load(std::memory_order_relaxed);
 
-                    try
+            if (targets)
+            {
+                auto slots = targets->data();
+                uint32_t next = 0;
+
+                for (uint32_t index = 0, size = targets->size.load(std::memory_order_relaxed); index != size; ++index)
+                {
+                    if (void* delegate = slots[index].load(std::memory_order_relaxed))
                     {
-                        element(args...);
+                        uint32_t const handle = targets->handles()[index];
+                        m_handles[handle].slot = next;
+                        result->handles()[next] = handle;
+                        result->data()[next++].store(delegate, std::memory_order_relaxed);
                     }
-                    catch (hresult_error const& e)
+                }
+
+                result->size.store(next, std::memory_order_relaxed);
+            }
+
+            m_targets.store(result);
+
+            if (targets)
+            {
+                retire(targets);
+            }
+
+            return result;
+        }
+
+        void retire(impl::event_retired* node) noexcept
+        {
+            node->next = m_retired;
+            m_retired = node;
+        }
+
+        // What is retired during an epoch is sealed when the next one begins, and released once the
+        // invocations that started in the epoch it was retired in have completed. An invocation that
+        // starts later can no longer reach it. Invocations that keep overlapping therefore never hold
+        // up more than the last two epochs' worth. The caller holds m_change and releases the result
+        // after giving it up with unlock_change.
+
+        impl::event_retired* reclaim() noexcept
+        {
+            impl::event_retired* released{};
+            uint32_t const epoch = m_epoch.load(std::memory_order_relaxed);
+
+            if (m_sealed.load(std::memory_order_relaxed) && m_readers[(epoch - 1) & 1].load() == 0)
+            {
+                released = m_sealed.exchange(nullptr);
+            }
+
+            if (!m_sealed.load(std::memory_order_relaxed) && m_retired)
+            {
+                auto sealed = std::exchange(m_retired, nullptr);
+                m_sealed.store(sealed);
+                m_epoch.store(epoch + 1);
+
+                if (m_readers[epoch & 1].load() == 0)
+                {
+                    auto last = sealed;
+
+                    while (last->next)
                     {
-                        if (e.code() == static_cast<int32_t>(0x80010108) || // RPC_E_DISCONNECTED
-                            e.code() == static_cast<int32_t>(0x800706BA) || // HRESULT_FROM_WIN32(RPC_S_SERVER_UNAVAILABLE)
-                            e.code() ==  static_cast<int32_t>(0x89020001))  // JSCRIPT_E_CANTEXECUTE
-                        {
-                            remove_delegate = true;
-                        }
+                        last = last->next;
                     }
 
-                    if (remove_delegate)
+                    last->next = released;
+                    released = sealed;
+                    m_sealed.store(nullptr, std::memory_order_relaxed);
+                }
+            }
+
+            return released;
+        }
+
+        uint32_t enter() noexcept
+        {
+            // The epoch is checked again after counting the reader, so that a reader is never counted
+            // against an epoch whose retired list may already have been released.
+
+            while (true)
+            {
+                uint32_t const epoch = m_epoch.load();
+                m_readers[epoch & 1].fetch_add(1);
+
+                if (m_epoch.load() == epoch)
+                {
+                    return epoch;
+                }
+
+                leave(epoch);
+            }
+        }
+
+        void leave(uint32_t const epoch) noexcept
+        {
+            // The last reader of an epoch releases what it was holding up, unless a change holds
+            // m_change, which then does so once it gives it up. Nothing is held up unless something was
+            // sealed, which a change does before it counts the readers, so that one of the two sees the
+            // other.
+
+            if (m_readers[epoch & 1].fetch_sub(1) == 1)
+            {
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                if (m_sealed.load() && m_change.try_lock())
+                {
+                    unlock_change(reclaim());
+                }
+            }
+        }
+
+        // Gives up m_change and releases what was reclaimed under it. A reader that left while the lock
+        // was held may have found it taken and left what it was holding up to the holder, so the sealed
+        // list is checked again once the lock is given up, and reclaimed if its readers are all gone and
+        // no other change has taken the lock, which would then do the same. Nothing is released until
+        // the event is no longer used, since releasing a delegate may destroy the event.
+
+        void unlock_change(impl::event_retired* released) noexcept
+        {
+            while (true)
+            {
+                m_change.unlock();
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                if (!m_sealed.load() || m_readers[(m_epoch.load() - 1) & 1].load() != 0 || !m_change.try_lock())
+                {
+                    break;
+                }
+
+                if (auto more = reclaim())
+                {
+                    auto last = more;
+
+                    while (last->next)
                     {
-                        remove(get_token(element));
+                        last = last->next;
                     }
+
+                    last->next = released;
+                    released = more;
                 }
             }
+
+            impl::destroy_event_retired(released);
         }
 
-    private:
+        // Holds m_change for a change, which stores what it reclaims in released to be released once the
+        // lock is given up, since releasing a delegate may run code that changes the event.
 
-        event_token get_token(delegate_type const& delegate) const noexcept
+        struct change_guard
         {
-            return event_token{ reinterpret_cast<int64_t>(get_abi(delegate)) };
-        }
+            explicit change_guard(event& self) noexcept : self(self)
+            {
+                self.m_change.lock();
+            }
+
+            change_guard(change_guard const&) = delete;
+            change_guard& operator=(change_guard const&) = delete;
 
-        using delegate_array = com_ptr<impl::event_array<delegate_type>>;
+            ~change_guard() noexcept
+            {
+                self.unlock_change(released);
+            }
 
-        delegate_array m_targets;
-        slim_mutex m_swap;
+            event& self;
+            impl::event_retired* released{};
+        };
+
+        std::atomic<impl::event_array*> m_targets{};
+        std::atomic<uint32_t> m_epoch{};
+        std::atomic<uint32_t> m_readers[2]{};
+        impl::event_retired* m_retired{};
+        std::atomic<impl::event_retired*> m_sealed{};
+        std::vector<impl::event_handle> m_handles;
+        uint32_t m_free_handle{ impl::no_event_handle };
+        uint32_t m_count{};
         slim_mutex m_change;
     };
 }
@@ -1,5 +1,5 @@
 
-namespace winrt::Windows::Foundation
+WINRT_EXPORT namespace winrt::Windows::Foundation
 {
     struct Point
     {
@@ -100,7 +100,7 @@ namespace winrt::Windows::Foundation
     }
 }
 
-namespace winrt::impl
+WINRT_EXPORT namespace winrt::impl
 {
     template <> struct name<Windows::Foundation::Point>
     {
@@ -1,5 +1,5 @@
 
-namespace winrt
+WINRT_EXPORT namespace winrt
 {
     template <typename T>
     using default_interface = typename impl::default_interface<T>::type;
@@ -19,7 +19,7 @@ namespace winrt
     struct event_token;
 }
 
-namespace winrt::impl
+WINRT_EXPORT namespace winrt::impl
 {
     template <size_t Size, typename T, size_t... Index>
     constexpr std::array<T, Size> to_array(T const* value, std::index_sequence<Index...> const) noexcept
@@ -464,11 +464,30 @@ namespace winrt::impl
         constexpr static auto data{ to_array(signature<TArg>::data) };
     };
 
+    // cppxlang -guids writes out the IIDs of the generic instances that a projection uses, so that only
+    // the instances that appear in user code alone are hashed here.
+
     template <typename T>
-    struct pinterface_guid
+    inline constexpr std::optional<guid> generated_pinterface_guid{};
+
+    template <typename T>
+    constexpr guid get_pinterface_guid() noexcept
     {
+        if constexpr (generated_pinterface_guid<T>.has_value())
+        {
+            return *generated_pinterface_guid<T>;
+        }
+        else
+        {
 #pragma warning(suppress: 4307)
-        static constexpr guid value{ generate_guid(signature<T>::data) };
+            return generate_guid(signature<T>::data);
+        }
+    }
+
+    template <typename T>
+    struct pinterface_guid
+    {
+        static constexpr guid value{ get_pinterface_guid<T>() };
     };
 
     constexpr size_t to_utf8_size(wchar_t const value) noexcept
@@ -785,7 +804,7 @@ namespace winrt::impl
     }
 }
 
-namespace winrt
+WINRT_EXPORT namespace winrt
 {
     template <typename T>
     constexpr auto name_of() noexcept
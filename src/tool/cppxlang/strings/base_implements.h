@@ -1,5 +1,5 @@
 
-namespace winrt::impl
+WINRT_EXPORT namespace winrt::impl
 {
     struct marker
     {
@@ -7,7 +7,7 @@ namespace winrt::impl
     };
 }
 
-namespace winrt
+WINRT_EXPORT namespace winrt
 {
     struct non_agile : impl::marker {};
     struct no_weak_ref : impl::marker {};
@@ -15,6 +15,10 @@ namespace winrt
     struct composable : impl::marker {};
     struct no_module_lock : impl::marker {};
     struct static_lifetime : impl::marker {};
+    struct single_threaded : impl::marker {};
+
+    template <typename Allocator>
+    struct allocate_with : impl::marker {};
 
     template <typename Interface>
     struct cloaked : Interface {};
@@ -29,7 +33,7 @@ namespace winrt
     }
 }
 
-namespace winrt::impl
+WINRT_EXPORT namespace winrt::impl
 {
     template<typename...T>
     using tuple_cat_t = decltype(std::tuple_cat(std::declval<T>()...));
@@ -187,6 +191,39 @@ namespace winrt::impl
     template <typename D>
     inline constexpr bool has_static_lifetime_v = has_static_lifetime<typename D::implements_type>::value;
 
+    template <typename>
+    struct has_single_threaded : std::false_type {};
+
+    template <typename D, typename...I>
+    struct has_single_threaded<implements<D, I...>> : std::disjunction<std::is_same<single_threaded, I>...> {};
+
+    template <typename D>
+    inline constexpr bool has_single_threaded_v = has_single_threaded<typename D::implements_type>::value;
+
+    // The objects that a single_threaded object hands out (its iterators, for instance) can't reach any
+    // other thread either, so they are given the same marker, or void (which implements<> ignores).
+
+    template <typename D>
+    using threading_marker = std::conditional_t<has_single_threaded_v<D>, single_threaded, void>;
+
+    // An allocate_with<Allocator> marker gives the implementation its operator new and delete from
+    // Allocator (see allocated_with), so that make<> and final_release allocate and free through it.
+
+    template <typename... I>
+    struct implements_allocator
+    {
+        using type = void;
+    };
+
+    template <typename First, typename... Rest>
+    struct implements_allocator<First, Rest...> : implements_allocator<Rest...> {};
+
+    template <typename Allocator, typename... Rest>
+    struct implements_allocator<allocate_with<Allocator>, Rest...>
+    {
+        using type = Allocator;
+    };
+
     template <typename T>
     void clear_abi(T*) noexcept
     {}
@@ -216,7 +253,7 @@ namespace winrt::impl
     }
 }
 
-namespace winrt
+WINRT_EXPORT namespace winrt
 {
     template <typename D, typename I>
     D* get_self(I const& from) noexcept
@@ -243,7 +280,7 @@ namespace winrt
     }
 }
 
-namespace winrt::impl
+WINRT_EXPORT namespace winrt::impl
 {
     template <typename...> struct interface_list;
 
@@ -370,10 +407,130 @@ namespace winrt::impl
         }
     };
 
+    template <typename T, typename List>
+    struct interface_table;
+
+    template <typename T, typename ... I>
+    struct interface_table<T, interface_list<I...>>
+    {
+        // Maps an IID to the interface it identifies in constant time, so that QueryInterface costs the same
+        // for an object implementing dozens of interfaces as for one implementing a single interface. The
+        // table is a perfect hash on Data1: a multiplier is searched for at compile time under which every
+        // implemented IID lands in its own slot, and a lookup hashes the requested IID, compares the one
+        // candidate it finds there, and calls that interface's cast. If no such multiplier is found (say
+        // because two IIDs share Data1), lookups fall back to comparing each IID in turn.
+
+        static constexpr size_t count{ sizeof...(I) };
+
+        static constexpr uint32_t get_bits() noexcept
+        {
+            // Sizing the table at the square of the interface count (within bounds) makes a collision-free
+            // multiplier likely to be found within the first few attempts.
+
+            size_t const target = (std::min)((std::max)(count * count, size_t{ 2 }), size_t{ 1024 });
+            uint32_t bits{ 1 };
+
+            while ((size_t{ 1 } << bits) < target)
+            {
+                ++bits;
+            }
+
+            return bits;
+        }
+
+        static constexpr uint32_t bits{ get_bits() };
+        static constexpr size_t size{ size_t{ 1 } << bits };
+#pragma warning(suppress: 4307)
+        static constexpr std::array<uint32_t, count> keys{ guid_of<I>().Data1 ... };
+
+        static constexpr uint32_t hash(uint32_t const key, uint32_t const multiplier) noexcept
+        {
+            return static_cast<uint32_t>(key * multiplier) >> (32 - bits);
+        }
+
+        static constexpr uint32_t get_multiplier() noexcept
+        {
+            if (count == 0 || count >= 255)
+            {
+                return 0;
+            }
+
+            for (uint32_t attempt = 0; attempt != 256; ++attempt)
+            {
+                uint32_t const multiplier = 0x9E3779B1u + attempt * 2;
+                std::array<bool, size> used{};
+                bool unique{ true };
+
+                for (size_t index = 0; unique && index != count; ++index)
+                {
+                    uint32_t const slot = hash(keys[index], multiplier);
+                    unique = !used[slot];
+                    used[slot] = true;
+                }
+
+                if (unique)
+                {
+                    return multiplier;
+                }
+            }
+
+            return 0;
+        }
+
+        static constexpr uint32_t multiplier{ get_multiplier() };
+
+        static constexpr std::array<uint8_t, size> get_slots() noexcept
+        {
+            std::array<uint8_t, size> slots{};
+
+            if (multiplier != 0)
+            {
+                for (size_t index = 0; index != count; ++index)
+                {
+                    slots[hash(keys[index], multiplier)] = static_cast<uint8_t>(index + 1);
+                }
+            }
+
+            return slots;
+        }
+
+        static constexpr std::array<uint8_t, size> slots{ get_slots() };
+
+        template <typename Interface>
+        static void* cast(const T* obj) noexcept
+        {
+            return to_abi<Interface>(obj);
+        }
+
+        static void* find(const T* obj, const guid& iid) noexcept
+        {
+            if constexpr (multiplier == 0)
+            {
+                return interface_list<I...>::find(obj, iid_finder{ iid });
+            }
+            else
+            {
+                using cast_type = void*(*)(const T*) noexcept;
+#pragma warning(suppress: 4307)
+                static constexpr guid const* iids[]{ &guid_of<I>()... };
+                static constexpr cast_type casts[]{ &cast<I>... };
+
+                uint32_t const slot = slots[hash(iid.Data1, multiplier)];
+
+                if (slot != 0 && *iids[slot - 1] == iid)
+                {
+                    return casts[slot - 1](obj);
+                }
+
+                return nullptr;
+            }
+        }
+    };
+
     template <typename T>
     auto find_iid(const T* obj, const guid& iid) noexcept
     {
-        return static_cast<unknown_abi*>(implemented_interfaces<T>::find(obj, iid_finder{ iid }));
+        return static_cast<unknown_abi*>(interface_table<T, implemented_interfaces<T>>::find(obj, iid));
     }
 
     struct inspectable_finder
@@ -738,6 +895,7 @@ namespace winrt::impl
     struct WINRT_NOVTABLE root_implements
         : root_implements_composing_outer<std::disjunction_v<std::is_same<composing, I>...>>
         , root_implements_composable_inner<D, std::disjunction_v<std::is_same<composable, I>...>>
+        , allocated_with<typename implements_allocator<I...>::type>
     {
         using IInspectable = Windows::Foundation::IInspectable;
         using root_implements_type = root_implements;
@@ -872,6 +1030,10 @@ namespace winrt::impl
                     }
                 }
             }
+            else if constexpr (is_single_threaded::value)
+            {
+                return ++m_references;
+            }
             else
             {
                 return 1 + m_references.fetch_add(1, std::memory_order_relaxed);
@@ -1000,6 +1162,10 @@ namespace winrt::impl
                     }
                 }
             }
+            else if constexpr (is_single_threaded::value)
+            {
+                return --m_references;
+            }
             else
             {
                 return m_references.fetch_sub(1, std::memory_order_release) - 1;
@@ -1023,6 +1189,7 @@ namespace winrt::impl
         }
 
         using is_factory = std::disjunction<std::is_same<Windows::Foundation::IActivationFactory, I>...>;
+        using is_single_threaded = std::disjunction<std::is_same<single_threaded, I>...>;
 
     private:
 
@@ -1036,13 +1203,19 @@ namespace winrt::impl
             static constexpr bool value = get_value<D>(0);
         };
 
-        using is_agile = std::negation<std::disjunction<std::is_same<non_agile, I>...>>;
+        // A single_threaded object is only ever used on the thread that created it, so its reference count
+        // is a plain integer. It is therefore neither agile nor a weak reference source, since both would
+        // hand references to other threads: it answers neither IAgileObject nor IMarshal, and get_weak
+        // does not compile.
+
+        using is_agile = std::negation<std::disjunction<std::is_same<non_agile, I>..., is_single_threaded>>;
         using is_inspectable = std::disjunction<std::is_base_of<Windows::Foundation::IInspectable, I>...>;
-        using is_weak_ref_source = std::conjunction<is_inspectable, std::negation<is_factory>, std::negation<std::disjunction<std::is_same<no_weak_ref, I>...>>>;
+        using is_weak_ref_source = std::conjunction<is_inspectable, std::negation<is_factory>, std::negation<std::disjunction<std::is_same<no_weak_ref, I>..., is_single_threaded>>>;
         using use_module_lock = std::negation<std::disjunction<std::is_same<no_module_lock, I>...>>;
         using weak_ref_t = impl::weak_ref<is_agile::value>;
+        using reference_count_type = std::conditional_t<is_weak_ref_source::value, uintptr_t, uint32_t>;
 
-        std::atomic<std::conditional_t<is_weak_ref_source::value, uintptr_t, uint32_t>> m_references{ 1 };
+        std::conditional_t<is_single_threaded::value, reference_count_type, std::atomic<reference_count_type>> m_references{ 1 };
 
         int32_t query_interface(guid const& id, void** object) noexcept
         {
@@ -1217,7 +1390,7 @@ namespace winrt::impl
     }
 }
 
-namespace winrt
+WINRT_EXPORT namespace winrt
 {
     template <typename D, typename... Args>
     auto make(Args&&... args)
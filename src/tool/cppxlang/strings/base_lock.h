@@ -1,5 +1,318 @@
 
-namespace winrt
+#if defined(__linux__)
+WINRT_EXPORT namespace winrt::impl
+{
+    // Linux has no SRW locks, so slim_mutex and slim_condition_variable are built on futexes instead. The
+    // lock follows the same protocol as SRW locks from the caller's point of view: it is unfair, it is not
+    // recursive, and an uncontended acquire or release is a single atomic operation.
+
+    inline void futex_wait(std::atomic<uint32_t>& word, uint32_t const expected, timespec const* timeout = nullptr) noexcept
+    {
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, timeout, nullptr, 0);
+    }
+
+    inline bool futex_wake(std::atomic<uint32_t>& word, int32_t const count) noexcept
+    {
+        return syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0) > 0;
+    }
+
+    inline void spin_pause() noexcept
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+        __asm__ __volatile__("yield");
+#endif
+    }
+
+    struct futex_srwlock
+    {
+        // The low 30 bits of the state hold the number of readers, or all ones while a writer holds the
+        // lock. The two high bits record that readers or writers are parked. Writers park on their own
+        // word so that releasing the lock to one writer does not wake every reader.
+
+        static constexpr uint32_t mask{ (1u << 30) - 1 };
+        static constexpr uint32_t write_locked{ mask };
+        static constexpr uint32_t max_readers{ mask - 1 };
+        static constexpr uint32_t readers_waiting{ 1u << 30 };
+        static constexpr uint32_t writers_waiting{ 1u << 31 };
+
+        bool try_lock() noexcept
+        {
+            uint32_t state = m_state.load(std::memory_order_relaxed);
+
+            while (is_unlocked(state))
+            {
+                if (m_state.compare_exchange_weak(state, state + write_locked, std::memory_order_acquire, std::memory_order_relaxed))
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        bool try_lock_shared() noexcept
+        {
+            uint32_t state = m_state.load(std::memory_order_relaxed);
+
+            while (is_read_lockable(state))
+            {
+                if (m_state.compare_exchange_weak(state, state + 1, std::memory_order_acquire, std::memory_order_relaxed))
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        void lock() noexcept
+        {
+            uint32_t expected{};
+
+            if (!m_state.compare_exchange_weak(expected, write_locked, std::memory_order_acquire, std::memory_order_relaxed))
+            {
+                lock_contended();
+            }
+        }
+
+        void lock_shared() noexcept
+        {
+            uint32_t state = m_state.load(std::memory_order_relaxed);
+
+            if (!is_read_lockable(state) || !m_state.compare_exchange_weak(state, state + 1, std::memory_order_acquire, std::memory_order_relaxed))
+            {
+                lock_shared_contended();
+            }
+        }
+
+        void unlock() noexcept
+        {
+            uint32_t const state = m_state.fetch_sub(write_locked, std::memory_order_release) - write_locked;
+
+            if (state & (readers_waiting | writers_waiting))
+            {
+                wake_writer_or_readers(state);
+            }
+        }
+
+        void unlock_shared() noexcept
+        {
+            uint32_t const state = m_state.fetch_sub(1, std::memory_order_release) - 1;
+
+            if (is_unlocked(state) && (state & writers_waiting))
+            {
+                wake_writer_or_readers(state);
+            }
+        }
+
+    private:
+
+        static bool is_unlocked(uint32_t const state) noexcept
+        {
+            return (state & mask) == 0;
+        }
+
+        static bool is_write_locked(uint32_t const state) noexcept
+        {
+            return (state & mask) == write_locked;
+        }
+
+        static bool is_read_lockable(uint32_t const state) noexcept
+        {
+            // New readers queue behind parked writers so that a steady stream of readers cannot starve them.
+
+            return (state & mask) < max_readers && !(state & (readers_waiting | writers_waiting));
+        }
+
+        template <typename F>
+        uint32_t spin_until(F condition) const noexcept
+        {
+            // Most critical sections are short, so a contended thread first spins briefly in the hope that
+            // the lock is released before paying for a round trip through the kernel.
+
+            for (uint32_t spin = 100; ; --spin)
+            {
+                uint32_t const state = m_state.load(std::memory_order_relaxed);
+
+                if (condition(state) || spin == 0)
+                {
+                    return state;
+                }
+
+                spin_pause();
+            }
+        }
+
+        uint32_t spin_write() const noexcept
+        {
+            return spin_until([](uint32_t const state) { return is_unlocked(state) || (state & writers_waiting); });
+        }
+
+        uint32_t spin_read() const noexcept
+        {
+            return spin_until([](uint32_t const state) { return !is_write_locked(state) || (state & (readers_waiting | writers_waiting)); });
+        }
+
+        void lock_contended() noexcept
+        {
+            uint32_t state = spin_write();
+
+            // Once this writer has parked, it can't know whether other writers are still parked, so it keeps
+            // the flag set when it takes the lock and lets the next release find out.
+
+            uint32_t other_writers_waiting{};
+
+            while (true)
+            {
+                if (is_unlocked(state))
+                {
+                    if (m_state.compare_exchange_weak(state, state | write_locked | other_writers_waiting, std::memory_order_acquire, std::memory_order_relaxed))
+                    {
+                        return;
+                    }
+
+                    continue;
+                }
+
+                if (!(state & writers_waiting) && !m_state.compare_exchange_weak(state, state | writers_waiting, std::memory_order_relaxed))
+                {
+                    continue;
+                }
+
+                other_writers_waiting = writers_waiting;
+                uint32_t const sequence = m_writer_notify.load(std::memory_order_acquire);
+                state = m_state.load(std::memory_order_relaxed);
+
+                if (is_unlocked(state) || !(state & writers_waiting))
+                {
+                    continue;
+                }
+
+                futex_wait(m_writer_notify, sequence);
+                state = spin_write();
+            }
+        }
+
+        void lock_shared_contended() noexcept
+        {
+            uint32_t state = spin_read();
+
+            while (true)
+            {
+                if (is_read_lockable(state))
+                {
+                    if (m_state.compare_exchange_weak(state, state + 1, std::memory_order_acquire, std::memory_order_relaxed))
+                    {
+                        return;
+                    }
+
+                    continue;
+                }
+
+                WINRT_ASSERT((state & mask) != max_readers);
+
+                if (!(state & readers_waiting) && !m_state.compare_exchange_weak(state, state | readers_waiting, std::memory_order_relaxed))
+                {
+                    continue;
+                }
+
+                futex_wait(m_state, state | readers_waiting);
+                state = spin_read();
+            }
+        }
+
+        bool wake_writer() noexcept
+        {
+            m_writer_notify.fetch_add(1, std::memory_order_release);
+            return futex_wake(m_writer_notify, 1);
+        }
+
+        void wake_writer_or_readers(uint32_t state) noexcept
+        {
+            WINRT_ASSERT(is_unlocked(state));
+
+            // A writer is preferred over readers. If none turns out to be parked any more, the readers are
+            // woken instead so that they do not wait for a release that will never come.
+
+            if (state == writers_waiting)
+            {
+                if (m_state.compare_exchange_strong(state, 0, std::memory_order_relaxed))
+                {
+                    wake_writer();
+                    return;
+                }
+            }
+
+            if (state == (readers_waiting | writers_waiting))
+            {
+                if (!m_state.compare_exchange_strong(state, readers_waiting, std::memory_order_relaxed))
+                {
+                    return;
+                }
+
+                if (wake_writer())
+                {
+                    return;
+                }
+
+                state = readers_waiting;
+            }
+
+            if (state == readers_waiting && m_state.compare_exchange_strong(state, 0, std::memory_order_relaxed))
+            {
+                futex_wake(m_state, INT32_MAX);
+            }
+        }
+
+        std::atomic<uint32_t> m_state{};
+        std::atomic<uint32_t> m_writer_notify{};
+    };
+
+    struct futex_condition_variable
+    {
+        void wait(futex_srwlock& lock, uint32_t const milliseconds) noexcept
+        {
+            // A notification bumps the sequence, so one that arrives after the lock is released but before
+            // this thread parks makes the wait return immediately rather than being lost.
+
+            uint32_t const sequence = m_sequence.load(std::memory_order_relaxed);
+            lock.unlock();
+
+            if (milliseconds == 0xFFFFFFFF)
+            {
+                futex_wait(m_sequence, sequence);
+            }
+            else
+            {
+                timespec const timeout{ static_cast<time_t>(milliseconds / 1000), static_cast<long>(milliseconds % 1000) * 1'000'000 };
+                futex_wait(m_sequence, sequence, &timeout);
+            }
+
+            lock.lock();
+        }
+
+        void notify_one() noexcept
+        {
+            m_sequence.fetch_add(1, std::memory_order_relaxed);
+            futex_wake(m_sequence, 1);
+        }
+
+        void notify_all() noexcept
+        {
+            m_sequence.fetch_add(1, std::memory_order_relaxed);
+            futex_wake(m_sequence, INT32_MAX);
+        }
+
+    private:
+
+        std::atomic<uint32_t> m_sequence{};
+    };
+}
+#endif
+
+WINRT_EXPORT namespace winrt
 {
     struct slim_condition_variable;
 
@@ -11,32 +324,56 @@ namespace winrt
 
         void lock() noexcept
         {
+#if defined(__linux__)
+            m_lock.lock();
+#else
             WINRT_AcquireSRWLockExclusive(&m_lock);
+#endif
         }
 
         void lock_shared() noexcept
         {
+#if defined(__linux__)
+            m_lock.lock_shared();
+#else
             WINRT_AcquireSRWLockShared(&m_lock);
+#endif
         }
 
         bool try_lock() noexcept
         {
+#if defined(__linux__)
+            return m_lock.try_lock();
+#else
             return 0 != WINRT_TryAcquireSRWLockExclusive(&m_lock);
+#endif
         }
 
         bool try_lock_shared() noexcept
         {
+#if defined(__linux__)
+            return m_lock.try_lock_shared();
+#else
             return 0 != WINRT_TryAcquireSRWLockShared(&m_lock);
+#endif
         }
 
         void unlock() noexcept
         {
+#if defined(__linux__)
+            m_lock.unlock();
+#else
             WINRT_ReleaseSRWLockExclusive(&m_lock);
+#endif
         }
 
         void unlock_shared() noexcept
         {
+#if defined(__linux__)
+            m_lock.unlock_shared();
+#else
             WINRT_ReleaseSRWLockShared(&m_lock);
+#endif
         }
 
     private:
@@ -47,7 +384,11 @@ namespace winrt
             return &m_lock;
         }
 
+#if defined(__linux__)
+        impl::futex_srwlock m_lock;
+#else
         impl::srwlock m_lock{};
+#endif
     };
 
     struct slim_lock_guard
@@ -95,7 +436,11 @@ namespace winrt
         {
             while (!predicate())
             {
+#if defined(__linux__)
+                m_cv.wait(*x.get(), 0xFFFFFFFF);
+#else
                 WINRT_VERIFY(WINRT_SleepConditionVariableSRW(&m_cv, x.get(), 0xFFFFFFFF /*INFINITE*/, 0));
+#endif
             }
         }
 
@@ -113,10 +458,14 @@ namespace winrt
                     return false;
                 }
 
+#if defined(__linux__)
+                m_cv.wait(*x.get(), static_cast<uint32_t>(milliseconds));
+#else
                 if (!WINRT_SleepConditionVariableSRW(&m_cv, x.get(), static_cast<uint32_t>(milliseconds), 0))
                 {
                     return predicate();
                 }
+#endif
             }
 
             return true;
@@ -124,15 +473,27 @@ namespace winrt
 
         void notify_one() noexcept
         {
+#if defined(__linux__)
+            m_cv.notify_one();
+#else
             WINRT_WakeConditionVariable(&m_cv);
+#endif
         }
 
         void notify_all() noexcept
         {
+#if defined(__linux__)
+            m_cv.notify_all();
+#else
             WINRT_WakeAllConditionVariable(&m_cv);
+#endif
         }
 
     private:
+#if defined(__linux__)
+        impl::futex_condition_variable m_cv;
+#else
         impl::condition_variable m_cv{};
+#endif
     };
 }
@@ -27,6 +27,10 @@
 
 #define WINRT_SHIM(...) (*(abi_t<__VA_ARGS__>**)&static_cast<__VA_ARGS__ const&>(static_cast<D const&>(*this)))
 
+#ifndef WINRT_EXPORT
+#define WINRT_EXPORT
+#endif
+
 #ifndef WINRT_EXTERNAL_CATCH_CLAUSE
 #define WINRT_EXTERNAL_CATCH_CLAUSE
 #endif
@@ -0,0 +1,500 @@
+
+WINRT_EXPORT namespace winrt::impl
+{
+    // Delegates, iterators, key/value pairs, event arrays and coroutine frames are small and short-lived, and
+    // iterating a map creates one of them per element, so they come from a pool rather than the global heap.
+    // Sizes are rounded up to one of 32 classes of 16 bytes. Each thread keeps a free list per class, and
+    // moves blocks to and from a central list in batches, so only every 64th allocation or so takes a lock.
+    // Blocks are carved out of 64KB chunks that are aligned to their size, which lets a block find the
+    // chunk header (and so the arena, if any, that it came from) by masking its address. Larger sizes go
+    // straight to the global operator new.
+
+    inline constexpr size_t pool_chunk_size{ 64 * 1024 };
+    inline constexpr size_t pool_chunk_header_size{ 64 };
+    inline constexpr size_t pool_granularity{ 16 };
+    inline constexpr size_t pool_max_size{ 512 };
+    inline constexpr size_t pool_class_count{ pool_max_size / pool_granularity };
+    inline constexpr uint32_t pool_batch_size{ 64 };
+    inline constexpr uint32_t pool_cache_limit{ 4 * pool_batch_size };
+    inline constexpr uint32_t pool_spare_chunk_limit{ 4 };
+
+    struct pool_arena_state;
+    struct pool_arena_scope;
+
+    struct pool_chunk
+    {
+        pool_arena_state* arena;
+        pool_chunk* next;
+    };
+
+    static_assert(sizeof(pool_chunk) <= pool_chunk_header_size);
+
+    struct pool_block
+    {
+        pool_block* next;
+    };
+
+    struct pool_list
+    {
+        pool_block* head;
+        uint32_t count;
+    };
+
+    inline pool_chunk* allocate_pool_chunk(pool_arena_state* arena)
+    {
+        auto chunk = static_cast<pool_chunk*>(::operator new(pool_chunk_size, std::align_val_t{ pool_chunk_size }));
+        chunk->arena = arena;
+        chunk->next = nullptr;
+        return chunk;
+    }
+
+    inline void free_pool_chunk(pool_chunk* chunk) noexcept
+    {
+        ::operator delete(static_cast<void*>(chunk), std::align_val_t{ pool_chunk_size });
+    }
+
+    inline pool_chunk* pool_chunk_of(void* pointer) noexcept
+    {
+        return reinterpret_cast<pool_chunk*>(reinterpret_cast<uintptr_t>(pointer) & ~static_cast<uintptr_t>(pool_chunk_size - 1));
+    }
+
+    struct pool_central
+    {
+        slim_mutex lock;
+        pool_list lists[pool_class_count]{};
+    };
+
+    inline pool_central& get_pool_central() noexcept
+    {
+        // The central lists are never destroyed, since blocks may be freed by threads that outlive main.
+
+        static pool_central* const central{ new pool_central };
+        return *central;
+    }
+
+    struct pool_thread
+    {
+        pool_list lists[pool_class_count];
+        pool_arena_scope* arena;
+        pool_chunk* spare_chunks;
+        uint32_t spare_chunk_count;
+        bool exited;
+    };
+
+    // The thread state is trivially destructible so that it can still be used by objects that are freed from
+    // other thread_local destructors. A separate object returns the thread's blocks when the thread exits.
+
+    inline thread_local pool_thread t_pool_thread{};
+
+    inline void pool_give(size_t const size_class, pool_block* head, pool_block* tail, uint32_t const count) noexcept
+    {
+        pool_central& central = get_pool_central();
+        slim_lock_guard const guard(central.lock);
+        pool_list& list = central.lists[size_class];
+        tail->next = list.head;
+        list.head = head;
+        list.count += count;
+    }
+
+    struct pool_thread_exit
+    {
+        ~pool_thread_exit() noexcept
+        {
+            pool_thread& thread = t_pool_thread;
+
+            for (size_t size_class = 0; size_class != pool_class_count; ++size_class)
+            {
+                pool_list& list = thread.lists[size_class];
+
+                if (list.head)
+                {
+                    pool_block* tail = list.head;
+
+                    while (tail->next)
+                    {
+                        tail = tail->next;
+                    }
+
+                    pool_give(size_class, list.head, tail, list.count);
+                    list = {};
+                }
+            }
+
+            while (thread.spare_chunks)
+            {
+                pool_chunk* const next = thread.spare_chunks->next;
+                free_pool_chunk(thread.spare_chunks);
+                thread.spare_chunks = next;
+            }
+
+            thread.spare_chunk_count = 0;
+            thread.exited = true;
+        }
+    };
+
+    // An arena's chunks are kept by the thread when it goes out of scope, so that the next arena doesn't
+    // have to go back to the global heap for them.
+
+    inline pool_chunk* acquire_arena_chunk()
+    {
+        pool_thread& thread = t_pool_thread;
+
+        if (pool_chunk* const chunk = thread.spare_chunks)
+        {
+            thread.spare_chunks = chunk->next;
+            --thread.spare_chunk_count;
+            return chunk;
+        }
+
+        static thread_local pool_thread_exit const thread_exit;
+        return allocate_pool_chunk(nullptr);
+    }
+
+    inline void release_arena_chunks(pool_chunk* chunks) noexcept
+    {
+        // The last object from an arena that outlived it may be released on any thread, which then keeps
+        // the chunks, and so needs to free them when it exits.
+
+        static thread_local pool_thread_exit const thread_exit;
+        pool_thread& thread = t_pool_thread;
+
+        while (chunks)
+        {
+            pool_chunk* const next = chunks->next;
+
+            if (thread.spare_chunk_count == pool_spare_chunk_limit || thread.exited)
+            {
+                free_pool_chunk(chunks);
+            }
+            else
+            {
+                chunks->next = thread.spare_chunks;
+                thread.spare_chunks = chunks;
+                ++thread.spare_chunk_count;
+            }
+
+            chunks = next;
+        }
+    }
+
+    struct pool_arena_state
+    {
+        // Kept at the start of an arena's first chunk, which every chunk of the arena points to, so that it
+        // is freed along with them. Blocks freed on the arena's thread while it is in scope are counted
+        // without an atomic operation. Blocks freed anywhere else subtract from outstanding, to which the
+        // scope adds the blocks it left live when it ends, so the last block to be freed, or the end of
+        // the scope if there are none left, releases the chunks.
+
+        explicit pool_arena_state(pool_chunk* const first) noexcept : chunks(first)
+        {
+        }
+
+        pool_thread* const owner{ &t_pool_thread };
+        pool_chunk* chunks{};
+        size_t local_released{};
+        bool active{ true };
+        std::atomic<size_t> outstanding{};
+    };
+
+    inline constexpr size_t pool_arena_state_size{ (sizeof(pool_arena_state) + pool_granularity - 1) & ~(pool_granularity - 1) };
+
+    struct pool_arena_scope
+    {
+        // An arena in scope hands out blocks by bumping a pointer, and only counts the blocks it hands out.
+        // Its state is only created with its first chunk, so an arena that allocates nothing costs nothing.
+
+        void* allocate(size_t const size)
+        {
+            size_t const rounded = (std::max)((size + pool_granularity - 1) & ~(pool_granularity - 1), pool_granularity);
+
+            if (rounded > static_cast<size_t>(end - next))
+            {
+                pool_chunk* const chunk = acquire_arena_chunk();
+                next = reinterpret_cast<char*>(chunk) + pool_chunk_header_size;
+                end = reinterpret_cast<char*>(chunk) + pool_chunk_size;
+
+                if (state)
+                {
+                    chunk->next = state->chunks;
+                    state->chunks = chunk;
+                }
+                else
+                {
+                    chunk->next = nullptr;
+                    state = ::new(next) pool_arena_state(chunk);
+                    next += pool_arena_state_size;
+                }
+
+                chunk->arena = state;
+            }
+
+            void* const result = next;
+            next += rounded;
+            ++allocated;
+            return result;
+        }
+
+        size_t live() const noexcept
+        {
+            return state ? allocated - state->local_released + state->outstanding.load(std::memory_order_acquire) : 0;
+        }
+
+        pool_arena_scope* previous{};
+        pool_arena_state* state{};
+        char* next{};
+        char* end{};
+        size_t allocated{};
+    };
+
+    inline void end_arena_scope(pool_arena_scope const& scope) noexcept
+    {
+        if (pool_arena_state* const state = scope.state)
+        {
+            state->active = false;
+            size_t const live = scope.allocated - state->local_released;
+
+            if (state->outstanding.fetch_add(live, std::memory_order_acq_rel) + live == 0)
+            {
+                release_arena_chunks(state->chunks);
+            }
+        }
+    }
+
+    inline void arena_release(pool_arena_state* const state) noexcept
+    {
+        if (state->owner == &t_pool_thread && state->active)
+        {
+            ++state->local_released;
+        }
+        else if (state->outstanding.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            release_arena_chunks(state->chunks);
+        }
+    }
+
+    inline void pool_refill(pool_thread& thread, size_t const size_class)
+    {
+        static thread_local pool_thread_exit const thread_exit;
+        uint32_t const batch_size = thread.exited ? 1 : pool_batch_size;
+        pool_central& central = get_pool_central();
+        slim_lock_guard const guard(central.lock);
+        pool_list& source = central.lists[size_class];
+
+        if (!source.head)
+        {
+            size_t const block_size = (size_class + 1) * pool_granularity;
+            uint32_t const count = static_cast<uint32_t>((pool_chunk_size - pool_chunk_header_size) / block_size);
+            char* const first = reinterpret_cast<char*>(allocate_pool_chunk(nullptr)) + pool_chunk_header_size;
+
+            for (uint32_t index = count; index != 0; --index)
+            {
+                auto block = reinterpret_cast<pool_block*>(first + (index - 1) * block_size);
+                block->next = source.head;
+                source.head = block;
+            }
+
+            source.count = count;
+        }
+
+        pool_block* tail = source.head;
+        uint32_t count = 1;
+
+        while (count != batch_size && tail->next)
+        {
+            tail = tail->next;
+            ++count;
+        }
+
+        pool_list& list = thread.lists[size_class];
+        list.head = source.head;
+        list.count = count;
+        source.head = tail->next;
+        source.count -= count;
+        tail->next = nullptr;
+    }
+
+    inline void* pool_allocate(size_t const size)
+    {
+        if (size > pool_max_size)
+        {
+            return ::operator new(size);
+        }
+
+        pool_thread& thread = t_pool_thread;
+        size_t const size_class = size == 0 ? 0 : (size - 1) / pool_granularity;
+        pool_list& list = thread.lists[size_class];
+
+        if (!list.head)
+        {
+            pool_refill(thread, size_class);
+        }
+
+        pool_block* const block = list.head;
+        list.head = block->next;
+        --list.count;
+        return block;
+    }
+
+    inline void pool_deallocate(void* pointer, size_t const size) noexcept
+    {
+        if (!pointer)
+        {
+            return;
+        }
+
+        if (size > pool_max_size)
+        {
+            ::operator delete(pointer);
+            return;
+        }
+
+        size_t const size_class = size == 0 ? 0 : (size - 1) / pool_granularity;
+        auto const block = static_cast<pool_block*>(pointer);
+        pool_thread& thread = t_pool_thread;
+
+        if (thread.exited)
+        {
+            pool_give(size_class, block, block, 1);
+            return;
+        }
+
+        // A thread may only ever free blocks that other threads allocated, and must still return the
+        // blocks it caches when it exits.
+
+        static thread_local pool_thread_exit const thread_exit;
+        pool_list& list = thread.lists[size_class];
+        block->next = list.head;
+        list.head = block;
+
+        if (++list.count == pool_cache_limit)
+        {
+            pool_block* tail = block;
+
+            for (uint32_t count = 1; count != pool_batch_size; ++count)
+            {
+                tail = tail->next;
+            }
+
+            list.head = tail->next;
+            list.count -= pool_batch_size;
+            pool_give(size_class, block, tail, pool_batch_size);
+        }
+    }
+
+    inline void* arena_allocate(size_t const size)
+    {
+        pool_arena_scope* const scope = t_pool_thread.arena;
+
+        if (!scope || size > pool_max_size)
+        {
+            return pool_allocate(size);
+        }
+
+        return scope->allocate(size);
+    }
+
+    inline void arena_deallocate(void* pointer, size_t const size) noexcept
+    {
+        if (pointer && size <= pool_max_size)
+        {
+            if (pool_arena_state* const state = pool_chunk_of(pointer)->arena)
+            {
+                arena_release(state);
+                return;
+            }
+        }
+
+        pool_deallocate(pointer, size);
+    }
+}
+
+WINRT_EXPORT namespace winrt
+{
+    struct pool_allocator
+    {
+        static void* allocate(size_t const size)
+        {
+            return impl::pool_allocate(size);
+        }
+
+        static void deallocate(void* pointer, size_t const size) noexcept
+        {
+            impl::pool_deallocate(pointer, size);
+        }
+    };
+
+    struct arena_allocator
+    {
+        // Allocates from the pool_arena in scope on the calling thread, if any, and otherwise from the pool.
+
+        static void* allocate(size_t const size)
+        {
+            return impl::arena_allocate(size);
+        }
+
+        static void deallocate(void* pointer, size_t const size) noexcept
+        {
+            impl::arena_deallocate(pointer, size);
+        }
+    };
+
+    struct pool_arena
+    {
+        // While an arena is in scope, objects allocated with arena_allocator on this thread come from the
+        // arena, so a burst of short-lived objects costs a pointer bump each. Collection iterators and
+        // key/value pairs use it, as may any implementation with allocate_with<arena_allocator>. Other pool
+        // objects, such as delegates, event arrays and coroutine frames, never come from an arena. Arenas
+        // nest. Objects from an arena may be released on any thread, and may outlive it, in which case its
+        // chunks are only released along with the last of them.
+
+        pool_arena() noexcept
+        {
+            m_scope.previous = impl::t_pool_thread.arena;
+            impl::t_pool_thread.arena = &m_scope;
+        }
+
+        ~pool_arena() noexcept
+        {
+            WINRT_ASSERT(impl::t_pool_thread.arena == &m_scope);
+            impl::t_pool_thread.arena = m_scope.previous;
+            impl::end_arena_scope(m_scope);
+        }
+
+        pool_arena(pool_arena const&) = delete;
+        pool_arena& operator=(pool_arena const&) = delete;
+
+        // The number of objects from the arena that are still live.
+
+        size_t live() const noexcept
+        {
+            return m_scope.live();
+        }
+
+    private:
+
+        impl::pool_arena_scope m_scope;
+    };
+}
+
+WINRT_EXPORT namespace winrt::impl
+{
+    // Gives a class its operator new and delete from Allocator, which provides static allocate(size) and
+    // deallocate(pointer, size) functions. The size passed to delete is that of the most derived type.
+
+    template <typename Allocator>
+    struct allocated_with
+    {
+        static void* operator new(size_t const size)
+        {
+            return Allocator::allocate(size);
+        }
+
+        static void operator delete(void* pointer, size_t const size) noexcept
+        {
+            Allocator::deallocate(pointer, size);
+        }
+    };
+
+    template <>
+    struct allocated_with<void> {};
+}
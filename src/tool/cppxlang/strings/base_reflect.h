@@ -1,5 +1,5 @@
 
-namespace winrt::experimental::reflect
+WINRT_EXPORT namespace winrt::experimental::reflect
 {
     template <typename T>
     struct base_type
@@ -23,13 +23,13 @@ namespace winrt::experimental::reflect
     using properties_t = typename properties<T>::type;
 
     template <typename T, typename Func>
-    static constexpr inline auto for_each_property(Func&& func)
+    constexpr inline auto for_each_property(Func&& func)
     {
         return impl::for_each<properties_t<T>>::apply(std::forward<Func>(func));
     }
 
     template <typename T, typename Func>
-    static constexpr inline bool find_property_if(Func&& func)
+    constexpr inline bool find_property_if(Func&& func)
     {
         return impl::find_if<properties_t<T>>::apply(std::forward<Func>(func));
     }
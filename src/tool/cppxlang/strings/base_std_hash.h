@@ -1,5 +1,5 @@
 
-namespace winrt::impl
+WINRT_EXPORT namespace winrt::impl
 {
     inline size_t hash_data(void const* ptr, size_t const bytes) noexcept
     {
@@ -1,5 +1,5 @@
 
-namespace winrt::param
+WINRT_EXPORT namespace winrt::param
 {
     struct hstring
     {
@@ -60,7 +60,7 @@ namespace winrt::param
     }
 }
 
-namespace winrt::impl
+WINRT_EXPORT namespace winrt::impl
 {
     template <typename T>
     using param_type = std::conditional_t<std::is_same_v<T, hstring>, param::hstring, T>;
@@ -1,5 +1,5 @@
 
-namespace winrt
+WINRT_EXPORT namespace winrt
 {
     inline bool operator==(hstring const& left, hstring const& right) noexcept
     {
@@ -94,7 +94,7 @@ namespace winrt
     bool operator>=(std::nullptr_t left, hstring const& right) = delete;
 }
 
-namespace winrt::impl
+WINRT_EXPORT namespace winrt::impl
 {
     inline hstring concat_hstring(std::wstring_view const& left, std::wstring_view const& right)
     {
@@ -105,7 +105,7 @@ namespace winrt::impl
     }
 }
 
-namespace winrt
+WINRT_EXPORT namespace winrt
 {
     inline hstring operator+(hstring const& left, hstring const& right)
     {
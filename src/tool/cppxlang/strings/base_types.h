@@ -1,5 +1,5 @@
 
-namespace winrt::impl
+WINRT_EXPORT namespace winrt::impl
 {
 #ifdef __IUnknown_INTERFACE_DEFINED__
 #define WINRT_WINDOWS_ABI
@@ -23,7 +23,7 @@ namespace winrt::impl
     }
 }
 
-namespace winrt
+WINRT_EXPORT namespace winrt
 {
     struct hresult
     {
@@ -88,7 +88,7 @@ namespace winrt
     }
 }
 
-namespace winrt::Windows::Foundation
+WINRT_EXPORT namespace winrt::Windows::Foundation
 {
     enum class TrustLevel : int32_t
     {
@@ -16,7 +16,7 @@ inline char const * const WINRT_version = "C++/WinRT version:" CPPWINRT_VERSION;
 #pragma comment(linker, "/include:WINRT_version")
 #endif
 
-namespace winrt
+WINRT_EXPORT namespace winrt
 {
     template <size_t BaseSize, size_t ComponentSize>
     constexpr bool check_version(char const(&base)[BaseSize], char const(&component)[ComponentSize]) noexcept
@@ -1,5 +1,5 @@
 
-namespace winrt::impl
+WINRT_EXPORT namespace winrt::impl
 {
     template <typename T>
     using com_ref = std::conditional_t<std::is_base_of_v<Windows::Foundation::IUnknown, T>, T, com_ptr<T>>;
@@ -43,7 +43,7 @@ namespace winrt::impl
     }
 }
 
-namespace winrt::Windows::Foundation
+WINRT_EXPORT namespace winrt::Windows::Foundation
 {
     struct IUnknown
     {
@@ -165,7 +165,7 @@ namespace winrt::Windows::Foundation
     };
 }
 
-namespace winrt
+WINRT_EXPORT namespace winrt
 {
     template <typename T, typename = std::enable_if_t<!std::is_base_of_v<Windows::Foundation::IUnknown, T>>>
     auto get_abi(T const& object) noexcept
@@ -272,7 +272,7 @@ namespace winrt
 #endif
 }
 
-namespace winrt::Windows::Foundation
+WINRT_EXPORT namespace winrt::Windows::Foundation
 {
     inline bool operator==(IUnknown const& left, IUnknown const& right) noexcept
     {
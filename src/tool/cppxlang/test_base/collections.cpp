@@ -0,0 +1,306 @@
+#include "catch.hpp"
+#include <winrt/Windows.Foundation.Collections.h>
+#include <algorithm>
+
+// Tests how range-for loops and algorithms over projected collections call across the ABI.
+
+using namespace winrt;
+using namespace Windows::Foundation::Collections;
+
+namespace
+{
+    struct calls
+    {
+        uint32_t get_at{};
+        uint32_t get_many{};
+        uint32_t move_next{};
+        uint32_t current{};
+    };
+
+    struct values_iterator : implements<values_iterator, IIterator<int32_t>>
+    {
+        values_iterator(std::vector<int32_t> const& values, calls& count) noexcept : m_values(values), m_count(count)
+        {
+        }
+
+        int32_t Current()
+        {
+            ++m_count.current;
+
+            if (m_index == m_values.size())
+            {
+                throw hresult_out_of_bounds();
+            }
+
+            return m_values[m_index];
+        }
+
+        bool HasCurrent() const noexcept
+        {
+            return m_index != m_values.size();
+        }
+
+        bool MoveNext() noexcept
+        {
+            ++m_count.move_next;
+
+            if (m_index != m_values.size())
+            {
+                ++m_index;
+            }
+
+            return m_index != m_values.size();
+        }
+
+        uint32_t GetMany(array_view<int32_t> items) noexcept
+        {
+            ++m_count.get_many;
+            uint32_t const count = (std::min)(items.size(), static_cast<uint32_t>(m_values.size() - m_index));
+            std::copy_n(m_values.begin() + m_index, count, items.begin());
+            m_index += count;
+            return count;
+        }
+
+    private:
+
+        std::vector<int32_t> const& m_values;
+        calls& m_count;
+        size_t m_index{};
+    };
+
+    struct values : implements<values, IVectorView<int32_t>, IIterable<int32_t>>
+    {
+        explicit values(uint32_t const size)
+        {
+            for (uint32_t index = 0; index != size; ++index)
+            {
+                m_values.push_back(static_cast<int32_t>(index));
+            }
+        }
+
+        int32_t GetAt(uint32_t const index)
+        {
+            ++count.get_at;
+
+            if (index >= m_values.size())
+            {
+                throw hresult_out_of_bounds();
+            }
+
+            return m_values[index];
+        }
+
+        uint32_t Size() const noexcept
+        {
+            return static_cast<uint32_t>(m_values.size());
+        }
+
+        bool IndexOf(int32_t const value, uint32_t& index) const noexcept
+        {
+            auto found = std::find(m_values.begin(), m_values.end(), value);
+            index = static_cast<uint32_t>(found - m_values.begin());
+            return found != m_values.end();
+        }
+
+        uint32_t GetMany(uint32_t const start, array_view<int32_t> items) noexcept
+        {
+            ++count.get_many;
+
+            if (start >= m_values.size())
+            {
+                return 0;
+            }
+
+            uint32_t const result = (std::min)(items.size(), static_cast<uint32_t>(m_values.size() - start));
+            std::copy_n(m_values.begin() + start, result, items.begin());
+            return result;
+        }
+
+        IIterator<int32_t> First()
+        {
+            return make<values_iterator>(m_values, count);
+        }
+
+        calls count;
+
+    private:
+
+        std::vector<int32_t> m_values;
+    };
+
+    int64_t expected_sum(uint32_t const size)
+    {
+        return static_cast<int64_t>(size) * (size - 1) / 2;
+    }
+}
+
+TEST_CASE("collections_vector_batches")
+{
+    // Batches start small and double up to the default of 64, so 1000 elements take 4 + 8 + 16 + 32
+    // elements and then 15 batches of 64.
+
+    auto implementation = make_self<values>(1000);
+    IVectorView<int32_t> const view = implementation.as<IVectorView<int32_t>>();
+    int64_t sum{};
+
+    for (int32_t value : view)
+    {
+        sum += value;
+    }
+
+    REQUIRE(sum == expected_sum(1000));
+    REQUIRE(implementation->count.get_many == 19);
+    REQUIRE(implementation->count.get_at == 0);
+}
+
+TEST_CASE("collections_vector_lazy")
+{
+    // Nothing is fetched until an element is read, and a loop that stops early only fetches one small
+    // batch.
+
+    auto implementation = make_self<values>(1000);
+    IVectorView<int32_t> const view = implementation.as<IVectorView<int32_t>>();
+
+    auto first = begin(view);
+    auto last = end(view);
+    REQUIRE(first != last);
+    REQUIRE(implementation->count.get_many == 0);
+
+    for (int32_t value : view)
+    {
+        if (value == 2)
+        {
+            break;
+        }
+    }
+
+    REQUIRE(implementation->count.get_many == 1);
+}
+
+TEST_CASE("collections_vector_algorithms")
+{
+    // Copies of an iterator fetch their own batch, and reading past the end still throws.
+
+    auto implementation = make_self<values>(100);
+    IVectorView<int32_t> const view = implementation.as<IVectorView<int32_t>>();
+
+    REQUIRE(std::count_if(begin(view), end(view), [](int32_t value) { return value % 2 == 0; }) == 50);
+    REQUIRE(*std::find(begin(view), end(view), 42) == 42);
+
+    auto copy = begin(view);
+    auto other = copy;
+    ++other;
+    REQUIRE(*copy == 0);
+    REQUIRE(*other == 1);
+
+    REQUIRE_THROWS_AS(*end(view), hresult_out_of_bounds);
+}
+
+TEST_CASE("collections_vector_mutation")
+{
+    // A loop reads its current batch, so a change to an element it has already fetched is only seen by a
+    // later loop, while a change further on is seen when its batch is fetched. Reading past the end of a
+    // collection that shrinks still throws.
+
+    IVector<int32_t> const vector = single_threaded_vector<int32_t>({ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 });
+    std::vector<int32_t> seen;
+
+    for (int32_t value : vector)
+    {
+        if (value == 0)
+        {
+            vector.SetAt(1, -1);
+            vector.SetAt(8, -8);
+        }
+
+        seen.push_back(value);
+    }
+
+    REQUIRE(seen == std::vector<int32_t>{ 0, 1, 2, 3, 4, 5, 6, 7, -8, 9 });
+    REQUIRE(vector.GetAt(1) == -1);
+
+    REQUIRE_THROWS_AS([&]
+    {
+        for (int32_t value : vector)
+        {
+            (void)value;
+            vector.RemoveAtEnd();
+        }
+    }(), hresult_out_of_bounds);
+
+    REQUIRE(vector.Size() < 10);
+}
+
+TEST_CASE("collections_batched_vector")
+{
+    auto implementation = make_self<values>(1000);
+    IVectorView<int32_t> const view = implementation.as<IVectorView<int32_t>>();
+    int64_t sum{};
+
+    for (int32_t value : batched(view, 500))
+    {
+        sum += value;
+    }
+
+    // 4 + 8 + ... + 256 elements, which is 508, and then one batch of the other 492.
+
+    REQUIRE(sum == expected_sum(1000));
+    REQUIRE(implementation->count.get_many == 8);
+}
+
+TEST_CASE("collections_iterable_begin")
+{
+    // begin returns the IIterator itself, so an IIterable loop still walks it one element at a time.
+
+    auto implementation = make_self<values>(100);
+    IIterable<int32_t> const iterable = implementation.as<IIterable<int32_t>>();
+    static_assert(std::is_same_v<decltype(begin(iterable)), IIterator<int32_t>>);
+    static_assert(std::is_same_v<decltype(end(iterable)), IIterator<int32_t>>);
+
+    int64_t sum{};
+
+    for (int32_t value : iterable)
+    {
+        sum += value;
+    }
+
+    REQUIRE(sum == expected_sum(100));
+    REQUIRE(implementation->count.get_many == 0);
+    REQUIRE(implementation->count.current == 100);
+    REQUIRE(implementation->count.move_next == 100);
+
+    IIterable<int32_t> const empty = make<values>(0).as<IIterable<int32_t>>();
+    REQUIRE(begin(empty) == end(empty));
+}
+
+TEST_CASE("collections_batched_iterable")
+{
+    auto implementation = make_self<values>(1000);
+    IIterable<int32_t> const iterable = implementation.as<IIterable<int32_t>>();
+    int64_t sum{};
+
+    for (int32_t value : batched(iterable))
+    {
+        sum += value;
+    }
+
+    // The same 19 batches as a vector, and one more that finds the end.
+
+    REQUIRE(sum == expected_sum(1000));
+    REQUIRE(implementation->count.get_many == 20);
+    REQUIRE(implementation->count.current == 0);
+    REQUIRE(implementation->count.move_next == 0);
+
+    // Copies of an iterator share the position, as copies of an IIterator do.
+
+    auto range = batched(iterable, 7);
+    auto first = range.begin();
+    auto copy = first;
+    REQUIRE(*first == 0);
+    ++copy;
+    REQUIRE(*first == 1);
+    REQUIRE(std::find(first, range.end(), 500) != range.end());
+    REQUIRE(*copy == 500);
+    REQUIRE(std::find(first, range.end(), 5000) == range.end());
+    REQUIRE(first == range.end());
+}
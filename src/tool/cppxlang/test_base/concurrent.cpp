@@ -0,0 +1,236 @@
+#include "catch.hpp"
+#include <winrt/Windows.Foundation.Collections.h>
+#include <thread>
+
+// Stresses multi_threaded_vector and multi_threaded_map with readers on several threads while a writer keeps
+// changing them. On Linux these tests are built with the address and undefined behavior sanitizers, which
+// catch a read of a buffer the vector has moved away from. Every value the writer stores is even, so a
+// reader that sees an odd value has seen a torn or stale read.
+
+using namespace winrt;
+using namespace Windows::Foundation::Collections;
+
+namespace
+{
+    // Each round starts from an empty collection, so that a vector grows into new buffers many times
+    // over, and the writer yields after every change, so that the readers interleave with it even on a
+    // single processor.
+
+    constexpr int32_t round_count{ 50 };
+    constexpr int32_t write_count{ 40 };
+
+    template <typename Collection, typename Reader, typename Writer>
+    void stress(Collection make, Reader reader, Writer writer)
+    {
+        for (int32_t round = 0; round != round_count; ++round)
+        {
+            auto const collection = make();
+            std::atomic<uint32_t> ready{};
+            std::atomic<bool> done{};
+            std::atomic<uint32_t> failures{};
+            std::vector<std::thread> readers;
+
+            for (int thread = 0; thread != 3; ++thread)
+            {
+                readers.emplace_back([&]
+                {
+                    ++ready;
+
+                    while (!done)
+                    {
+                        if (!reader(collection))
+                        {
+                            ++failures;
+                        }
+                    }
+                });
+            }
+
+            while (ready != readers.size())
+            {
+                std::this_thread::yield();
+            }
+
+            for (int32_t index = 0; index != write_count; ++index)
+            {
+                writer(collection, index);
+                std::this_thread::yield();
+            }
+
+            done = true;
+
+            for (auto&& thread : readers)
+            {
+                thread.join();
+            }
+
+            REQUIRE(failures == 0);
+        }
+    }
+
+    bool is_even(int32_t const value) noexcept
+    {
+        return value % 2 == 0;
+    }
+}
+
+TEST_CASE("concurrent_vector")
+{
+    stress([]
+    {
+        return multi_threaded_vector<int32_t>();
+    },
+    [](IVector<int32_t> const& vector)
+    {
+        bool valid = true;
+        uint32_t const size = vector.Size();
+
+        for (uint32_t index = 0; index < size; ++index)
+        {
+            try
+            {
+                valid = valid && is_even(vector.GetAt(index));
+            }
+            catch (hresult_out_of_bounds const&)
+            {
+                // The writer removed the element after the size was read.
+            }
+        }
+
+        int32_t values[16]{};
+        uint32_t const count = vector.GetMany(size / 2, values);
+
+        for (uint32_t index = 0; index != count; ++index)
+        {
+            valid = valid && is_even(values[index]);
+        }
+
+        for (int32_t value : IIterable<int32_t>(vector))
+        {
+            valid = valid && is_even(value);
+        }
+
+        uint32_t found{};
+        vector.IndexOf(4, found);
+        return valid;
+    },
+    [](IVector<int32_t> const& vector, int32_t const index)
+    {
+        // Appending grows the vector into new buffers while readers may still be copying out of the old.
+
+        vector.Append(index * 2);
+
+        if (index % 7 == 0)
+        {
+            vector.SetAt(vector.Size() / 2, index * 4);
+        }
+
+        if (index % 11 == 0)
+        {
+            vector.InsertAt(0, 0);
+        }
+
+        if (index % 13 == 0)
+        {
+            vector.RemoveAt(0);
+        }
+
+        if (index % 20 == 19)
+        {
+            vector.Clear();
+        }
+
+        if (index % 31 == 0)
+        {
+            int32_t const values[]{ 2, 4, 6 };
+            vector.ReplaceAll(values);
+        }
+    });
+
+    IVector<int32_t> const vector = multi_threaded_vector<int32_t>({ 2, 4 });
+    REQUIRE_THROWS_AS(vector.GetAt(vector.Size()), hresult_out_of_bounds);
+}
+
+TEST_CASE("concurrent_vector_strings")
+{
+    // Values that are not trivially copyable are always read under the lock.
+
+    stress([]
+    {
+        return multi_threaded_vector<hstring>();
+    },
+    [](IVector<hstring> const& vector)
+    {
+        bool valid = true;
+
+        for (hstring const& value : IIterable<hstring>(vector))
+        {
+            valid = valid && value.size() == 4;
+        }
+
+        try
+        {
+            valid = valid && vector.GetAt(0).size() == 4;
+        }
+        catch (hresult_out_of_bounds const&)
+        {
+        }
+
+        return valid;
+    },
+    [](IVector<hstring> const& vector, int32_t const index)
+    {
+        vector.Append(index % 2 ? L"even" : L"odd!");
+
+        if (index % 20 == 19)
+        {
+            vector.Clear();
+        }
+    });
+}
+
+TEST_CASE("concurrent_map")
+{
+    stress([]
+    {
+        return multi_threaded_map(flat_hash_map<int32_t, int32_t>());
+    },
+    [](IMap<int32_t, int32_t> const& map)
+    {
+        bool valid = true;
+
+        for (int32_t key = 0; key != 100; ++key)
+        {
+            try
+            {
+                valid = valid && map.Lookup(key) == key * 2;
+            }
+            catch (hresult_out_of_bounds const&)
+            {
+                // The writer removed the key.
+            }
+        }
+
+        for (auto&& pair : map)
+        {
+            valid = valid && pair.Value() == pair.Key() * 2;
+        }
+
+        return valid;
+    },
+    [](IMap<int32_t, int32_t> const& map, int32_t const index)
+    {
+        int32_t const key = index % 100;
+        map.Insert(key, key * 2);
+
+        if (index % 3 == 0)
+        {
+            map.Remove((index * 7) % 100);
+        }
+
+        if (index % 25 == 24)
+        {
+            map.Clear();
+        }
+    });
+}
@@ -0,0 +1,255 @@
+#include "catch.hpp"
+#include <winrt/base.h>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+using handler = winrt::delegate<int32_t>;
+
+namespace
+{
+    handler make_handler(int32_t& sum)
+    {
+        return [&sum](int32_t value)
+        {
+            sum += value;
+        };
+    }
+
+    // A handler that keeps the given object alive for as long as the event holds on to it.
+
+    handler make_handler(std::shared_ptr<int32_t> const& owner)
+    {
+        return [owner](int32_t)
+        {
+        };
+    }
+}
+
+TEST_CASE("event_add_remove")
+{
+    winrt::event<handler> event;
+    int32_t first{};
+    int32_t second{};
+
+    REQUIRE(!event);
+    auto const first_token = event.add(make_handler(first));
+    auto const second_token = event.add(make_handler(second));
+    REQUIRE(first_token);
+    REQUIRE(!(first_token == second_token));
+
+    event(1);
+    REQUIRE(first == 1);
+    REQUIRE(second == 1);
+
+    event.remove(first_token);
+    event(1);
+    REQUIRE(first == 1);
+    REQUIRE(second == 2);
+
+    // Removing a token twice, or the empty token, changes nothing.
+
+    event.remove(first_token);
+    event.remove({});
+    event(1);
+    REQUIRE(second == 3);
+
+    event.remove(second_token);
+    REQUIRE(!event);
+}
+
+TEST_CASE("event_stale_token")
+{
+    // A handle is reused once it is free, but the token it was first issued with no longer matches it.
+
+    winrt::event<handler> event;
+    int32_t first{};
+    int32_t second{};
+
+    auto const first_token = event.add(make_handler(first));
+    event.add(make_handler(first));
+    event.remove(first_token);
+    auto const second_token = event.add(make_handler(second));
+    REQUIRE(!(first_token == second_token));
+
+    event.remove(first_token);
+    event(1);
+    REQUIRE(second == 1);
+}
+
+TEST_CASE("event_compaction")
+{
+    // Removing most handlers reallocates the array, after which the remaining tokens still remove
+    // their own handler.
+
+    winrt::event<handler> event;
+    std::vector<int32_t> sums(1000);
+    std::vector<winrt::event_token> tokens;
+
+    for (auto&& sum : sums)
+    {
+        tokens.push_back(event.add(make_handler(sum)));
+    }
+
+    for (size_t index = 0; index != tokens.size(); ++index)
+    {
+        if (index % 100 != 0)
+        {
+            event.remove(tokens[index]);
+        }
+    }
+
+    event(1);
+
+    for (size_t index = 0; index != sums.size(); ++index)
+    {
+        REQUIRE(sums[index] == (index % 100 == 0 ? 1 : 0));
+    }
+
+    // Each handler is called once more for every handler removed before it.
+
+    for (size_t index = 0; index != tokens.size(); index += 100)
+    {
+        event.remove(tokens[index]);
+        event(1);
+        REQUIRE(sums[index] == static_cast<int32_t>(1 + index / 100));
+    }
+
+    REQUIRE(!event);
+}
+
+TEST_CASE("event_release")
+{
+    // A removed handler is released right away when no invocation is in progress, and otherwise once
+    // the invocation that may still be using it completes.
+
+    winrt::event<handler> event;
+    auto owner = std::make_shared<int32_t>();
+    std::weak_ptr<int32_t> const watch = owner;
+
+    auto token = event.add(make_handler(owner));
+    owner = nullptr;
+    REQUIRE(!watch.expired());
+    event.remove(token);
+    REQUIRE(watch.expired());
+
+    owner = std::make_shared<int32_t>();
+    std::weak_ptr<int32_t> const inner = owner;
+    token = event.add(make_handler(owner));
+    owner = nullptr;
+    bool released_during{};
+
+    event.add([&](int32_t)
+    {
+        event.remove(token);
+        released_during = inner.expired();
+    });
+
+    event(1);
+    REQUIRE(!released_during);
+    REQUIRE(inner.expired());
+}
+
+TEST_CASE("event_release_concurrent")
+{
+    // Invocations that keep overlapping on other threads do not hold up the release of a removed handler
+    // for longer than they run.
+
+    winrt::event<handler> event;
+    int32_t unused{};
+    event.add([&](int32_t)
+    {
+        std::this_thread::yield();
+    });
+
+    std::atomic<bool> done{};
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i != 4; ++i)
+    {
+        threads.emplace_back([&]
+        {
+            while (!done)
+            {
+                event(1);
+            }
+        });
+    }
+
+    auto owner = std::make_shared<int32_t>();
+    std::weak_ptr<int32_t> const watch = owner;
+    event.remove(event.add(make_handler(owner)));
+    owner = nullptr;
+
+    auto const deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+
+    while (!watch.expired() && std::chrono::steady_clock::now() < deadline)
+    {
+        event.remove(event.add(make_handler(unused)));
+    }
+
+    bool const released = watch.expired();
+    done = true;
+
+    for (auto&& thread : threads)
+    {
+        thread.join();
+    }
+
+    REQUIRE(released);
+}
+
+TEST_CASE("event_release_quiet")
+{
+    // The last invocation holding up a removed handler may complete while a change holds the event's lock,
+    // after that change has tried to release it. The handler is still released without another change.
+
+    uint32_t held{};
+
+    for (int round = 0; round != 2000; ++round)
+    {
+        winrt::event<handler> event;
+        int32_t unused{};
+        event.add(make_handler(unused));
+
+        auto owner = std::make_shared<int32_t>();
+        std::weak_ptr<int32_t> const watch = owner;
+        auto const token = event.add(make_handler(owner));
+        owner = nullptr;
+
+        std::atomic<bool> started{};
+        std::atomic<bool> done{};
+
+        std::thread reader([&]
+        {
+            event.add([&](int32_t)
+            {
+                started = true;
+            });
+
+            event(1);
+            done = true;
+        });
+
+        while (!started)
+        {
+            std::this_thread::yield();
+        }
+
+        event.remove(token);
+
+        while (!done)
+        {
+            event.remove(event.add(make_handler(unused)));
+        }
+
+        reader.join();
+
+        if (!watch.expired())
+        {
+            ++held;
+        }
+    }
+
+    REQUIRE(held == 0);
+}
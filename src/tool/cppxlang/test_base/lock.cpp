@@ -0,0 +1,146 @@
+#include "catch.hpp"
+#include <winrt/base.h>
+#include <thread>
+
+using namespace winrt;
+
+TEST_CASE("lock_exclusive")
+{
+    // Increments that are not atomic add up only if the lock keeps every writer out of the others' way.
+
+    slim_mutex lock;
+    uint64_t count{};
+    std::vector<std::thread> threads;
+
+    for (int thread = 0; thread != 4; ++thread)
+    {
+        threads.emplace_back([&]
+        {
+            for (int i = 0; i != 100'000; ++i)
+            {
+                slim_lock_guard const guard(lock);
+                ++count;
+            }
+        });
+    }
+
+    for (auto&& thread : threads)
+    {
+        thread.join();
+    }
+
+    REQUIRE(count == 400'000);
+}
+
+TEST_CASE("lock_shared")
+{
+    slim_mutex lock;
+
+    // Readers share the lock with each other but not with a writer.
+
+    REQUIRE(lock.try_lock_shared());
+    REQUIRE(lock.try_lock_shared());
+    REQUIRE(!lock.try_lock());
+    lock.unlock_shared();
+    REQUIRE(!lock.try_lock());
+    lock.unlock_shared();
+
+    REQUIRE(lock.try_lock());
+    REQUIRE(!lock.try_lock());
+    REQUIRE(!lock.try_lock_shared());
+    lock.unlock();
+
+    // A writer that waits for readers to leave sees a consistent pair of values, and so does every reader.
+
+    int32_t first{};
+    int32_t second{};
+    std::atomic<bool> done{};
+    std::atomic<uint32_t> torn{};
+    std::vector<std::thread> readers;
+
+    for (int thread = 0; thread != 3; ++thread)
+    {
+        readers.emplace_back([&]
+        {
+            while (!done)
+            {
+                slim_shared_lock_guard const guard(lock);
+
+                if (first != second)
+                {
+                    ++torn;
+                }
+            }
+        });
+    }
+
+    for (int32_t i = 0; i != 500; ++i)
+    {
+        slim_lock_guard const guard(lock);
+        ++first;
+        std::this_thread::yield();
+        ++second;
+    }
+
+    done = true;
+
+    for (auto&& thread : readers)
+    {
+        thread.join();
+    }
+
+    REQUIRE(torn == 0);
+    REQUIRE(second == 500);
+}
+
+TEST_CASE("lock_condition_variable")
+{
+    slim_mutex lock;
+    slim_condition_variable cv;
+    int32_t turn{};
+
+    // Two threads take turns, so every wait must be woken by the other thread's notify.
+
+    auto play = [&](int32_t const player)
+    {
+        for (int32_t i = 0; i != 1000; ++i)
+        {
+            slim_lock_guard const guard(lock);
+            cv.wait(lock, [&] { return turn % 2 == player; });
+            ++turn;
+            cv.notify_all();
+        }
+    };
+
+    std::thread other(play, 1);
+    play(0);
+    other.join();
+    REQUIRE(turn == 2000);
+
+    // A wait that is never notified times out and reports the predicate, while one that is notified does not
+    // wait out its timeout.
+
+    {
+        slim_lock_guard const guard(lock);
+        REQUIRE(!cv.wait_for(lock, std::chrono::milliseconds(20), [] { return false; }));
+    }
+
+    bool ready{};
+
+    std::thread notifier([&]
+    {
+        slim_lock_guard const guard(lock);
+        ready = true;
+        cv.notify_one();
+    });
+
+    auto const start = std::chrono::steady_clock::now();
+
+    {
+        slim_lock_guard const guard(lock);
+        REQUIRE(cv.wait_for(lock, std::chrono::seconds(30), [&] { return ready; }));
+    }
+
+    notifier.join();
+    REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds(30));
+}
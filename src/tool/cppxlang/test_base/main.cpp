@@ -1,6 +1,2 @@
-#include <winrt/base.h>
-
-int main()
-{
-
-}
\ No newline at end of file
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
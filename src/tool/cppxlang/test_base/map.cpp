@@ -0,0 +1,182 @@
+#include "catch.hpp"
+#include <winrt/Windows.Foundation.Collections.h>
+
+// Tests map_base and the map collections over the flat_map and flat_hash_map containers.
+
+using namespace winrt;
+using namespace Windows::Foundation::Collections;
+
+namespace
+{
+    template <typename Container>
+    struct custom_map : implements<custom_map<Container>, IMap<int32_t, hstring>, IMapView<int32_t, hstring>, IIterable<IKeyValuePair<int32_t, hstring>>>,
+        map_base<custom_map<Container>, int32_t, hstring>
+    {
+        auto& get_container() noexcept
+        {
+            return m_values;
+        }
+
+        auto& get_container() const noexcept
+        {
+            return m_values;
+        }
+
+    private:
+
+        Container m_values;
+    };
+
+    hstring name_of(int32_t const key)
+    {
+        return L"value " + hstring(std::to_wstring(key));
+    }
+
+    template <bool Ordered>
+    void check_map(IMap<int32_t, hstring> const& map)
+    {
+        REQUIRE(map.Size() == 0);
+        REQUIRE(!map.HasKey(1));
+        REQUIRE_THROWS_AS(map.Lookup(1), hresult_out_of_bounds);
+
+        // Inserting returns whether the key was already present, so that an existing value is replaced.
+
+        for (int32_t key = 99; key >= 0; --key)
+        {
+            REQUIRE(!map.Insert(key, name_of(key)));
+        }
+
+        REQUIRE(map.Insert(42, L"answer"));
+        REQUIRE(map.Size() == 100);
+        REQUIRE(map.Lookup(42) == L"answer");
+        REQUIRE(map.Lookup(7) == name_of(7));
+        REQUIRE(map.HasKey(99));
+        REQUIRE(!map.HasKey(100));
+
+        map.Remove(42);
+        map.Remove(1000);
+        REQUIRE(map.Size() == 99);
+        REQUIRE(!map.HasKey(42));
+
+        int32_t count{};
+        int32_t sum{};
+        int32_t previous{ -1 };
+
+        for (auto&& pair : map)
+        {
+            REQUIRE(pair.Value() == name_of(pair.Key()));
+            sum += pair.Key();
+            ++count;
+
+            if constexpr (Ordered)
+            {
+                REQUIRE(pair.Key() > previous);
+                previous = pair.Key();
+            }
+        }
+
+        REQUIRE(count == 99);
+        REQUIRE(sum == 99 * 100 / 2 - 42);
+
+        // A view reads the same container, and an iterator taken before a change no longer works.
+
+        IMapView<int32_t, hstring> const view = map.GetView();
+        REQUIRE(view.Size() == 99);
+        REQUIRE(view.Lookup(8) == name_of(8));
+
+        auto iterator = map.First();
+        map.Insert(42, L"again");
+        REQUIRE(view.Size() == 100);
+        REQUIRE_THROWS_AS(iterator.MoveNext(), hresult_changed_state);
+
+        map.Clear();
+        REQUIRE(map.Size() == 0);
+        REQUIRE(!map.First().HasCurrent());
+    }
+
+    // Stands in for a projected method with an IMapView parameter, which accepts a container as well.
+
+    IMapView<int32_t, hstring> pass_view(param::map_view<int32_t, hstring> const& values)
+    {
+        IMapView<int32_t, hstring> result;
+        copy_from_abi(result, get_abi(values));
+        return result;
+    }
+
+    // Large enough that a hash table grows several times, with erasure in between.
+
+    template <typename Container>
+    void check_container()
+    {
+        Container values;
+
+        for (int32_t key = 0; key != 10'000; ++key)
+        {
+            values.insert_or_assign(key, name_of(key));
+        }
+
+        for (int32_t key = 0; key != 10'000; key += 2)
+        {
+            REQUIRE(values.erase(key) == 1);
+        }
+
+        REQUIRE(values.size() == 5'000);
+
+        for (int32_t key = 0; key != 10'000; ++key)
+        {
+            auto found = values.find(key);
+            REQUIRE((found != values.end()) == (key % 2 != 0));
+        }
+
+        IMapView<int32_t, hstring> const view = pass_view(std::move(values));
+        REQUIRE(view.Size() == 5'000);
+        REQUIRE(view.Lookup(9'999) == name_of(9'999));
+        REQUIRE(!view.HasKey(9'998));
+    }
+}
+
+TEST_CASE("map_flat_map")
+{
+    check_map<true>(make<custom_map<flat_map<int32_t, hstring>>>());
+    check_map<true>(single_threaded_map(flat_map<int32_t, hstring>()));
+    check_container<flat_map<int32_t, hstring>>();
+}
+
+TEST_CASE("map_flat_hash_map")
+{
+    check_map<false>(make<custom_map<flat_hash_map<int32_t, hstring>>>());
+    check_map<false>(single_threaded_map(flat_hash_map<int32_t, hstring>()));
+    check_container<flat_hash_map<int32_t, hstring>>();
+}
+
+TEST_CASE("map_flat_observable")
+{
+    // The observable map reports changes the same way whichever container it uses. Replacing a value is
+    // reported as an insertion, as it is with std::map.
+
+    auto check = [](IObservableMap<int32_t, hstring> const& map)
+    {
+        std::vector<std::pair<CollectionChange, int32_t>> changes;
+
+        map.MapChanged([&](auto&&, IMapChangedEventArgs<int32_t> const& args)
+        {
+            changes.emplace_back(args.CollectionChange(), args.Key());
+        });
+
+        map.Insert(1, L"one");
+        map.Insert(1, L"uno");
+        map.Remove(1);
+        map.Insert(2, L"two");
+        map.Clear();
+
+        REQUIRE(changes.size() == 5);
+        REQUIRE(changes[0] == std::make_pair(CollectionChange::ItemInserted, 1));
+        REQUIRE(changes[1] == std::make_pair(CollectionChange::ItemInserted, 1));
+        REQUIRE(changes[2] == std::make_pair(CollectionChange::ItemRemoved, 1));
+        REQUIRE(changes[3] == std::make_pair(CollectionChange::ItemInserted, 2));
+        REQUIRE(changes[4].first == CollectionChange::Reset);
+    };
+
+    check(single_threaded_observable_map(flat_map<int32_t, hstring>()));
+    check(single_threaded_observable_map(flat_hash_map<int32_t, hstring>()));
+}
@@ -0,0 +1,54 @@
+import winrt.base;
+
+// Calls into the runtime through the winrt.base module alone, so that the names a consumer uses are known
+// to be exported and their definitions to be reachable.
+
+struct value : winrt::implements<value, winrt::Windows::Foundation::IInspectable>
+{
+    int32_t m_value{ 42 };
+};
+
+int main()
+{
+    winrt::hstring const text{ L"module" };
+    winrt::hstring const copy = text;
+
+    if (copy.size() != 6 || copy != L"module" || winrt::to_hstring("module") != text || winrt::to_string(text) != "module")
+    {
+        return 1;
+    }
+
+    auto object = winrt::make_self<value>();
+    winrt::Windows::Foundation::IInspectable inspectable = object.as<winrt::Windows::Foundation::IInspectable>();
+
+    if (winrt::get_self<value>(inspectable) != object.get())
+    {
+        return 2;
+    }
+
+    winrt::event<winrt::delegate<int32_t>> changed;
+    int32_t sum{};
+
+    auto const token = changed.add([&](int32_t const value)
+    {
+        sum += value;
+    });
+
+    changed(object->m_value);
+    changed.remove(token);
+    changed(1);
+
+    try
+    {
+        throw winrt::hresult_invalid_argument();
+    }
+    catch (winrt::hresult_error const& e)
+    {
+        if (e.code() != winrt::hresult_invalid_argument().code())
+        {
+            return 3;
+        }
+    }
+
+    return sum == 42 ? 0 : 4;
+}
@@ -0,0 +1,319 @@
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cwchar>
+#include <new>
+
+// Windows provides the functions base.h imports through windowsapp.lib and ole32.lib. Elsewhere, the tests
+// link this minimal implementation of the string, error and memory functions they call. Strings are
+// reference-counted heap blocks, and string references live in the header the caller provides, as they
+// do on Windows. There is no error info, no free-threaded marshaler and no agile reference.
+
+#define WINRT_CALL
+
+namespace
+{
+    constexpr int32_t error_ok{ 0 };
+    constexpr int32_t error_not_implemented{ static_cast<int32_t>(0x80004001) };
+    constexpr int32_t error_bad_alloc{ static_cast<int32_t>(0x8007000E) };
+    constexpr int32_t error_invalid_argument{ static_cast<int32_t>(0x80070057) };
+
+    struct string_header
+    {
+        uint32_t flags;
+        uint32_t length;
+        wchar_t const* buffer;
+    };
+
+    constexpr uint32_t reference_flag{ 1 };
+
+    struct shared_string : string_header
+    {
+        std::atomic<uint32_t> references;
+        wchar_t text[1];
+    };
+
+    shared_string* allocate_string(uint32_t const length) noexcept
+    {
+        void* memory = std::malloc(sizeof(shared_string) + sizeof(wchar_t) * length);
+
+        if (!memory)
+        {
+            return nullptr;
+        }
+
+        auto string = new (memory) shared_string{};
+        string->flags = 0;
+        string->length = length;
+        string->buffer = string->text;
+        string->references = 1;
+        string->text[length] = 0;
+        return string;
+    }
+}
+
+extern "C"
+{
+    int32_t WINRT_CALL WINRT_WindowsCreateString(wchar_t const* value, uint32_t length, void** string) noexcept
+    {
+        *string = nullptr;
+
+        if (length == 0)
+        {
+            return error_ok;
+        }
+
+        if (!value)
+        {
+            return error_invalid_argument;
+        }
+
+        auto result = allocate_string(length);
+
+        if (!result)
+        {
+            return error_bad_alloc;
+        }
+
+        std::memcpy(result->text, value, sizeof(wchar_t) * length);
+        *string = result;
+        return error_ok;
+    }
+
+    int32_t WINRT_CALL WINRT_WindowsCreateStringReference(wchar_t const* value, uint32_t length, void* header, void** string) noexcept
+    {
+        static_assert(sizeof(string_header) <= 24);
+        *string = nullptr;
+
+        if (length == 0)
+        {
+            return error_ok;
+        }
+
+        auto result = static_cast<string_header*>(header);
+        result->flags = reference_flag;
+        result->length = length;
+        result->buffer = value;
+        *string = result;
+        return error_ok;
+    }
+
+    int32_t WINRT_CALL WINRT_WindowsDuplicateString(void* string, void** copy) noexcept
+    {
+        auto header = static_cast<string_header*>(string);
+
+        if (!header)
+        {
+            *copy = nullptr;
+            return error_ok;
+        }
+
+        if (header->flags & reference_flag)
+        {
+            return WINRT_WindowsCreateString(header->buffer, header->length, copy);
+        }
+
+        ++static_cast<shared_string*>(header)->references;
+        *copy = string;
+        return error_ok;
+    }
+
+    int32_t WINRT_CALL WINRT_WindowsDeleteString(void* string) noexcept
+    {
+        auto header = static_cast<string_header*>(string);
+
+        if (header && !(header->flags & reference_flag) && --static_cast<shared_string*>(header)->references == 0)
+        {
+            std::free(header);
+        }
+
+        return error_ok;
+    }
+
+    wchar_t const* WINRT_CALL WINRT_WindowsGetStringRawBuffer(void* string, uint32_t* length) noexcept
+    {
+        auto header = static_cast<string_header*>(string);
+
+        if (length)
+        {
+            *length = header ? header->length : 0;
+        }
+
+        return header ? header->buffer : L"";
+    }
+
+    uint32_t WINRT_CALL WINRT_WindowsGetStringLen(void* string) noexcept
+    {
+        return string ? static_cast<string_header*>(string)->length : 0;
+    }
+
+    int32_t WINRT_CALL WINRT_WindowsStringHasEmbeddedNull(void* string, int* has_embedded_null) noexcept
+    {
+        auto header = static_cast<string_header*>(string);
+        *has_embedded_null = header && std::wcslen(header->buffer) != header->length;
+        return error_ok;
+    }
+
+    int32_t WINRT_CALL WINRT_WindowsPreallocateStringBuffer(uint32_t length, wchar_t** buffer, void** handle) noexcept
+    {
+        auto result = allocate_string(length);
+
+        if (!result)
+        {
+            return error_bad_alloc;
+        }
+
+        *buffer = result->text;
+        *handle = result;
+        return error_ok;
+    }
+
+    int32_t WINRT_CALL WINRT_WindowsDeleteStringBuffer(void* handle) noexcept
+    {
+        std::free(handle);
+        return error_ok;
+    }
+
+    int32_t WINRT_CALL WINRT_WindowsPromoteStringBuffer(void* handle, void** string) noexcept
+    {
+        auto result = static_cast<shared_string*>(handle);
+
+        if (result->length == 0)
+        {
+            std::free(result);
+            result = nullptr;
+        }
+
+        *string = result;
+        return error_ok;
+    }
+
+    uint32_t WINRT_CALL WINRT_GetLastError() noexcept
+    {
+        return static_cast<uint32_t>(errno);
+    }
+
+    int32_t WINRT_CALL WINRT_GetRestrictedErrorInfo(void** info) noexcept
+    {
+        *info = nullptr;
+        return 1; // S_FALSE
+    }
+
+    int32_t WINRT_CALL WINRT_SetRestrictedErrorInfo(void*) noexcept
+    {
+        return error_ok;
+    }
+
+    int32_t WINRT_CALL WINRT_RoOriginateLanguageException(int32_t, void*, void*) noexcept
+    {
+        return 0; // FALSE
+    }
+
+    int32_t WINRT_CALL WINRT_CoCreateFreeThreadedMarshaler(void*, void** marshaler) noexcept
+    {
+        *marshaler = nullptr;
+        return error_not_implemented;
+    }
+
+    // Delegates that are not agile are called directly, since there are no apartments to marshal between.
+
+    int32_t WINRT_CALL WINRT_RoGetAgileReference(uint32_t, void const*, void*, void** reference) noexcept
+    {
+        *reference = nullptr;
+        return error_not_implemented;
+    }
+
+    void* WINRT_CALL WINRT_CoTaskMemAlloc(std::size_t size) noexcept
+    {
+        return std::malloc(size);
+    }
+
+    void WINRT_CALL WINRT_CoTaskMemFree(void* ptr) noexcept
+    {
+        std::free(ptr);
+    }
+
+    void WINRT_CALL WINRT_SysFreeString(wchar_t* string) noexcept
+    {
+        std::free(string);
+    }
+
+    uint32_t WINRT_CALL WINRT_SysStringLen(wchar_t* string) noexcept
+    {
+        return string ? static_cast<uint32_t>(std::wcslen(string)) : 0;
+    }
+
+    // Converts between UTF-8 and the UTF-32 of a four-byte wchar_t, ignoring the code page and flags. As on
+    // Windows, the result is the number of characters written, or needed when there is no output buffer.
+
+    int32_t WINRT_CALL WINRT_MultiByteToWideChar(uint32_t, uint32_t, char const* in, int32_t in_size, wchar_t* out, int32_t out_size) noexcept
+    {
+        int32_t size{};
+
+        for (int32_t pos = 0; pos < in_size;)
+        {
+            auto const lead = static_cast<uint8_t>(in[pos]);
+            int32_t const count = lead < 0x80 ? 1 : lead < 0xE0 ? 2 : lead < 0xF0 ? 3 : 4;
+            char32_t value = count == 1 ? lead : lead & (0x7F >> count);
+
+            for (int32_t next = 1; next != count && pos + next < in_size; ++next)
+            {
+                value = (value << 6) | (static_cast<uint8_t>(in[pos + next]) & 0x3F);
+            }
+
+            if (out && size == out_size)
+            {
+                return 0;
+            }
+
+            if (out)
+            {
+                out[size] = static_cast<wchar_t>(value);
+            }
+
+            ++size;
+            pos += count;
+        }
+
+        return size;
+    }
+
+    int32_t WINRT_CALL WINRT_WideCharToMultiByte(uint32_t, uint32_t, wchar_t const* in, int32_t in_size, char* out, int32_t out_size, char const*, int32_t*) noexcept
+    {
+        int32_t size{};
+
+        for (int32_t pos = 0; pos != in_size; ++pos)
+        {
+            auto const value = static_cast<char32_t>(in[pos]);
+            int32_t const count = value < 0x80 ? 1 : value < 0x800 ? 2 : value < 0x10000 ? 3 : 4;
+
+            if (out && size + count > out_size)
+            {
+                return 0;
+            }
+
+            if (out)
+            {
+                if (count == 1)
+                {
+                    out[size] = static_cast<char>(value);
+                }
+                else
+                {
+                    out[size] = static_cast<char>((0xF00 >> count) | (value >> (6 * (count - 1))));
+
+                    for (int32_t next = 1; next != count; ++next)
+                    {
+                        out[size + next] = static_cast<char>(0x80 | ((value >> (6 * (count - 1 - next))) & 0x3F));
+                    }
+                }
+            }
+
+            size += count;
+        }
+
+        return size;
+    }
+}
@@ -0,0 +1,173 @@
+#include "catch.hpp"
+#include <winrt/base.h>
+#include <set>
+#include <thread>
+
+using namespace winrt;
+
+namespace
+{
+    template <typename Allocator>
+    struct value : implements<value<Allocator>, Windows::Foundation::IInspectable, allocate_with<Allocator>>
+    {
+        explicit value(int32_t const number) noexcept : number(number)
+        {
+        }
+
+        int32_t const number;
+    };
+
+    template <typename Allocator>
+    auto make_value(int32_t const number)
+    {
+        return make_self<value<Allocator>>(number);
+    }
+}
+
+TEST_CASE("pool_allocator")
+{
+    // Blocks go back to the pool on the thread that frees them, including one that did not allocate them.
+
+    std::vector<com_ptr<value<pool_allocator>>> values;
+
+    for (int32_t number = 0; number != 1000; ++number)
+    {
+        values.push_back(make_value<pool_allocator>(number));
+    }
+
+    for (int32_t number = 0; number != 1000; ++number)
+    {
+        REQUIRE(values[number]->number == number);
+    }
+
+    // A thread that only frees blocks returns the ones it still caches to the central lists when it exits.
+
+    std::set<void*> freed;
+
+    for (auto&& value : values)
+    {
+        freed.insert(value.get());
+    }
+
+    std::thread([&] { values.clear(); }).join();
+
+    {
+        size_t const size_class = (sizeof(value<pool_allocator>) - 1) / impl::pool_granularity;
+        impl::pool_central& central = impl::get_pool_central();
+        slim_lock_guard const guard(central.lock);
+
+        for (impl::pool_block* block = central.lists[size_class].head; block; block = block->next)
+        {
+            freed.erase(block);
+        }
+    }
+
+    REQUIRE(freed.empty());
+
+    for (int32_t number = 0; number != 1000; ++number)
+    {
+        values.push_back(make_value<pool_allocator>(number));
+    }
+
+    REQUIRE(values.back()->number == 999);
+}
+
+TEST_CASE("pool_arena_live")
+{
+    pool_arena arena;
+    REQUIRE(arena.live() == 0);
+
+    {
+        auto first = make_value<arena_allocator>(1);
+        auto second = make_value<arena_allocator>(2);
+        REQUIRE(arena.live() == 2);
+    }
+
+    REQUIRE(arena.live() == 0);
+
+    // An object released on another thread is counted as well.
+
+    auto third = make_value<arena_allocator>(3);
+    REQUIRE(arena.live() == 1);
+    std::thread([&] { third = nullptr; }).join();
+    REQUIRE(arena.live() == 0);
+}
+
+TEST_CASE("pool_arena_opt_in")
+{
+    // Only arena_allocator allocates from an arena. Delegates, events, and other pool objects do not, so
+    // they may outlive it freely.
+
+    delegate<int32_t> handler;
+    event<delegate<int32_t>> changed;
+    com_ptr<value<pool_allocator>> pooled;
+    int32_t sum{};
+
+    {
+        pool_arena arena;
+        handler = [&](int32_t value) { sum += value; };
+        changed.add(handler);
+        pooled = make_value<pool_allocator>(1);
+        REQUIRE(arena.live() == 0);
+    }
+
+    changed(2);
+    handler(3);
+    REQUIRE(sum == 5);
+    REQUIRE(pooled->number == 1);
+}
+
+TEST_CASE("pool_arena_outlived")
+{
+    // An object that outlives its arena keeps the arena's memory until it is released, on the arena's
+    // thread or on another one.
+
+    com_ptr<value<arena_allocator>> kept;
+    com_ptr<value<arena_allocator>> moved;
+
+    {
+        pool_arena arena;
+        kept = make_value<arena_allocator>(1);
+        moved = make_value<arena_allocator>(2);
+
+        for (int32_t number = 0; number != 10'000; ++number)
+        {
+            make_value<arena_allocator>(number);
+        }
+
+        REQUIRE(arena.live() == 2);
+    }
+
+    // Arenas that follow reuse the thread's spare memory, which must not include the outlived arena's.
+
+    for (int i = 0; i != 4; ++i)
+    {
+        pool_arena arena;
+
+        for (int32_t number = 0; number != 10'000; ++number)
+        {
+            REQUIRE(make_value<arena_allocator>(number)->number == number);
+        }
+    }
+
+    REQUIRE(kept->number == 1);
+    REQUIRE(moved->number == 2);
+    kept = nullptr;
+    std::thread([&] { moved = nullptr; }).join();
+}
+
+TEST_CASE("pool_arena_nested")
+{
+    pool_arena outer;
+    auto first = make_value<arena_allocator>(1);
+
+    {
+        pool_arena inner;
+        auto second = make_value<arena_allocator>(2);
+        REQUIRE(inner.live() == 1);
+        REQUIRE(outer.live() == 1);
+    }
+
+    auto third = make_value<arena_allocator>(3);
+    REQUIRE(outer.live() == 2);
+}
@@ -0,0 +1,142 @@
+#include "catch.hpp"
+#include <winrt/Windows.Foundation.Collections.h>
+
+// Tests that QueryInterface finds each implemented interface through the IID table, and only those.
+
+using namespace winrt;
+using namespace Windows::Foundation::Collections;
+
+namespace
+{
+    struct several : implements<several, IIterable<int32_t>, IVectorView<int32_t>, IVectorChangedEventArgs, IMapChangedEventArgs<hstring>, IKeyValuePair<hstring, int32_t>>
+    {
+        IIterator<int32_t> First() const noexcept
+        {
+            return nullptr;
+        }
+
+        int32_t GetAt(uint32_t const index) const noexcept
+        {
+            return static_cast<int32_t>(index);
+        }
+
+        uint32_t Size() const noexcept
+        {
+            return 0;
+        }
+
+        bool IndexOf(int32_t, uint32_t& index) const noexcept
+        {
+            index = 0;
+            return false;
+        }
+
+        uint32_t GetMany(uint32_t, array_view<int32_t>) const noexcept
+        {
+            return 0;
+        }
+
+        Windows::Foundation::Collections::CollectionChange CollectionChange() const noexcept
+        {
+            return Windows::Foundation::Collections::CollectionChange::Reset;
+        }
+
+        uint32_t Index() const noexcept
+        {
+            return 0;
+        }
+
+        hstring Key() const
+        {
+            return L"key";
+        }
+
+        int32_t Value() const noexcept
+        {
+            return 0;
+        }
+    };
+
+    template <typename I>
+    void require_interface(com_ptr<several> const& object)
+    {
+        I const result = object.try_as<I>();
+        REQUIRE(result);
+        REQUIRE(get_abi(result) == to_abi<I>(object.get()));
+        REQUIRE(result.template as<Windows::Foundation::IUnknown>() == object.as<Windows::Foundation::IUnknown>());
+    }
+
+    template <typename I>
+    void require_no_interface(com_ptr<several> const& object)
+    {
+        void* result = reinterpret_cast<void*>(1);
+        REQUIRE(object->QueryInterface(guid_of<I>(), &result) == impl::error_no_interface);
+        REQUIRE(result == nullptr);
+        REQUIRE(!object.try_as<I>());
+    }
+}
+
+TEST_CASE("qi_table")
+{
+    // A set of interfaces with distinct Data1 values gets a perfect hash, while one with a repeated Data1
+    // falls back to comparing each IID in turn. Both find the same interfaces.
+
+    using table = impl::interface_table<several, impl::implemented_interfaces<several>>;
+    using repeated = impl::interface_table<several, impl::interface_list<IVectorView<int32_t>, IVectorView<int32_t>, IIterable<int32_t>>>;
+    static_assert(table::count == 5 && table::multiplier != 0);
+    static_assert(repeated::multiplier == 0);
+
+    auto object = make_self<several>();
+
+    REQUIRE(table::find(object.get(), guid_of<IVectorView<int32_t>>()) == to_abi<IVectorView<int32_t>>(object.get()));
+    REQUIRE(repeated::find(object.get(), guid_of<IVectorView<int32_t>>()) == to_abi<IVectorView<int32_t>>(object.get()));
+    REQUIRE(repeated::find(object.get(), guid_of<IIterable<int32_t>>()) == to_abi<IIterable<int32_t>>(object.get()));
+    REQUIRE(table::find(object.get(), guid_of<IVector<int32_t>>()) == nullptr);
+    REQUIRE(repeated::find(object.get(), guid_of<IVectorChangedEventArgs>()) == nullptr);
+}
+
+TEST_CASE("qi_implemented")
+{
+    // Every implemented interface resolves to that interface's own vtable on the same object.
+
+    auto object = make_self<several>();
+
+    require_interface<IIterable<int32_t>>(object);
+    require_interface<IVectorView<int32_t>>(object);
+    require_interface<IVectorChangedEventArgs>(object);
+    require_interface<IMapChangedEventArgs<hstring>>(object);
+    require_interface<IKeyValuePair<hstring, int32_t>>(object);
+
+    REQUIRE(object.as<IKeyValuePair<hstring, int32_t>>().Key() == L"key");
+    REQUIRE(object.as<IVectorView<int32_t>>().GetAt(3) == 3);
+}
+
+TEST_CASE("qi_not_implemented")
+{
+    // Interfaces the object does not implement are refused, including those that differ from an implemented
+    // one only in a type argument and so share its generic interface.
+
+    auto object = make_self<several>();
+
+    require_no_interface<IVector<int32_t>>(object);
+    require_no_interface<IIterable<hstring>>(object);
+    require_no_interface<IVectorView<hstring>>(object);
+    require_no_interface<IMapChangedEventArgs<int32_t>>(object);
+    require_no_interface<IKeyValuePair<hstring, hstring>>(object);
+    require_no_interface<IObservableVector<int32_t>>(object);
+}
+
+TEST_CASE("qi_implicit")
+{
+    // The interfaces every object answers without listing them are resolved after the table misses.
+
+    auto object = make_self<several>();
+
+    REQUIRE(object.try_as<Windows::Foundation::IUnknown>());
+    REQUIRE(object.try_as<Windows::Foundation::IInspectable>());
+    REQUIRE(object.try_as<impl::IAgileObject>());
+    REQUIRE(object.try_as<impl::IWeakReferenceSource>());
+
+    auto const weak = make_weak(object.as<IVectorView<int32_t>>());
+    REQUIRE(weak.get());
+}
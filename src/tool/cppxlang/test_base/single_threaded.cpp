@@ -0,0 +1,136 @@
+#include "catch.hpp"
+#include <winrt/Windows.Foundation.Collections.h>
+#include <map>
+
+// Tests objects that list the single_threaded marker, and the iterators and pairs their collections hand out.
+
+using namespace winrt;
+using namespace Windows::Foundation::Collections;
+
+namespace
+{
+    template <typename Threading>
+    struct numbers : implements<numbers<Threading>, Threading, IVectorView<int32_t>, IIterable<int32_t>>, vector_view_base<numbers<Threading>, int32_t>
+    {
+        numbers(std::vector<int32_t> values, bool& destroyed) noexcept : m_values(std::move(values)), m_destroyed(destroyed)
+        {
+        }
+
+        ~numbers() noexcept
+        {
+            m_destroyed = true;
+        }
+
+        auto& get_container() const noexcept
+        {
+            return m_values;
+        }
+
+    private:
+
+        std::vector<int32_t> m_values;
+        bool& m_destroyed;
+    };
+
+    template <typename Threading>
+    struct names : implements<names<Threading>, Threading, IMapView<hstring, int32_t>, IIterable<IKeyValuePair<hstring, int32_t>>>, map_view_base<names<Threading>, hstring, int32_t>
+    {
+        auto& get_container() const noexcept
+        {
+            return m_values;
+        }
+
+    private:
+
+        std::map<hstring, int32_t> m_values{ { L"one", 1 }, { L"two", 2 } };
+    };
+
+    template <typename T>
+    bool is_agile(T const& object)
+    {
+        return object.template try_as<impl::IAgileObject>() != nullptr;
+    }
+}
+
+TEST_CASE("single_threaded_references")
+{
+    // The plain reference count still reports each AddRef and Release, and the last Release destroys the
+    // object.
+
+    bool destroyed{};
+    IVectorView<int32_t> object = make<numbers<single_threaded>>(std::vector<int32_t>{ 1, 2, 3 }, destroyed);
+    auto abi = static_cast<impl::unknown_abi*>(get_abi(object));
+
+    REQUIRE(abi->AddRef() == 2);
+    REQUIRE(abi->AddRef() == 3);
+    REQUIRE(abi->Release() == 2);
+    REQUIRE(abi->Release() == 1);
+
+    {
+        auto const copy = object;
+        auto const iterable = object.as<IIterable<int32_t>>();
+        REQUIRE(abi->AddRef() == 4);
+        REQUIRE(abi->Release() == 3);
+    }
+
+    REQUIRE(!destroyed);
+    object = nullptr;
+    REQUIRE(destroyed);
+}
+
+TEST_CASE("single_threaded_not_agile")
+{
+    // A single_threaded object answers neither IAgileObject, IMarshal nor IWeakReferenceSource, while the
+    // same object without the marker is agile.
+
+    bool destroyed{};
+    IVectorView<int32_t> single = make<numbers<single_threaded>>(std::vector<int32_t>{ 1 }, destroyed);
+    IVectorView<int32_t> atomic = make<numbers<void>>(std::vector<int32_t>{ 1 }, destroyed);
+
+    REQUIRE(!is_agile(single));
+    REQUIRE(!single.try_as<impl::IMarshal>());
+    REQUIRE(!single.try_as<impl::IWeakReferenceSource>());
+    REQUIRE(single.try_as<Windows::Foundation::IInspectable>());
+
+    REQUIRE(is_agile(atomic));
+    REQUIRE(atomic.try_as<impl::IWeakReferenceSource>());
+}
+
+TEST_CASE("single_threaded_collections")
+{
+    // The iterators and key/value pairs a collection hands out take its marker, and work as they do for an
+    // agile collection.
+
+    bool destroyed{};
+    IVectorView<int32_t> single = make<numbers<single_threaded>>(std::vector<int32_t>{ 1, 2, 3 }, destroyed);
+    IVectorView<int32_t> atomic = make<numbers<void>>(std::vector<int32_t>{ 1, 2, 3 }, destroyed);
+
+    REQUIRE(!is_agile(single.First()));
+    REQUIRE(is_agile(atomic.First()));
+
+    std::vector<int32_t> values;
+
+    for (auto&& value : single.as<IIterable<int32_t>>())
+    {
+        values.push_back(value);
+    }
+
+    REQUIRE(values == std::vector<int32_t>{ 1, 2, 3 });
+
+    std::vector<int32_t> many(3);
+    auto iterator = single.First();
+    REQUIRE(iterator.GetMany(many) == 3);
+    REQUIRE(!iterator.HasCurrent());
+    REQUIRE(many == values);
+
+    IMapView<hstring, int32_t> map = make<names<single_threaded>>();
+    auto pair = map.First().Current();
+    REQUIRE(!is_agile(map.First()));
+    REQUIRE(!is_agile(pair));
+    REQUIRE(pair.Key() == L"one");
+    REQUIRE(pair.Value() == 1);
+    REQUIRE(map.Lookup(L"two") == 2);
+
+    IMapView<hstring, int32_t> agile_map = make<names<void>>();
+    REQUIRE(is_agile(agile_map.First().Current()));
+}
@@ -0,0 +1,195 @@
+#include "catch.hpp"
+#include <winrt/coroutine.h>
+#include <condition_variable>
+#include <future>
+#include <unistd.h>
+
+// Tests the thread pool, timer wheel, and wait loop that back the awaitables on Linux.
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    winrt::fire_and_forget resume_background(std::promise<std::thread::id>& result)
+    {
+        co_await winrt::resume_background();
+        result.set_value(std::this_thread::get_id());
+    }
+
+    winrt::fire_and_forget resume_after(winrt::Windows::Foundation::TimeSpan const duration, std::promise<void>& result)
+    {
+        co_await winrt::resume_after(duration);
+        result.set_value();
+    }
+
+    winrt::fire_and_forget resume_on_signal(int const descriptor, winrt::Windows::Foundation::TimeSpan const timeout, std::promise<bool>& result)
+    {
+        result.set_value(co_await winrt::resume_on_signal(reinterpret_cast<void*>(static_cast<intptr_t>(descriptor)), timeout));
+    }
+
+    struct pipe_pair
+    {
+        pipe_pair()
+        {
+            REQUIRE(pipe(descriptors) == 0);
+        }
+
+        ~pipe_pair()
+        {
+            close(descriptors[0]);
+            close(descriptors[1]);
+        }
+
+        void signal() const
+        {
+            char const value{};
+            REQUIRE(write(descriptors[1], &value, 1) == 1);
+        }
+
+        int descriptors[2]{};
+    };
+}
+
+TEST_CASE("threadpool_resume_background")
+{
+    std::promise<std::thread::id> result;
+    resume_background(result);
+    REQUIRE(result.get_future().get() != std::this_thread::get_id());
+}
+
+TEST_CASE("threadpool_submit")
+{
+    // Work submitted from several threads at once, and from the pool's own workers, all runs.
+
+    constexpr uint32_t count{ 100'000 };
+    std::atomic<uint32_t> remaining{ count * 2 };
+    std::promise<void> done;
+
+    struct context_type
+    {
+        std::atomic<uint32_t>& remaining;
+        std::promise<void>& done;
+    }
+    context{ remaining, done };
+
+    static constexpr auto callback = [](void*, void* context) noexcept
+    {
+        auto& that = *static_cast<context_type*>(context);
+
+        if (that.remaining.fetch_sub(1) == 1)
+        {
+            that.done.set_value();
+        }
+    };
+
+    static constexpr auto resubmit = [](void*, void* context) noexcept
+    {
+        winrt::impl::submit_threadpool_callback(callback, context);
+        callback(nullptr, context);
+    };
+
+    std::vector<std::thread> threads;
+
+    for (int thread = 0; thread != 4; ++thread)
+    {
+        threads.emplace_back([&]
+        {
+            for (uint32_t index = 0; index != count / 4; ++index)
+            {
+                winrt::impl::submit_threadpool_callback(resubmit, &context);
+            }
+        });
+    }
+
+    for (auto&& thread : threads)
+    {
+        thread.join();
+    }
+
+    REQUIRE(done.get_future().wait_for(30s) == std::future_status::ready);
+}
+
+TEST_CASE("threadpool_injection")
+{
+    // Work that blocks until more work than there are workers has started only completes if the pool
+    // starts more workers.
+
+    uint32_t const count = std::thread::hardware_concurrency() + 4;
+    uint32_t started{};
+    uint32_t finished{};
+    std::mutex lock;
+    std::condition_variable changed;
+
+    struct context_type
+    {
+        uint32_t const count;
+        uint32_t& started;
+        uint32_t& finished;
+        std::mutex& lock;
+        std::condition_variable& changed;
+    }
+    context{ count, started, finished, lock, changed };
+
+    for (uint32_t index = 0; index != count; ++index)
+    {
+        winrt::impl::submit_threadpool_callback([](void*, void* context) noexcept
+        {
+            auto& that = *static_cast<context_type*>(context);
+            std::unique_lock<std::mutex> guard(that.lock);
+            ++that.started;
+            that.changed.notify_all();
+            that.changed.wait_for(guard, 30s, [&] { return that.started == that.count; });
+            ++that.finished;
+            that.changed.notify_all();
+        }, &context);
+    }
+
+    std::unique_lock<std::mutex> guard(lock);
+    bool const all_started = changed.wait_for(guard, 30s, [&] { return started == count; });
+    changed.wait(guard, [&] { return finished == count; });
+    REQUIRE(all_started);
+}
+
+TEST_CASE("threadpool_resume_after")
+{
+    std::promise<void> result;
+    auto const start = std::chrono::steady_clock::now();
+    resume_after(50ms, result);
+    result.get_future().get();
+    REQUIRE(std::chrono::steady_clock::now() - start >= 50ms);
+}
+
+TEST_CASE("threadpool_resume_on_signal")
+{
+    pipe_pair pipe;
+    std::promise<bool> signaled;
+    resume_on_signal(pipe.descriptors[0], 10s, signaled);
+    std::this_thread::sleep_for(10ms);
+    pipe.signal();
+    REQUIRE(signaled.get_future().get());
+
+    pipe_pair idle;
+    std::promise<bool> timed_out;
+    resume_on_signal(idle.descriptors[0], 50ms, timed_out);
+    REQUIRE(!timed_out.get_future().get());
+}
+
+TEST_CASE("threadpool_resume_on_signal_descriptor_zero")
+{
+    // Descriptor 0 is a handle like any other rather than a null handle.
+
+    pipe_pair pipe;
+    int const input = dup(0);
+    REQUIRE(dup2(pipe.descriptors[0], 0) == 0);
+
+    std::promise<bool> signaled;
+    resume_on_signal(0, 10s, signaled);
+    std::this_thread::sleep_for(10ms);
+    pipe.signal();
+    auto future = signaled.get_future();
+    bool const result = future.wait_for(20s) == std::future_status::ready && future.get();
+
+    dup2(input, 0);
+    close(input);
+    REQUIRE(result);
+}
@@ -0,0 +1,24 @@
+#include "pch.h"
+#include "../../abi/sha1.h"
+#include "../include_report.h"
+#include "../settings.h"
+#include "../type_writers.h"
+#include "../helpers.h"
+
+using namespace xlang;
+
+namespace xlang
+{
+    settings_type settings;
+}
+
+TEST_CASE("guids_pinterface")
+{
+    // The IIDs of IVector<String> and IIterable<String>, as generate_guid in base_identity.h derives them.
+
+    auto const vector = get_pinterface_guid("pinterface({913337e9-11a1-4345-a3a2-4e7f956e222d};string)");
+    REQUIRE(vector == std::array<uint8_t, 16>{ 0x98, 0xb9, 0xac, 0xc1, 0x4b, 0x56, 0x53, 0x2e, 0xac, 0x73, 0x03, 0xd5, 0x29, 0x1c, 0xca, 0x90 });
+
+    auto const iterable = get_pinterface_guid("pinterface({faa585ea-6214-4217-afda-7f46de5869b3};string)");
+    REQUIRE(iterable == std::array<uint8_t, 16>{ 0xe2, 0xfc, 0xc7, 0xc1, 0x3b, 0xfc, 0x5a, 0x0b, 0xb2, 0xb0, 0x72, 0xe7, 0x69, 0xd1, 0xcb, 0x7e });
+}
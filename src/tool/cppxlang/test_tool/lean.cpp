@@ -0,0 +1,56 @@
+#include "pch.h"
+#include "../include_report.h"
+#include "../settings.h"
+#include "../type_writers.h"
+#include "../lean.h"
+
+using namespace xlang;
+
+TEST_CASE("lean_name")
+{
+    REQUIRE(get_lean_name("winrt::Windows::Foundation::Uri") == "Windows.Foundation.Uri");
+    REQUIRE(get_lean_name("Windows::Foundation::Uri") == "Windows.Foundation.Uri");
+    REQUIRE(get_lean_name("Windows.Foundation.Uri") == "Windows.Foundation.Uri");
+}
+
+TEST_CASE("lean_scan")
+{
+    auto names = scan_lean_names(R"(
+        #include <winrt/Windows.Foundation.Collections.h>
+        using namespace winrt;
+        winrt::Windows::Foundation::Uri uri{ L"http://host" };
+        winrt::Windows::Foundation::Collections::IVector<int> vector;
+        winrt::Windows::Foundation::Collections::IMap<winrt::hstring, std::pair<int, int>> map;
+        auto async = winrt::Windows::Foundation::IAsyncOperationWithProgress < bool, uint32_t > {};
+        auto value = winrt::Windows::Foundation::Collections::IVector<std::function<void(int, int)>>::GetAt;
+        mywinrt::Windows::Foundation::Uri other;
+    )");
+
+    std::vector<std::string> expected
+    {
+        "Windows.Foundation.Uri",
+        "Windows.Foundation.Collections.IVector`1",
+        "Windows.Foundation.Collections.IMap`2",
+        "hstring",
+        "Windows.Foundation.IAsyncOperationWithProgress`2",
+        "Windows.Foundation.Collections.IVector`1",
+    };
+
+    REQUIRE(names == expected);
+}
+
+TEST_CASE("lean_scan_member")
+{
+    // A name that continues into a member still counts the type's arguments, which add_lean_seed keeps
+    // while it drops the member.
+
+    auto names = scan_lean_names("winrt::Windows::Foundation::Collections::IVector<int>::GetAt; winrt::Windows::Foundation::Uri::Host;");
+
+    std::vector<std::string> expected
+    {
+        "Windows.Foundation.Collections.IVector`1",
+        "Windows.Foundation.Uri.Host",
+    };
+
+    REQUIRE(names == expected);
+}
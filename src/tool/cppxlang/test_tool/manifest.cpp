@@ -0,0 +1,65 @@
+#include "pch.h"
+#include "../../abi/sha1.h"
+#include "../include_report.h"
+#include "../settings.h"
+#include "../type_writers.h"
+#include "../helpers.h"
+#include "../manifest.h"
+#include <fstream>
+
+using namespace xlang;
+using namespace std::experimental::filesystem;
+
+namespace
+{
+    void write_headers(path const& folder, std::string const& ns)
+    {
+        create_directories(folder / "winrt" / "impl");
+
+        for (auto&& name : { "winrt/" + ns + ".h", "winrt/impl/" + ns + ".0.h", "winrt/impl/" + ns + ".1.h", "winrt/impl/" + ns + ".2.h" })
+        {
+            std::ofstream{ folder / name } << "header";
+        }
+    }
+}
+
+TEST_CASE("manifest_generation")
+{
+    auto const folder = temp_directory_path() / "xlang_test_manifest";
+    remove_all(folder);
+    create_directories(folder);
+    auto const filename = (folder / "cppxlang.namespaces").string();
+    settings.output_folder = folder.string() + "/";
+
+    {
+        generation_manifest manifest{ filename };
+        REQUIRE(!manifest.is_current("A.B", 1));
+
+        // A namespace is only current once its fingerprint matches and all four of its headers exist.
+
+        manifest.update("A.B", 1);
+        manifest.update("A.C", 2);
+        REQUIRE(!manifest.is_current("A.B", 1));
+
+        write_headers(folder, "A.B");
+        REQUIRE(manifest.is_current("A.B", 1));
+        REQUIRE(!manifest.is_current("A.B", 2));
+        REQUIRE(!manifest.is_current("A.C", 2));
+        manifest.save();
+    }
+
+    {
+        // Lines that don't hold a fingerprint and a namespace are ignored.
+
+        std::ofstream{ filename, std::ios::app } << "not a line\n0000000000000003 \n";
+        generation_manifest manifest{ filename };
+        REQUIRE(manifest.is_current("A.B", 1));
+        REQUIRE(!manifest.is_current("A.B", 3));
+
+        remove(folder / "winrt" / "impl" / "A.B.2.h");
+        REQUIRE(!manifest.is_current("A.B", 1));
+    }
+
+    settings.output_folder.clear();
+    remove_all(folder);
+}
@@ -0,0 +1,65 @@
+#include "pch.h"
+#include "../../abi/sha1.h"
+#include "../include_report.h"
+#include "../settings.h"
+#include "../type_writers.h"
+#include "../helpers.h"
+#include <thread>
+
+using namespace xlang;
+
+TEST_CASE("memoized")
+{
+    // Each value is computed once per key, and every caller gets a reference to the same stored value,
+    // which stays valid as other keys are added.
+
+    memoized<int32_t, std::string> cache;
+    std::atomic<uint32_t> computed{};
+
+    auto get = [&](int32_t const key) -> std::string const&
+    {
+        return cache.get(key, [&]
+        {
+            ++computed;
+            return std::to_string(key);
+        });
+    };
+
+    std::string const& first = get(1);
+    REQUIRE(first == "1");
+    REQUIRE(&get(1) == &first);
+    REQUIRE(computed == 1);
+
+    for (int32_t key = 0; key != 1000; ++key)
+    {
+        REQUIRE(get(key) == std::to_string(key));
+    }
+
+    REQUIRE(computed == 1000);
+    REQUIRE(&get(1) == &first);
+
+    // Threads that race on a new key may each compute it, but all of them see the value stored first.
+
+    std::vector<std::string const*> results(8);
+    std::vector<std::thread> threads;
+
+    for (auto&& result : results)
+    {
+        threads.emplace_back([&]
+        {
+            result = &get(1000);
+        });
+    }
+
+    for (auto&& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (auto&& result : results)
+    {
+        REQUIRE(result == results.front());
+    }
+
+    REQUIRE(*results.front() == "1000");
+}
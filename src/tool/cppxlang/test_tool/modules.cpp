@@ -0,0 +1,179 @@
+#include "pch.h"
+#include <fstream>
+
+using namespace std::experimental::filesystem;
+
+namespace
+{
+    // Returns the declarations in the WINRT_EXPORT namespaces of the source that have internal linkage,
+    // which a module may not export: namespace-scope static functions and variables, const and constexpr
+    // variables that are not inline, and unnamed namespaces.
+
+    std::vector<std::string> find_internal_linkage(std::string const& source)
+    {
+        std::vector<std::string> result;
+        std::vector<bool> scopes;
+        bool exported{};
+        bool namespace_next{};
+        bool template_next{};
+        size_t line_start{};
+
+        auto at_namespace_scope = [&]
+        {
+            return exported && !scopes.empty() && scopes.back();
+        };
+
+        auto check = [&](std::string_view line)
+        {
+            auto const first = line.find_first_not_of(' ');
+
+            if (first == std::string_view::npos)
+            {
+                return;
+            }
+
+            line.remove_prefix(first);
+
+            if (xlang::starts_with(line, "WINRT_EXPORT namespace"))
+            {
+                exported = scopes.empty() || exported;
+            }
+
+            if (xlang::starts_with(line, "namespace") || xlang::starts_with(line, "WINRT_EXPORT namespace"))
+            {
+                namespace_next = true;
+
+                if (line == "namespace" || line.find("namespace {") != std::string_view::npos)
+                {
+                    if (at_namespace_scope())
+                    {
+                        result.emplace_back(line);
+                    }
+                }
+
+                return;
+            }
+
+            if (!at_namespace_scope())
+            {
+                return;
+            }
+
+            bool const after_template = template_next;
+            template_next = xlang::starts_with(line, "template") && line.back() == '>';
+
+            if (after_template || xlang::starts_with(line, "template") || xlang::starts_with(line, "inline ") || xlang::starts_with(line, "extern "))
+            {
+                return;
+            }
+
+            bool const is_static = xlang::starts_with(line, "static ");
+            bool const is_const = xlang::starts_with(line, "constexpr ") || xlang::starts_with(line, "const ");
+            bool const is_variable = line.back() == ';' && line.find('(') == std::string_view::npos;
+
+            if (is_static || (is_const && is_variable))
+            {
+                result.emplace_back(line);
+            }
+        };
+
+        for (size_t pos = 0; pos != source.size(); ++pos)
+        {
+            char const c = source[pos];
+
+            if (c == '\n')
+            {
+                check(std::string_view{ source }.substr(line_start, pos - line_start));
+                line_start = pos + 1;
+            }
+            else if (c == '/' && source.compare(pos, 2, "//") == 0)
+            {
+                auto const end = source.find('\n', pos);
+                check(std::string_view{ source }.substr(line_start, pos - line_start));
+                pos = end - 1;
+                line_start = end;
+            }
+            else if (c == '"' || c == '\'')
+            {
+                for (++pos; pos != source.size() && source[pos] != c; ++pos)
+                {
+                    if (source[pos] == '\\')
+                    {
+                        ++pos;
+                    }
+                }
+            }
+            else if (c == '{')
+            {
+                scopes.push_back(namespace_next);
+                namespace_next = false;
+            }
+            else if (c == '}' && !scopes.empty())
+            {
+                scopes.pop_back();
+
+                if (scopes.empty())
+                {
+                    exported = false;
+                }
+            }
+        }
+
+        return result;
+    }
+}
+
+TEST_CASE("modules_find_internal_linkage")
+{
+    auto found = find_internal_linkage(R"(
+WINRT_EXPORT namespace winrt::impl
+{
+    constexpr uint32_t internal_constant{ 1 };
+    inline constexpr uint32_t external_constant{ 2 };
+    static void internal_function() {}
+    constexpr int external_function() { return 0; }
+
+    template <typename T>
+    constexpr bool external_template{};
+
+    struct type
+    {
+        static constexpr uint32_t member{ 3 };
+        static void member_function() {}
+    };
+
+    namespace
+    {
+        struct hidden {};
+    }
+}
+
+namespace winrt::impl
+{
+    constexpr uint32_t not_exported{ 4 };
+}
+)");
+
+    std::vector<std::string> expected
+    {
+        "constexpr uint32_t internal_constant{ 1 };",
+        "static void internal_function() {}",
+        "namespace",
+    };
+
+    REQUIRE(found == expected);
+}
+
+TEST_CASE("modules_base_linkage")
+{
+    // Every declaration base.h puts in a WINRT_EXPORT namespace is exported by the winrt.base module.
+
+    for (auto&& file : directory_iterator(XLANG_STRINGS_PATH))
+    {
+        std::ifstream stream{ file.path(), std::ios::binary };
+        std::string const source{ std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>() };
+
+        INFO(file.path().filename().string());
+        REQUIRE(find_internal_linkage(source) == std::vector<std::string>{});
+    }
+}
@@ -0,0 +1,70 @@
+# Script variables:
+#   cppxlang        - path to the cppxlang executable
+#   compiler        - path to the C++ compiler used to build consumers
+#   flags           - compiler flags for consumer translation units
+#   input           - one or more cppxlang -input values (metadata files or folders)
+#   args            - additional cppxlang options
+#   bench           - path to benchCompile.cmake
+#   folder          - working folder for the generated projections
+
+if(${CMAKE_VERSION} VERSION_LESS "3.23")
+    message(STATUS "testBenchCompile: skipped (requires CMake 3.23)")
+    return()
+endif()
+
+# Runs the compile benchmark with the smallest sized projection and a size it must skip, and checks the
+# shape of its report.
+
+set(out "${folder}/bench_compile")
+set(report "${out}/report.json")
+file(REMOVE_RECURSE ${out})
+
+execute_process(
+    COMMAND ${CMAKE_COMMAND}
+        "-Dcppxlang=${cppxlang}"
+        "-Dcompiler=${compiler}"
+        "-Dflags=${flags}"
+        "-Dinput=${input}"
+        "-Dargs=${args}"
+        "-Dsizes=1;0"
+        "-Dfolder=${out}"
+        "-Dout_json=${report}"
+        -P ${bench}
+    RESULT_VARIABLE result
+    ERROR_VARIABLE error)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "benchCompile.cmake failed: ${error}")
+endif()
+
+file(READ ${report} json)
+string(JSON namespaces GET "${json}" namespaces)
+string(JSON consumers LENGTH "${json}" consumers)
+string(JSON sizes LENGTH "${json}" sizes)
+
+# base.h, coroutine.h, each namespace header and one consumer including them all.
+
+math(EXPR expected "${namespaces} + 3")
+if(NOT consumers EQUAL expected)
+    message(FATAL_ERROR "Expected ${expected} consumers for ${namespaces} namespaces, found ${consumers}")
+endif()
+
+string(JSON first GET "${json}" consumers 0 name)
+math(EXPR last_index "${consumers} - 1")
+string(JSON last GET "${json}" consumers ${last_index} name)
+string(JSON last_headers GET "${json}" consumers ${last_index} headers)
+if(NOT first STREQUAL "base" OR NOT last STREQUAL "all" OR NOT last_headers EQUAL namespaces)
+    message(FATAL_ERROR "Unexpected consumers in ${report}")
+endif()
+
+if(NOT sizes EQUAL 1)
+    message(FATAL_ERROR "Expected one sized projection, found ${sizes}")
+endif()
+
+string(JSON size_namespaces GET "${json}" sizes 0 namespaces)
+string(JSON size_bytes GET "${json}" sizes 0 generated_bytes)
+string(JSON size_headers GET "${json}" sizes 0 consumer headers)
+if(NOT size_namespaces EQUAL 1 OR NOT size_headers EQUAL 1 OR NOT size_bytes GREATER 0)
+    message(FATAL_ERROR "Unexpected sized projection in ${report}")
+endif()
+
+message(STATUS "testBenchCompile: passed")
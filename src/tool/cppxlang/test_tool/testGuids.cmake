@@ -0,0 +1,50 @@
+# Script variables:
+#   cppxlang - path to the cppxlang executable
+#   input    - one or more cppxlang -input values (metadata files or folders)
+#   args     - additional cppxlang options
+#   folder   - working folder for the generated projection
+
+set(out "${folder}/guids")
+file(REMOVE_RECURSE ${out})
+file(MAKE_DIRECTORY ${out})
+
+execute_process(
+    COMMAND ${cppxlang} -input ${input} -out ${out} -guids ${args}
+    RESULT_VARIABLE result
+    ERROR_VARIABLE error)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "cppxlang -guids failed: ${error}")
+endif()
+
+# The IID of a generic instance is written in the .0.h of the generic's namespace, which every translation
+# unit that can name the instance includes before it asks for the IID.
+
+file(GLOB_RECURSE headers RELATIVE ${out} "${out}/winrt/*.h")
+set(count 0)
+
+foreach(path ${headers})
+    file(STRINGS "${out}/${path}" lines REGEX "template <> inline constexpr std::optional<guid> generated_pinterface_guid<")
+
+    if(NOT lines)
+        continue()
+    endif()
+
+    if(NOT path MATCHES "^winrt/impl/(.+)\\.0\\.h$")
+        message(FATAL_ERROR "${path} writes generated IIDs outside of a .0.h")
+    endif()
+
+    string(REPLACE "." "::" prefix ${CMAKE_MATCH_1})
+
+    foreach(line ${lines})
+        if(NOT line MATCHES "generated_pinterface_guid<${prefix}::[A-Za-z0-9_]+<")
+            message(FATAL_ERROR "${path} writes the IID of a generic from another namespace: ${line}")
+        endif()
+        math(EXPR count "${count} + 1")
+    endforeach()
+endforeach()
+
+if(count EQUAL 0)
+    message(FATAL_ERROR "cppxlang -guids wrote no generated IIDs")
+endif()
+
+message(STATUS "testGuids: ${count} generated IIDs are next to their generic types")
@@ -0,0 +1,74 @@
+# Script variables:
+#   cppxlang - path to the cppxlang executable
+#   compiler - path to the C++ compiler used to build consumers
+#   flags    - compiler flags for consumer translation units
+#   input    - one or more cppxlang -input values (metadata files or folders)
+#   args     - additional cppxlang options
+#   folder   - working folder for the generated projection and consumers
+
+get_filename_component(compiler_name ${compiler} NAME_WE)
+if(compiler_name MATCHES "^(cl|clang-cl)$")
+    set(msvc_style TRUE)
+endif()
+
+separate_arguments(flags)
+
+set(out "${folder}/headers")
+file(REMOVE_RECURSE ${out})
+file(MAKE_DIRECTORY ${out})
+execute_process(
+    COMMAND ${cppxlang} -input ${input} -out ${out} ${args}
+    RESULT_VARIABLE result
+    ERROR_VARIABLE error)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "cppxlang failed: ${error}")
+endif()
+
+# Compiles a translation unit made of the given includes, so that a header that relies on another
+# header having been included before it fails here.
+function(CHECK_CONSUMER name)
+    set(source "${folder}/consumers/${name}.cpp")
+    set(content "")
+    foreach(header ${ARGN})
+        string(APPEND content "#include \"winrt/${header}\"\n")
+    endforeach()
+    file(WRITE ${source} "${content}")
+
+    if(msvc_style)
+        set(compile_args /nologo /Zs /I${out} ${flags} ${source})
+    else()
+        set(compile_args -fsyntax-only -I${out} ${flags} ${source})
+    endif()
+
+    execute_process(COMMAND ${compiler} ${compile_args} OUTPUT_VARIABLE output ERROR_VARIABLE error RESULT_VARIABLE result)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "${name} does not compile on its own:\n${output}${error}")
+    endif()
+endfunction()
+
+file(REMOVE_RECURSE "${folder}/consumers")
+file(MAKE_DIRECTORY "${folder}/consumers")
+
+# Every namespace header is compiled on its own, and every impl header with only base.h before it,
+# since each one includes the impl headers of the namespaces it depends on at the level it needs.
+
+file(GLOB namespace_headers RELATIVE "${out}/winrt" "${out}/winrt/*.h")
+list(REMOVE_ITEM namespace_headers "base.h" "coroutine.h")
+file(GLOB impl_headers RELATIVE "${out}/winrt" "${out}/winrt/impl/*.h")
+
+list(LENGTH namespace_headers namespace_count)
+if(namespace_count EQUAL 0)
+    message(FATAL_ERROR "No namespace headers were generated from ${input}")
+endif()
+
+foreach(header ${namespace_headers})
+    CHECK_CONSUMER(${header} ${header})
+endforeach()
+
+foreach(header ${impl_headers})
+    string(REPLACE "impl/" "impl." name ${header})
+    CHECK_CONSUMER(${name} base.h ${header})
+endforeach()
+
+list(LENGTH impl_headers impl_count)
+message(STATUS "testHeaders: ${namespace_count} namespace and ${impl_count} impl headers compile on their own")
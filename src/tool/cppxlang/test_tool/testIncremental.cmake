@@ -0,0 +1,61 @@
+# Script variables:
+#   cppxlang        - path to the cppxlang executable
+#   input           - one or more cppxlang -input values (metadata files or folders)
+#   args            - additional cppxlang options
+#   folder          - working folder for the generated projection
+
+function(RUN_CPPXLANG)
+    execute_process(
+        COMMAND ${cppxlang} -input ${input} -out ${out} ${args} ${ARGN}
+        RESULT_VARIABLE result
+        ERROR_VARIABLE error)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "cppxlang ${ARGN} failed: ${error}")
+    endif()
+endfunction()
+
+# A header that changed since it was generated shows whether a later run wrote it again.
+
+function(MARK_HEADER)
+    file(APPEND "${header}" "// marker\n")
+endfunction()
+
+function(REQUIRE_MARKED expected)
+    file(READ "${header}" content)
+    string(FIND "${content}" "// marker" found)
+    if(expected AND found EQUAL -1)
+        message(FATAL_ERROR "${header} was generated again although its metadata did not change")
+    elseif(NOT expected AND NOT found EQUAL -1)
+        message(FATAL_ERROR "${header} was not generated again")
+    endif()
+endfunction()
+
+set(out "${folder}/incremental")
+set(header "${out}/winrt/Windows.Foundation.h")
+file(REMOVE_RECURSE ${out})
+file(MAKE_DIRECTORY ${out})
+
+# An incremental run skips the namespaces whose fingerprint it recorded.
+
+RUN_CPPXLANG(-incremental)
+if(NOT EXISTS "${out}/cppxlang.namespaces")
+    message(FATAL_ERROR "-incremental did not write ${out}/cppxlang.namespaces")
+endif()
+MARK_HEADER()
+RUN_CPPXLANG(-incremental)
+REQUIRE_MARKED(TRUE)
+
+# A namespace with a missing header is generated again, as is every namespace without -incremental.
+
+file(REMOVE "${out}/winrt/impl/Windows.Foundation.2.h")
+RUN_CPPXLANG(-incremental)
+REQUIRE_MARKED(FALSE)
+if(NOT EXISTS "${out}/winrt/impl/Windows.Foundation.2.h")
+    message(FATAL_ERROR "Windows.Foundation.2.h was not generated again")
+endif()
+
+MARK_HEADER()
+RUN_CPPXLANG()
+REQUIRE_MARKED(FALSE)
+
+message(STATUS "testIncremental: passed")
@@ -0,0 +1,51 @@
+# Script variables:
+#   cppxlang        - path to the cppxlang executable
+#   input           - one or more cppxlang -input values (metadata files or folders)
+#   args            - additional cppxlang options
+#   component_class - a runtime class in the input that Windows.Foundation.Uri does not reach
+#                     (defaults to Windows.Data.Json.JsonArray)
+#   folder          - working folder for the generated projections
+
+if(NOT component_class)
+    set(component_class "Windows.Data.Json.JsonArray")
+endif()
+
+string(REGEX REPLACE "\\.[^.]*$" "" component_namespace ${component_class})
+string(REGEX REPLACE "^.*\\." "" component_name ${component_class})
+string(REPLACE "." "/" component_path ${component_namespace})
+
+function(RUN_CPPXLANG out_folder)
+    file(REMOVE_RECURSE ${out_folder})
+    file(MAKE_DIRECTORY ${out_folder})
+    execute_process(
+        COMMAND ${cppxlang} -input ${input} -out ${out_folder} ${args} ${ARGN}
+        RESULT_VARIABLE result
+        ERROR_VARIABLE error)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "cppxlang ${ARGN} failed: ${error}")
+    endif()
+endfunction()
+
+function(REQUIRE_FILE path)
+    if(NOT EXISTS ${path})
+        message(FATAL_ERROR "${path} was not generated")
+    endif()
+endfunction()
+
+# Generic names scanned from source resolve to the generic type rather than to its whole namespace.
+
+set(out "${folder}/lean_scan")
+file(WRITE "${folder}/lean_scan.cpp" "winrt::Windows::Foundation::Collections::IVector<winrt::Windows::Foundation::Uri> vector;\n")
+RUN_CPPXLANG(${out} -lean "${folder}/lean_scan.cpp")
+REQUIRE_FILE("${out}/winrt/Windows.Foundation.Collections.h")
+REQUIRE_FILE("${out}/winrt/Windows.Foundation.h")
+
+# Component classes are projected and get their templates even where the seeds don't reach them.
+
+set(out "${folder}/lean_component")
+RUN_CPPXLANG(${out} -include ${component_namespace} -component ${out} -lean Windows.Foundation.Uri)
+REQUIRE_FILE("${out}/winrt/${component_namespace}.h")
+REQUIRE_FILE("${out}/${component_path}/${component_name}.g.h")
+REQUIRE_FILE("${out}/${component_class}.h")
+
+message(STATUS "testLean: passed")
@@ -0,0 +1,106 @@
+# Script variables:
+#   cppxlang        - path to the cppxlang executable
+#   input           - one or more cppxlang -input values (metadata files or folders)
+#   args            - additional cppxlang options
+#   folder          - working folder for the generated projections
+
+if(CMAKE_HOST_WIN32)
+    message(STATUS "testServer: skipped (the generation server requires a Unix domain socket)")
+    return()
+endif()
+
+set(out "${folder}/server")
+set(socket "${out}/cppxlang.sock")
+file(REMOVE_RECURSE ${out})
+file(MAKE_DIRECTORY "${out}/served" "${out}/direct" "${out}/client")
+
+execute_process(
+    COMMAND sh -c "\"$0\" -server \"$1\" >/dev/null 2>&1 & echo $!" ${cppxlang} ${socket}
+    OUTPUT_VARIABLE pid
+    OUTPUT_STRIP_TRAILING_WHITESPACE)
+
+function(STOP_SERVER)
+    execute_process(COMMAND kill ${pid})
+endfunction()
+
+function(FAIL message)
+    STOP_SERVER()
+    message(FATAL_ERROR "${message}")
+endfunction()
+
+foreach(attempt RANGE 100)
+    if(EXISTS ${socket})
+        break()
+    endif()
+    execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 0.1)
+endforeach()
+
+if(NOT EXISTS ${socket})
+    FAIL("The generation server did not create ${socket}")
+endif()
+
+# Relative paths in a request are resolved in the client's working folder, and a served request writes
+# the same projection as running cppxlang directly.
+
+execute_process(
+    COMMAND ${cppxlang} -connect ${socket} -input ${input} -out ../served ${args}
+    WORKING_DIRECTORY "${out}/client"
+    RESULT_VARIABLE result
+    ERROR_VARIABLE error)
+if(NOT result EQUAL 0)
+    FAIL("The served request failed: ${error}")
+endif()
+
+execute_process(
+    COMMAND ${cppxlang} -input ${input} -out "${out}/direct" ${args}
+    RESULT_VARIABLE result
+    ERROR_VARIABLE error)
+if(NOT result EQUAL 0)
+    FAIL("cppxlang failed: ${error}")
+endif()
+
+file(GLOB_RECURSE served_files RELATIVE "${out}/served" "${out}/served/*")
+file(GLOB_RECURSE direct_files RELATIVE "${out}/direct" "${out}/direct/*")
+list(SORT served_files)
+list(SORT direct_files)
+
+if(NOT served_files OR NOT served_files STREQUAL direct_files)
+    FAIL("The served request wrote different files")
+endif()
+
+foreach(path ${served_files})
+    file(SHA256 "${out}/served/${path}" served_hash)
+    file(SHA256 "${out}/direct/${path}" direct_hash)
+    if(NOT served_hash STREQUAL direct_hash)
+        FAIL("The served request wrote different content to ${path}")
+    endif()
+endforeach()
+
+# A failing request reports its error to the client and leaves the server running for the next one.
+
+execute_process(
+    COMMAND ${cppxlang} -connect ${socket} -input "${out}/missing.winmd" -out "${out}/served"
+    RESULT_VARIABLE result
+    OUTPUT_VARIABLE output)
+if(result EQUAL 0 OR NOT output MATCHES "missing.winmd")
+    FAIL("The failing request was not reported")
+endif()
+
+file(REMOVE_RECURSE "${out}/served")
+file(MAKE_DIRECTORY "${out}/served")
+execute_process(
+    COMMAND ${cppxlang} -connect ${socket} -input ${input} -out "${out}/served" ${args}
+    RESULT_VARIABLE result
+    ERROR_VARIABLE error)
+if(NOT result EQUAL 0)
+    FAIL("The request after a failed one failed: ${error}")
+endif()
+
+file(GLOB_RECURSE warm_files RELATIVE "${out}/served" "${out}/served/*")
+list(SORT warm_files)
+if(NOT warm_files STREQUAL direct_files)
+    FAIL("The request after a failed one wrote different files")
+endif()
+
+STOP_SERVER()
+message(STATUS "testServer: passed")
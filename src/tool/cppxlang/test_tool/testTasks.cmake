@@ -0,0 +1,65 @@
+# Script variables:
+#   cppxlang            - path to the cppxlang executable
+#   input               - one or more cppxlang -input values (metadata files or folders)
+#   args                - additional cppxlang options
+#   component_namespace - a namespace in the input with runtime classes (defaults to Windows.Foundation)
+#   folder              - working folder for the generated projections
+
+if(NOT component_namespace)
+    set(component_namespace "Windows.Foundation")
+endif()
+
+function(RUN_CPPXLANG out_folder)
+    file(REMOVE_RECURSE ${out_folder})
+    file(MAKE_DIRECTORY "${out_folder}/component")
+    execute_process(
+        COMMAND ${cppxlang} -input ${input} -out ${out_folder} -include ${component_namespace} -component "${out_folder}/component" ${args}
+        RESULT_VARIABLE result
+        ERROR_VARIABLE error)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "cppxlang failed: ${error}")
+    endif()
+endfunction()
+
+# Namespace headers and component classes are written by separate tasks that may finish in any order, so
+# two runs must still write the same files with the same content.
+
+set(first "${folder}/tasks_first")
+set(second "${folder}/tasks_second")
+RUN_CPPXLANG(${first})
+RUN_CPPXLANG(${second})
+
+file(GLOB_RECURSE first_files RELATIVE ${first} "${first}/*")
+file(GLOB_RECURSE second_files RELATIVE ${second} "${second}/*")
+list(SORT first_files)
+list(SORT second_files)
+
+if(NOT first_files STREQUAL second_files)
+    message(FATAL_ERROR "Two runs wrote different files")
+endif()
+
+foreach(path ${first_files})
+    file(SHA256 "${first}/${path}" first_hash)
+    file(SHA256 "${second}/${path}" second_hash)
+    if(NOT first_hash STREQUAL second_hash)
+        message(FATAL_ERROR "Two runs wrote different content to ${path}")
+    endif()
+endforeach()
+
+# module.g.cpp is written alongside the classes, and each class it activates has its own .g.h.
+
+file(STRINGS "${first}/module.g.cpp" activated REGEX "requal\\(name, L\"")
+
+if(NOT activated)
+    message(FATAL_ERROR "module.g.cpp activates no classes from ${component_namespace}")
+endif()
+
+foreach(line ${activated})
+    string(REGEX REPLACE ".*L\"${component_namespace}\\.([^\"]*)\".*" "\\1" class "${line}")
+    string(REPLACE "." "/" class ${class})
+    if(NOT EXISTS "${first}/${class}.g.h")
+        message(FATAL_ERROR "${class}.g.h was not generated")
+    endif()
+endforeach()
+
+message(STATUS "testTasks: passed")
@@ -24,7 +24,7 @@ namespace xlang
         }
     };
 
-    bool operator==(type_name const& left, std::string_view const& right)
+    inline bool operator==(type_name const& left, std::string_view const& right)
     {
         if (left.name.size() + 1 + left.name_space.size() != right.size())
         {
@@ -152,12 +152,12 @@ namespace xlang
 
         void write_value(int32_t value)
         {
-            write_printf("%d", value);
+            write_decimal(value);
         }
 
         void write_value(uint32_t value)
         {
-            write_printf("%#0x", value);
+            write_hex_literal(value);
         }
 
         void write_code(std::string_view const& value)
@@ -501,6 +501,18 @@ namespace xlang
             }
         }
 
+        void flush_to_file(std::string const& filename)
+        {
+            if (settings.output)
+            {
+                writer_base::flush_to_file(filename, *settings.output);
+            }
+            else
+            {
+                writer_base::flush_to_file(filename);
+            }
+        }
+
         void save_header(char impl = 0)
         {
             auto filename{ settings.output_folder + "winrt/" };
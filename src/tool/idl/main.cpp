@@ -54,47 +54,47 @@ struct writer : writer_base<writer>
 
     void write_value(char16_t value)
     {
-        write_printf("%#0hx", value);
+        write_hex_literal(value);
     }
 
     void write_value(int8_t value)
     {
-        write_printf("%hhd", value);
+        write_decimal(value);
     }
 
     void write_value(uint8_t value)
     {
-        write_printf("%#0hhx", value);
+        write_hex_literal(value);
     }
 
     void write_value(int16_t value)
     {
-        write_printf("%hd", value);
+        write_decimal(value);
     }
 
     void write_value(uint16_t value)
     {
-        write_printf("%#0hx", value);
+        write_hex_literal(value);
     }
 
     void write_value(int32_t value)
     {
-        write_printf("%d", value);
+        write_decimal(value);
     }
 
     void write_value(uint32_t value)
     {
-        write_printf("%#0x", value);
+        write_hex_literal(value);
     }
 
     void write_value(int64_t value)
     {
-        write_printf("%lld", value);
+        write_decimal(value);
     }
 
     void write_value(uint64_t value)
     {
-        write_printf("%#0llx", value);
+        write_hex_literal(value);
     }
 
     void write_value(float value)
@@ -405,19 +405,22 @@ struct writer : writer_base<writer>
     {
         auto const& args = arg.FixedArgs();
 
-        write_printf("\n    [Windows.Foundation.Metadata.GuidAttribute(%08X-%04X-%04X-%02X%02X-%02X%02X%02X%02X%02X%02X)]"
-            , std::get<uint32_t>(std::get<ElemSig>(args[0].value).value)
+        write("\n    [Windows.Foundation.Metadata.GuidAttribute(");
+        write_guid(std::get<uint32_t>(std::get<ElemSig>(args[0].value).value)
             , std::get<uint16_t>(std::get<ElemSig>(args[1].value).value)
             , std::get<uint16_t>(std::get<ElemSig>(args[2].value).value)
-            , std::get<uint8_t>(std::get<ElemSig>(args[3].value).value)
-            , std::get<uint8_t>(std::get<ElemSig>(args[4].value).value)
-            , std::get<uint8_t>(std::get<ElemSig>(args[5].value).value)
-            , std::get<uint8_t>(std::get<ElemSig>(args[6].value).value)
-            , std::get<uint8_t>(std::get<ElemSig>(args[7].value).value)
-            , std::get<uint8_t>(std::get<ElemSig>(args[8].value).value)
-            , std::get<uint8_t>(std::get<ElemSig>(args[9].value).value)
-            , std::get<uint8_t>(std::get<ElemSig>(args[10].value).value)
-        );
+            , {
+                std::get<uint8_t>(std::get<ElemSig>(args[3].value).value)
+                , std::get<uint8_t>(std::get<ElemSig>(args[4].value).value)
+                , std::get<uint8_t>(std::get<ElemSig>(args[5].value).value)
+                , std::get<uint8_t>(std::get<ElemSig>(args[6].value).value)
+                , std::get<uint8_t>(std::get<ElemSig>(args[7].value).value)
+                , std::get<uint8_t>(std::get<ElemSig>(args[8].value).value)
+                , std::get<uint8_t>(std::get<ElemSig>(args[9].value).value)
+                , std::get<uint8_t>(std::get<ElemSig>(args[10].value).value)
+            }
+            , true);
+        write(")]");
     }
 
     void write(CustomAttribute const& attr)
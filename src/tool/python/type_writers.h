@@ -115,82 +115,6 @@ namespace xlang
 
 #pragma endregion
 
-        int32_t indent{ 0 };
-
-        struct indent_guard
-        {
-            explicit indent_guard(writer& w) noexcept : _writer(w)
-            {
-                _writer.indent++;
-            }
-
-            ~indent_guard()
-            {
-                _writer.indent--;
-            }
-
-        private:
-            writer & _writer;
-        };
-
-        void write_indent()
-        {
-            for (int32_t i = 0; i < indent; i++)
-            {
-                writer_base::write_impl("    ");
-            }
-        }
-
-        void write_impl(std::string_view const& value)
-        {
-            if (back() == '\n')
-            {
-                write_indent();
-            }
-
-            std::string_view::size_type current_pos{ 0 };
-            auto pos = value.find('\n', current_pos);
-
-            while(pos != std::string_view::npos)
-            {
-                writer_base::write_impl(value.substr(current_pos, pos + 1 - current_pos));
-                if (pos != value.size() - 1)
-                {
-                    write_indent();
-                }
-                current_pos = pos + 1;
-                pos = value.find('\n', current_pos);
-            }
-
-            if (pos == std::string_view::npos)
-            {
-                writer_base::write_impl(value.substr(current_pos));
-            }
-        }
-
-        void write_impl(char const value)
-        {
-            if (back() == '\n')
-            {
-                write_indent();
-            }
-
-            writer_base::write_impl(value);
-        }
-
-        template <typename... Args>
-        std::string write_temp(std::string_view const& value, Args const&... args)
-        {
-            auto restore_indent = indent;
-            indent = 0;
-
-            auto result = writer_base::write_temp(value, args...);
-
-            indent = restore_indent;
-
-            return result;
-        }
-
         void write_value(bool value)
         {
             write(value ? "TRUE"sv : "FALSE"sv);
@@ -198,47 +122,47 @@ namespace xlang
 
         void write_value(char16_t value)
         {
-            write_printf("%#0hx", value);
+            write_hex_literal(value);
         }
 
         void write_value(int8_t value)
         {
-            write_printf("%hhd", value);
+            write_decimal(value);
         }
 
         void write_value(uint8_t value)
         {
-            write_printf("%#0hhx", value);
+            write_hex_literal(value);
         }
 
         void write_value(int16_t value)
         {
-            write_printf("%hd", value);
+            write_decimal(value);
         }
 
         void write_value(uint16_t value)
         {
-            write_printf("%#0hx", value);
+            write_hex_literal(value);
         }
 
         void write_value(int32_t value)
         {
-            write_printf("%d", value);
+            write_decimal(value);
         }
 
         void write_value(uint32_t value)
         {
-            write_printf("%#0x", value);
+            write_hex_literal(value);
         }
 
         void write_value(int64_t value)
         {
-            write_printf("%lld", value);
+            write_decimal(value);
         }
 
         void write_value(uint64_t value)
         {
-            write_printf("%#0llx", value);
+            write_hex_literal(value);
         }
 
         void write_value(float value)